@@ -0,0 +1,282 @@
+#include "solver/cfr_engine.hpp"
+#include "solver/toy_games.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Convergence benchmark: exact exploitability of CFREngine against
+ * iterations and wall-clock time on games with known equilibria.
+ *
+ * Every (game, sampling scheme, thread count) run trains from scratch and
+ * stops at log-spaced checkpoints, where the solve clock is paused and the
+ * average strategy is measured with ExactBestResponse. With several
+ * threads each one trains its own engine from its own seed and the
+ * strategy sums are pooled, so a thread count is compared per second of
+ * wall-clock time, not per iteration.
+ */
+
+using namespace solver;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<std::string> games = {"kuhn", "leduc", "river", "rps"};
+    std::vector<std::string> variants = {"external", "outcome", "chance", "vanilla"};
+    std::vector<int> threads = {1};
+    long long iterations = 1000000;  // Per run, summed over threads
+    int checkpoints = 12;
+    double seconds = 0;              // Per run; 0 for no time limit
+    uint32_t seed = 1;
+    std::string csvPath;
+};
+
+const std::pair<const char*, SamplingScheme> VARIANTS[] = {
+    {"external", SamplingScheme::EXTERNAL},
+    {"outcome", SamplingScheme::OUTCOME},
+    {"chance", SamplingScheme::CHANCE},
+    {"vanilla", SamplingScheme::VANILLA},
+};
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> out;
+    std::stringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: convergence_bench [options]\n"
+                 "  --games kuhn,leduc,river,rps\n"
+                 "  --variants external,outcome,chance,vanilla\n"
+                 "  --threads 1,2,4      thread counts to run each variant with\n"
+                 "  --iterations N       iterations per run (default 1000000)\n"
+                 "  --checkpoints N      log-spaced measurements per run (default 12)\n"
+                 "  --seconds S          stop a run after S seconds of solving\n"
+                 "  --seed N\n"
+                 "  --csv FILE           write every measurement as CSV\n");
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        if (arg == "--games") {
+            options.games = split(value);
+        } else if (arg == "--variants") {
+            options.variants = split(value);
+        } else if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto& t : split(value)) options.threads.push_back(std::max(1, std::atoi(t.c_str())));
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1LL, std::atoll(value.c_str()));
+        } else if (arg == "--checkpoints") {
+            options.checkpoints = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--seconds") {
+            options.seconds = std::atof(value.c_str());
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--csv") {
+            options.csvPath = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Iteration counts to measure at, log-spaced up to the total
+std::vector<long long> checkpointsFor(long long total, int count) {
+    std::vector<long long> out;
+    double first = std::min<double>(100.0, static_cast<double>(total));
+    for (int i = 1; i <= count; ++i) {
+        double t = count == 1 ? 1.0 : static_cast<double>(i - 1) / (count - 1);
+        long long at = std::llround(first * std::pow(total / first, t));
+        if (out.empty() || at > out.back()) out.push_back(at);
+    }
+    return out;
+}
+
+struct Measurement {
+    long long iterations;
+    double seconds;
+    double exploitability;
+    double value;
+};
+
+template <EnumerableGame G>
+class Run {
+public:
+    Run(const G& game, SamplingScheme sampling, int numThreads, uint32_t seed) : game_(game) {
+        for (int t = 0; t < numThreads; ++t) {
+            engines_.push_back(std::make_unique<CFREngine<G>>(game, sampling, seed + 7919 * t));
+        }
+    }
+
+    // Trains until `total` iterations over all engines; returns the wall-clock time it took
+    double trainTo(long long total) {
+        auto start = Clock::now();
+        long long numEngines = static_cast<long long>(engines_.size());
+        std::vector<std::thread> threads;
+        for (long long t = 0; t < numEngines; ++t) {
+            // Engine t runs its share of the total, the first ones taking the remainder
+            long long target = total / numEngines + (t < total % numEngines ? 1 : 0);
+            CFREngine<G>* engine = engines_[t].get();
+            auto work = [engine, target]() {
+                while (engine->iterations() < target) engine->iterate();
+            };
+            if (t + 1 < numEngines) {
+                threads.emplace_back(work);
+            } else {
+                work();
+            }
+        }
+        for (auto& thread : threads) thread.join();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Exploitability and player 0's value of the pooled average strategy
+    std::pair<double, double> measure() const {
+        auto strategy = [this](size_t infoSet, int numActions, double* out) {
+            double total = 0;
+            for (int a = 0; a < numActions; ++a) {
+                out[a] = 0;
+                for (const auto& engine : engines_) out[a] += engine->strategySum(infoSet)[a];
+                total += out[a];
+            }
+            for (int a = 0; a < numActions; ++a) {
+                out[a] = total > 0 ? out[a] / total : 1.0 / numActions;
+            }
+        };
+        double br0 = ExactBestResponse<G>(game_, strategy, 0).value();
+        double br1 = ExactBestResponse<G>(game_, strategy, 1).value();
+        // The two responses bracket the value: br0 >= v >= -br1
+        return {(br0 + br1) / 2, value(game_.initial(), strategy)};
+    }
+
+private:
+    const G& game_;
+    std::vector<std::unique_ptr<CFREngine<G>>> engines_;
+
+    template <typename Strategy>
+    double value(const typename G::State& state, const Strategy& strategy) const {
+        if (game_.isTerminal(state)) return game_.utility(state);
+        if (game_.isChance(state)) {
+            double v = 0;
+            for (int o = 0; o < game_.numChanceOutcomes(state); ++o) {
+                v += game_.chanceProbability(state, o) * value(game_.applyChance(state, o), strategy);
+            }
+            return v;
+        }
+        int numActions = game_.numActions(state);
+        std::array<double, G::MAX_ACTIONS> probabilities;
+        strategy(game_.infoSet(state), numActions, probabilities.data());
+        double v = 0;
+        for (int a = 0; a < numActions; ++a) {
+            if (probabilities[a] > 0) v += probabilities[a] * value(game_.apply(state, a), strategy);
+        }
+        return v;
+    }
+};
+
+template <EnumerableGame G>
+void benchmark(const G& game, const std::string& name, double knownValue, const Options& options, FILE* csv) {
+    for (const auto& variant : options.variants) {
+        const SamplingScheme* sampling = nullptr;
+        for (const auto& [label, scheme] : VARIANTS) {
+            if (variant == label) sampling = &scheme;
+        }
+        if (!sampling) {
+            std::fprintf(stderr, "unknown variant '%s'\n", variant.c_str());
+            continue;
+        }
+
+        for (int numThreads : options.threads) {
+            Run<G> run(game, *sampling, numThreads, options.seed);
+            std::printf("\n%s / %s / %d thread%s\n", name.c_str(), variant.c_str(), numThreads,
+                        numThreads == 1 ? "" : "s");
+            std::printf("%12s %10s %14s %12s\n", "iterations", "seconds", "exploitability", "value");
+
+            double elapsed = 0;
+            Measurement last{};
+            for (long long at : checkpointsFor(options.iterations, options.checkpoints)) {
+                elapsed += run.trainTo(at);
+                auto [exploitability, value] = run.measure();
+                last = {at, elapsed, exploitability, value};
+                std::printf("%12lld %10.3f %14.6f %12.6f\n", at, elapsed, exploitability, value);
+                if (csv) {
+                    std::fprintf(csv, "%s,%s,%d,%lld,%.6f,%.9g,%.9g,", name.c_str(), variant.c_str(),
+                                 numThreads, at, elapsed, exploitability, value);
+                    if (std::isnan(knownValue)) {
+                        std::fprintf(csv, ",\n");
+                    } else {
+                        std::fprintf(csv, "%.9g,%.9g\n", knownValue, value - knownValue);
+                    }
+                    std::fflush(csv);
+                }
+                if (options.seconds > 0 && elapsed >= options.seconds) break;
+            }
+
+            if (!std::isnan(knownValue)) {
+                std::printf("value %.6f vs known %.6f (error %+.6f) after %lld iterations\n",
+                            last.value, knownValue, last.value - knownValue, last.iterations);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    FILE* csv = nullptr;
+    if (!options.csvPath.empty()) {
+        csv = std::fopen(options.csvPath.c_str(), "w");
+        if (!csv) {
+            std::fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+            return 1;
+        }
+        std::fprintf(csv, "game,variant,threads,iterations,seconds,exploitability,value,known_value,value_error\n");
+    }
+
+    // The games are built once; runs only read them
+    KuhnGame kuhn;
+    LeducGame leduc;
+    ToyRiverGame river;
+    RpsGame rps;
+    for (const auto& name : options.games) {
+        if (name == "kuhn") {
+            benchmark(kuhn, name, KuhnGame::GAME_VALUE, options, csv);
+        } else if (name == "leduc") {
+            benchmark(leduc, name, LeducGame::GAME_VALUE, options, csv);
+        } else if (name == "river") {
+            benchmark(river, name, std::nan(""), options, csv);
+        } else if (name == "rps") {
+            benchmark(rps, name, 0.0, options, csv);
+        } else {
+            std::fprintf(stderr, "unknown game '%s'\n", name.c_str());
+        }
+    }
+
+    if (csv) std::fclose(csv);
+    return 0;
+}
@@ -68,6 +68,20 @@ std::string Hand::toString() const {
     return cards_[0].toString() + cards_[1].toString();
 }
 
+int Hand::comboIndex() const {
+    int hi = std::max(cards_[0].value(), cards_[1].value());
+    int lo = std::min(cards_[0].value(), cards_[1].value());
+    return hi * (hi - 1) / 2 + lo;
+}
+
+Hand Hand::fromComboIndex(int index) {
+    // Invert hi * (hi - 1) / 2 + lo
+    int hi = 1;
+    while ((hi + 1) * hi / 2 <= index) ++hi;
+    int lo = index - hi * (hi - 1) / 2;
+    return Hand(hi, lo);
+}
+
 bool Hand::isValid() const {
     return cards_[0].isValid() && cards_[1].isValid() &&
            cards_[0].value() != cards_[1].value();
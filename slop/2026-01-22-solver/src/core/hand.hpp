@@ -8,6 +8,9 @@
 
 namespace core {
 
+// Number of distinct two-card combinations (52 choose 2)
+constexpr int NUM_COMBOS = 1326;
+
 /**
  * Represents a poker hand (2 hole cards for Texas Hold'em).
  * Hands are normalized so that the higher card is always first.
@@ -38,6 +41,10 @@ public:
     // Full string representation (e.g., "AsKh")
     std::string toString() const;
     
+    // Dense combo index in [0, NUM_COMBOS), independent of card order
+    int comboIndex() const;
+    static Hand fromComboIndex(int index);
+    
     // Validation
     bool isValid() const;
     
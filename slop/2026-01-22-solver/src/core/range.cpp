@@ -2,6 +2,7 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <regex>
 
 namespace core {
@@ -233,6 +234,59 @@ std::string Range::toString() const {
     return result;
 }
 
+std::string Range::toCompactString() const {
+    std::vector<std::string> tokens;
+    
+    // Each sequence runs from its strongest hand down: the pairs, then the
+    // suited and offsuit hands of each high card
+    auto addRuns = [&](const std::vector<HandType>& sequence) {
+        size_t begin = 0;
+        while (begin < sequence.size()) {
+            int weight = static_cast<int>(std::lround(getWeight(sequence[begin])));
+            size_t end = begin + 1;
+            while (end < sequence.size() &&
+                   static_cast<int>(std::lround(getWeight(sequence[end]))) == weight) {
+                ++end;
+            }
+            if (weight > 0) {
+                std::string token;
+                if (end - begin == 1) {
+                    token = sequence[begin].toString();
+                } else if (begin == 0) {
+                    token = sequence[end - 1].toString() + "+";
+                } else {
+                    token = sequence[begin].toString() + "-" + sequence[end - 1].toString();
+                }
+                if (weight < 100) token += "@" + std::to_string(weight);
+                tokens.push_back(token);
+            }
+            begin = end;
+        }
+    };
+    
+    std::vector<HandType> pairs;
+    for (int r = NUM_RANKS - 1; r >= 0; --r) {
+        pairs.emplace_back(static_cast<Rank>(r), static_cast<Rank>(r), false);
+    }
+    addRuns(pairs);
+    for (bool suited : {true, false}) {
+        for (int high = NUM_RANKS - 1; high >= 1; --high) {
+            std::vector<HandType> sequence;
+            for (int low = high - 1; low >= 0; --low) {
+                sequence.emplace_back(static_cast<Rank>(high), static_cast<Rank>(low), suited);
+            }
+            addRuns(sequence);
+        }
+    }
+    
+    std::string result;
+    for (const auto& token : tokens) {
+        if (!result.empty()) result += ", ";
+        result += token;
+    }
+    return result;
+}
+
 std::array<std::array<double, 13>, 13> Range::getGridWeights() const {
     std::array<std::array<double, 13>, 13> grid = {};
     
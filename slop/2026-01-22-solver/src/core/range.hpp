@@ -66,6 +66,10 @@ public:
     // String representation
     std::string toString() const;
     
+    // Shortest notation fromString() reads back: runs of equal weight
+    // (rounded to a percent) as "77+", "99-55", "ATs+" or "K9o-K6o"
+    std::string toCompactString() const;
+    
     // Get grid representation (13x13 matrix of weights)
     // Index by [row][col] where AA is [0][0]
     std::array<std::array<double, 13>, 13> getGridWeights() const;
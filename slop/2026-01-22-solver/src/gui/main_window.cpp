@@ -13,7 +13,7 @@
 #include <QMessageBox>
 #include <QThread>
 #include <QApplication>
-#include <map>
+#include <QDir>
 
 namespace gui {
 
@@ -80,20 +80,17 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     // Initialize solver
     solver_ = std::make_unique<solver::MCCFRSolver>();
     
-    // Solver update timer
+    // Snapshot timer: the solve itself runs on the BackgroundSolver's thread
     solverTimer_ = new QTimer(this);
-    connect(solverTimer_, &QTimer::timeout, this, &MainWindow::runSolver);
-    
-    // Register metatype for signal/slot
-    qRegisterMetaType<solver::SolveProgress>("solver::SolveProgress");
+    connect(solverTimer_, &QTimer::timeout, this, &MainWindow::pollSolver);
     
     updateDisplay();
 }
 
 MainWindow::~MainWindow() {
-    if (solving_) {
-        solver_->stop();
-    }
+    // Stop and join the solve and export threads before anything they read goes away
+    background_.reset();
+    cancelExport();
 }
 
 void MainWindow::setupUI() {
@@ -315,9 +312,6 @@ void MainWindow::setupConnections() {
     // Stack size
     connect(stackSizeSpinner_, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &MainWindow::onStackSizeChanged);
-    
-    // Progress signal
-    connect(this, &MainWindow::solveProgressUpdated, this, &MainWindow::onSolveProgress);
 }
 
 void MainWindow::createMenus() {
@@ -417,7 +411,7 @@ void MainWindow::onActionSelected(int actionIndex) {
     }
     
     auto actions = gameState_.getAvailableActions();
-    if (actionIndex >= 0 && actionIndex < static_cast<int>(actions.size())) {
+    if (actionIndex >= 0 && actionIndex < actions.size()) {
         solver::Action selectedAction = actions[actionIndex];
         solver::Position actingPlayer = gameState_.currentPlayer();
         
@@ -445,6 +439,10 @@ void MainWindow::onActionSelected(int actionIndex) {
         if (gameState_.isTerminal()) {
             progressPanel_->log("Hand complete. No further solving needed.");
             enableUIForSolving(false);
+        } else if (gameState_.awaitingCard()) {
+            progressPanel_->log(QString("%1 complete. Select the next card.")
+                .arg(solver::streetToString(gameState_.currentStreet())));
+            enableUIForSolving(false);
         } else {
             // Switch view to current player (the one who needs to act next)
             int playerIndex = (gameState_.currentPlayer() == solver::Position::OOP) ? 0 : 1;
@@ -462,25 +460,13 @@ void MainWindow::onActionSelected(int actionIndex) {
             
             // Initialize and start solver
             solver::MCCFRConfig config;
-            config.numIterations = 3000;  // Fewer iterations for progressive solving
-            config.progressCallbackFrequency = 50;
-            
-            solver_ = std::make_unique<solver::MCCFRSolver>(config);
-            solver_->initialize(gameState_, oopRange_, ipRange_);
-            
-            solver_->setProgressCallback([this](const solver::SolveProgress& progress) {
-                emit solveProgressUpdated(progress.currentIteration, 
-                                          progress.totalIterations, 
-                                          progress.exploitability);
-            });
-            
-            solving_ = true;
-            solveBtn_->setEnabled(false);
-            stopBtn_->setEnabled(true);
-            progressPanel_->setStatus("Solving...");
+            config.numIterations = 1000000;
+            config.minIterations = 3000;
+            config.maxSeconds = 10;  // Shorter budget for progressive solving
+            config.targetExploitability = 1.0;
             
-            solverTimer_->start(10);
-            runSolver();
+            createSolver(config, true);
+            startSolving();
         }
     } else {
         updateDisplay();
@@ -502,9 +488,11 @@ void MainWindow::onSolveClicked() {
         return;
     }
     
-    solving_ = true;
-    solveBtn_->setEnabled(false);
-    stopBtn_->setEnabled(true);
+    if (!gameState_.config().fits()) {
+        QMessageBox::warning(this, "Error",
+            QString("At most %1 bet sizes per player and street are supported.").arg(solver::MAX_BET_SIZES));
+        return;
+    }
     
     // Block UI while solving
     enableUIForSolving(true);
@@ -512,98 +500,132 @@ void MainWindow::onSolveClicked() {
     progressPanel_->log(QString("Starting solver with %1 OOP combos, %2 IP combos...")
         .arg(oopRange_.totalCombos(), 0, 'f', 1)
         .arg(ipRange_.totalCombos(), 0, 'f', 1));
-    progressPanel_->setStatus("Solving...");
     
-    // Initialize solver
+    // Initialize solver: stop at a good-enough strategy (1% of the pot) or at the time budget,
+    // whichever comes first; numIterations is only a cap
     solver::MCCFRConfig config;
-    config.numIterations = 5000;
-    config.progressCallbackFrequency = 50;
+    config.numIterations = 1000000;
+    config.minIterations = 5000;
+    config.maxSeconds = 30;
+    config.targetExploitability = 1.0;
     
-    solver_ = std::make_unique<solver::MCCFRSolver>(config);
-    solver_->initialize(gameState_, oopRange_, ipRange_);
+    // Later streets re-solve the previous solution's subgame unless the
+    // ranges were edited
+    bool sameRanges = solver_ && oopRange_.toString() == solver_->oopRange().toString() &&
+                      ipRange_.toString() == solver_->ipRange().toString();
+    createSolver(config, sameRanges);
     
     progressPanel_->log("Solver initialized. Starting iterations...");
+    startSolving();
+}
+
+void MainWindow::startSolving() {
+    solving_ = true;
+    solveBtn_->setEnabled(false);
+    stopBtn_->setEnabled(true);
+    progressPanel_->setStatus("Solving...");
     
-    // Set up progress callback
-    solver_->setProgressCallback([this](const solver::SolveProgress& progress) {
-        emit solveProgressUpdated(progress.currentIteration, 
-                                  progress.totalIterations, 
-                                  progress.exploitability);
-    });
-    
-    // Run solver in iterations using timer (10ms = 100Hz update rate)
-    solverTimer_->start(10);
-    runSolver();
+    // The solver iterates on its own thread; the timer only renders the
+    // latest snapshot it published, so repaints never pause the solve
+    background_ = std::make_unique<solver::BackgroundSolver>(*solver_);
+    background_->start();
+    solverTimer_->start(33);
 }
 
-void MainWindow::runSolver() {
-    if (!solving_ || !solver_ || solver_->isStopped()) {
+void MainWindow::pollSolver() {
+    if (!background_) {
         solverTimer_->stop();
-        solving_ = false;
-        solveBtn_->setEnabled(true);
-        stopBtn_->setEnabled(false);
-        progressPanel_->setStatus("Complete");
-        progressPanel_->log("Solving complete.");
-        updateStrategyDisplay();
-        
-        // Re-enable UI
-        enableUIForSolving(false);
         return;
     }
     
-    // Run a batch of iterations
-    int batchSize = 10;
-    for (int i = 0; i < batchSize && !solver_->isStopped(); ++i) {
-        solver_->runIteration();
+    // Read before polling: the final snapshot is published before finished() is set
+    bool finished = background_->finished();
+    if (background_->poll()) {
+        const auto& snapshot = background_->latest();
+        double budget = solver_->config().maxSeconds;
+        if (budget > 0) {
+            progressPanel_->setTimeProgress(snapshot.iteration, snapshot.seconds, budget);
+        } else {
+            progressPanel_->setProgress(snapshot.iteration, snapshot.totalIterations);
+        }
+        if (snapshot.measured) {
+            progressPanel_->setExploitability(snapshot.exploitability.bb, snapshot.exploitability.percentPot);
+        }
+        updateStrategyDisplay();
     }
     
-    // Update progress
-    int currentIter = solver_->currentIteration();
-    int totalIter = solver_->config().numIterations;
-    double exploitability = solver_->getExploitability();
-    
-    progressPanel_->setProgress(currentIter, totalIter);
-    progressPanel_->setExploitability(exploitability);
-    
-    // Periodically update strategy display
-    if (currentIter % 500 == 0 || currentIter == totalIter) {
-        updateStrategyDisplay();
+    if (finished) {
+        finishSolving();
     }
+}
+
+void MainWindow::finishSolving() {
+    solverTimer_->stop();
+    background_->join();
+    stopBtn_->setEnabled(false);
     
-    // Check if complete
-    if (currentIter >= totalIter) {
-        solverTimer_->stop();
+    bool stopped = solver_->isStopped();
+    if (background_->latest().reason == solver::StopReason::NO_DEAL) {
         solving_ = false;
         solveBtn_->setEnabled(true);
-        stopBtn_->setEnabled(false);
-        progressPanel_->setStatus("Complete");
-        progressPanel_->log(QString("Solving complete after %1 iterations.").arg(currentIter));
-        updateStrategyDisplay();
-        
-        // Re-enable UI now that solving is complete
+        progressPanel_->setStatus("No valid deal");
+        progressPanel_->log("Nothing to solve: a range is empty or every combo is blocked by the board.");
         enableUIForSolving(false);
-        
-        // Check if street is complete and advance if needed
-        handleStreetCompletion();
+        return;
+    }
+    if (stopped) {
+        progressPanel_->setStatus("Stopped");
+        progressPanel_->log("Solving stopped by user.");
+    } else {
+        progressPanel_->setStatus("Complete");
+        progressPanel_->log(QString("Solving complete after %1 iterations (%2).")
+            .arg(solver_->currentIteration())
+            .arg(solver::stopReasonToString(background_->latest().reason)));
+    }
+    
+    // The UI stays blocked until the solution is written: the export reads solver_
+    if (solver_->currentIteration() > 0) {
+        exportSolution(stopped);
+    } else {
+        completeSolving(stopped);
     }
 }
 
-void MainWindow::onStopClicked() {
-    if (solver_) {
-        solver_->stop();
-    }
+void MainWindow::completeSolving(bool stopped) {
     solving_ = false;
-    solverTimer_->stop();
     solveBtn_->setEnabled(true);
-    stopBtn_->setEnabled(false);
-    progressPanel_->setStatus("Stopped");
-    progressPanel_->log("Solving stopped by user.");
+    updateStrategyDisplay();
     
-    // Re-enable UI
+    // Re-enable UI now that solving is complete
     enableUIForSolving(false);
+    
+    // Check if street is complete and advance if needed
+    if (!stopped) {
+        handleStreetCompletion();
+    }
+}
+
+void MainWindow::stopBackgroundSolve() {
+    solverTimer_->stop();
+    background_.reset();
+    cancelExport();
+    solving_ = false;
+    solveBtn_->setEnabled(true);
+    stopBtn_->setEnabled(false);
+}
+
+void MainWindow::onStopClicked() {
+    // The solve thread finishes its iteration and publishes a last
+    // snapshot; pollSolver() then wraps up
+    if (background_ && solving_) {
+        background_->stop();
+        progressPanel_->setStatus("Stopping...");
+    }
 }
 
 void MainWindow::onResetClicked() {
+    stopBackgroundSolve();
+    
     // Reset game state
     solver::BetSizingConfig config;
     config.stackSize = stackSizeSpinner_->value();
@@ -623,6 +645,7 @@ void MainWindow::onResetClicked() {
     riverSelector_->enableAllCards();
     
     // Reset solver
+    solution_.reset();
     if (solver_) {
         solver_->reset();
     }
@@ -667,22 +690,12 @@ void MainWindow::updateDisplay() {
     
     // Update available actions
     auto actions = gameState_.getAvailableActions();
-    actionPanel_->setActions(actions);
+    actionPanel_->setActions(actions.toVector());
     
     // Enable/disable undo
     undoBtn_->setEnabled(gameState_.canUndo());
 }
 
-void MainWindow::onSolveProgress(int iteration, int total, double exploitability) {
-    progressPanel_->setProgress(iteration, total);
-    progressPanel_->setExploitability(exploitability);
-    
-    // Periodically update strategy display
-    if (iteration % 500 == 0 || iteration == total) {
-        updateStrategyDisplay();
-    }
-}
-
 void MainWindow::updateBoardDisplay() {
     // Board display is handled by card selectors
 }
@@ -691,67 +704,95 @@ void MainWindow::updateActionHistory() {
     // Action history is shown in the log
 }
 
-void MainWindow::updateStrategyDisplay() {
-    if (!solver_ || solver_->currentIteration() == 0) {
-        return;
+void MainWindow::exportSolution(bool stopped) {
+    // Release the previous mapping before its file is replaced
+    solution_.reset();
+    if (!solutionFile_) {
+        solutionFile_ = std::make_unique<QTemporaryFile>(QDir(QDir::tempPath()).filePath("turbofire_XXXXXX.tfs"));
+        if (solutionFile_->open()) {
+            solutionFile_->close();
+        }
     }
-    
+    std::string path = solutionFile_->fileName().toStdString();
+    
+    // Writing a flop solution takes seconds, so it runs on its own thread;
+    // the window picks up the result once it finishes
+    progressPanel_->setStatus("Writing solution...");
+    auto written = std::make_shared<bool>(false);
+    exportThread_ = QThread::create([solver = solver_.get(), path, written]() {
+        *written = !path.empty() && solver::SolutionFile::write(*solver, path);
+    });
+    connect(exportThread_, &QThread::finished, this, [this, path, written, stopped]() {
+        exportThread_->deleteLater();
+        exportThread_ = nullptr;
+        if (*written) {
+            solution_ = solver::SolutionFile::open(path);
+        } else {
+            progressPanel_->log("Could not write the solution file; showing live solver results.");
+        }
+        progressPanel_->setStatus(stopped ? "Stopped" : "Complete");
+        completeSolving(stopped);
+    });
+    exportThread_->start();
+}
+
+void MainWindow::cancelExport() {
+    // Wait for the write, then drop its result: the solve it belongs to is gone
+    if (!exportThread_) return;
+    exportThread_->disconnect(this);
+    exportThread_->wait();
+    delete exportThread_;
+    exportThread_ = nullptr;
+}
+
+void MainWindow::updateStrategyDisplay() {
     solver::Position viewPlayer = (viewPlayerSelector_->currentIndex() == 0) ? 
                                    solver::Position::OOP : solver::Position::IP;
     
-    auto strategies = solver_->getAllStrategies(viewPlayer);
-    
-    // Get action names and pass actions to grid for color mapping
-    auto actions = gameState_.getAvailableActions();
-    strategyGrid_->setAvailableActions(actions);
-    
-    std::vector<std::string> actionNames;
-    for (const auto& action : actions) {
-        actionNames.push_back(action.toString());
-    }
-    
-    // Collect individual hand strategies for detailed tooltips
-    std::map<std::string, std::vector<solver::NodeStrategy>> handStrategies;
-    const core::Range& range = (viewPlayer == solver::Position::OOP) ? oopRange_ : ipRange_;
-    
-    // Get dead cards (board)
-    std::vector<core::Card> deadCards = gameState_.board();
-    
-    // For each hand type, get strategies for all individual hands
-    for (const auto& [handType, weight] : range.getHandTypes()) {
-        if (weight <= 0) continue;
-        
-        std::string handTypeStr = handType.toString();
-        std::vector<solver::NodeStrategy> handsForType;
-        
-        // Get all hands of this type
-        auto hands = handType.getHands();
-        for (const auto& hand : hands) {
-            // Check if hand conflicts with board
-            bool conflicts = false;
-            for (const auto& boardCard : deadCards) {
-                if (hand.contains(boardCard)) {
-                    conflicts = true;
-                    break;
-                }
-            }
-            
-            if (!conflicts) {
-                // Get strategy for this specific hand
-                auto handStrat = solver_->getStrategy(viewPlayer, hand);
-                // Store the actual hand string (e.g., "AsKs") instead of canonical name
-                handStrat.handType = hand.toString();
-                handsForType.push_back(handStrat);
-            }
+    // A finished solution is read straight from its file
+    if (solution_) {
+        auto actions = gameState_.getAvailableActions();
+        std::vector<std::string> actionNames;
+        for (const auto& action : actions) {
+            actionNames.push_back(action.toString());
         }
+        strategyGrid_->setAvailableActions(actions.toVector());
         
-        if (!handsForType.empty()) {
-            handStrategies[handTypeStr] = handsForType;
+        const core::Range& range = (viewPlayer == solver::Position::OOP) ? oopRange_ : ipRange_;
+        if (strategyGrid_->setSolution(*solution_, gameState_, viewPlayer, range, actionNames)) {
+            return;
         }
     }
     
-    // Use the enhanced method that includes per-hand data
-    strategyGrid_->setStrategyWithHands(strategies, handStrategies, actionNames);
+    // Otherwise the latest snapshot of the solve thread: live while solving,
+    // and the final strategy if its solution file could not be written
+    if (!background_ || background_->latest().iteration == 0) {
+        return;
+    }
+    const auto& snapshot = background_->latest();
+    
+    // Pass actions to grid for color mapping
+    strategyGrid_->setAvailableActions(gameState_.getAvailableActions().toVector());
+    strategyGrid_->setStrategyMatrix(snapshot.players[static_cast<int>(viewPlayer)], snapshot.actionNames);
+}
+
+void MainWindow::createSolver(const solver::MCCFRConfig& config, bool resolveSubgame) {
+    // A state below the previous solve's root is re-solved as its subgame:
+    // exact reach-weighted ranges, and the opponent held to the values the
+    // previous solution gave it
+    solver::Subgame subgame;
+    bool resolve = resolveSubgame && solver_ && solver_->currentIteration() > 0 &&
+                   solver::Subgame::extract(*solver_, gameState_, subgame);
+    
+    solution_.reset();
+    background_.reset();  // Holds a reference to the solver being replaced
+    solver_ = std::make_unique<solver::MCCFRSolver>(config);
+    if (resolve) {
+        solver_->initialize(subgame);
+        progressPanel_->log("Re-solving the subgame of the previous solution.");
+    } else {
+        solver_->initialize(gameState_, oopRange_, ipRange_);
+    }
 }
 
 void MainWindow::narrowRangeAfterAction(solver::Position player, const solver::Action& action) {
@@ -762,22 +803,25 @@ void MainWindow::narrowRangeAfterAction(solver::Position player, const solver::A
     core::Range& range = (player == solver::Position::OOP) ? oopRange_ : ipRange_;
     core::Range narrowedRange;
     
-    // Get strategy for this player
-    auto strategies = solver_->getAllStrategies(player);
+    // The player's strategy at this decision, averaged per hand type
+    solver::StrategyMatrix matrix;
+    if (!matrix.bind(*solver_, player, gameState_)) {
+        return;  // Not a decision of the player in the solved tree
+    }
     
     // Find the action index that matches the selected action
     auto availableActions = gameState_.getAvailableActions();
     int actionIndex = -1;
-    for (size_t i = 0; i < availableActions.size(); ++i) {
+    for (int i = 0; i < availableActions.size(); ++i) {
         if (availableActions[i].type == action.type) {
             // For bets, also check pot fraction
             if (action.type == solver::ActionType::BET) {
                 if (std::abs(availableActions[i].potFraction - action.potFraction) < 0.01) {
-                    actionIndex = static_cast<int>(i);
+                    actionIndex = i;
                     break;
                 }
             } else {
-                actionIndex = static_cast<int>(i);
+                actionIndex = i;
                 break;
             }
         }
@@ -795,15 +839,10 @@ void MainWindow::narrowRangeAfterAction(solver::Position player, const solver::A
         if (weight <= 0) continue;
         
         // Find strategy for this hand type
-        auto handTypeStr = handType.toString();
+        auto [row, col] = handType.gridPosition();
         double actionProb = 0.0;
-        
-        for (const auto& strat : strategies) {
-            if (strat.handType == handTypeStr && 
-                actionIndex < static_cast<int>(strat.actionProbabilities.size())) {
-                actionProb = strat.actionProbabilities[actionIndex];
-                break;
-            }
+        if (matrix.cellWeight(row, col) > 0 && actionIndex < matrix.numActions()) {
+            actionProb = matrix.cell(row, col)[actionIndex];
         }
         
         // Keep hand if it takes this action with sufficient frequency
@@ -839,7 +878,6 @@ void MainWindow::enableUIForSolving(bool enable) {
     } else {
         // Re-enable based on current state
         int boardSize = static_cast<int>(gameState_.board().size());
-        solver::Street currentStreet = gameState_.currentStreet();
         
         // Flop selectors: enabled if flop not complete
         bool canSelectFlop = boardSize < 3;
@@ -847,14 +885,12 @@ void MainWindow::enableUIForSolving(bool enable) {
         flopSelector2_->setEnabled(canSelectFlop);
         flopSelector3_->setEnabled(canSelectFlop);
         
-        // Turn selector: enabled if flop complete (3 cards) and we're at turn street
-        // But only if turn card not yet selected
-        bool canSelectTurn = boardSize == 3 && currentStreet >= solver::Street::TURN;
+        // Turn selector: enabled once flop betting is closed and no turn card is set
+        bool canSelectTurn = boardSize == 3 && gameState_.awaitingCard();
         turnSelector_->setEnabled(canSelectTurn);
         
-        // River selector: enabled if turn complete (4 cards) and we're at river street
-        // But only if river card not yet selected
-        bool canSelectRiver = boardSize == 4 && currentStreet >= solver::Street::RIVER;
+        // River selector: enabled once turn betting is closed and no river card is set
+        bool canSelectRiver = boardSize == 4 && gameState_.awaitingCard();
         riverSelector_->setEnabled(canSelectRiver);
     }
 }
@@ -886,7 +922,7 @@ void MainWindow::handleStreetCompletion() {
         }
         
         if (streetComplete) {
-            progressPanel_->log("Flop complete. Ready for turn card selection.");
+            progressPanel_->log("Flop complete. Ready for turn card selection; the turn is re-solved as a subgame of this solution.");
             // Enable turn selector (UI blocking is already handled by enableUIForSolving)
             // The selector will be enabled when solving completes
         }
@@ -909,7 +945,7 @@ void MainWindow::handleStreetCompletion() {
         }
         
         if (streetComplete) {
-            progressPanel_->log("Turn complete. Ready for river card selection.");
+            progressPanel_->log("Turn complete. Ready for river card selection; the river is re-solved as a subgame of this solution.");
         }
     }
     
@@ -12,9 +12,13 @@
 #include <QTextEdit>
 #include <QProgressBar>
 #include <QTimer>
+#include <QThread>
+#include <QTemporaryFile>
 #include <memory>
 
 #include "solver/mccfr.hpp"
+#include "solver/background_solver.hpp"
+#include "solver/solution_file.hpp"
 #include "solver/game_state.hpp"
 #include "core/range.hpp"
 
@@ -51,10 +55,6 @@ private slots:
     void onStackSizeChanged(int value);
     void onUndoClicked();
     void updateDisplay();
-    void onSolveProgress(int iteration, int total, double exploitability);
-
-signals:
-    void solveProgressUpdated(int iteration, int total, double exploitability);
 
 private:
     void setupUI();
@@ -63,7 +63,14 @@ private:
     void updateBoardDisplay();
     void updateActionHistory();
     void updateStrategyDisplay();
-    void runSolver();
+    void startSolving();
+    void pollSolver();
+    void finishSolving();
+    void completeSolving(bool stopped);
+    void stopBackgroundSolve();
+    void exportSolution(bool stopped);
+    void cancelExport();
+    void createSolver(const solver::MCCFRConfig& config, bool resolveSubgame);
     void narrowRangeAfterAction(solver::Position player, const solver::Action& action);
     void enableUIForSolving(bool enable);
     void handleStreetCompletion();
@@ -105,12 +112,16 @@ private:
     
     // Solver state
     std::unique_ptr<solver::MCCFRSolver> solver_;
+    std::unique_ptr<solver::SolutionFile> solution_;  // Finished solve, read by the strategy grid
+    std::unique_ptr<QTemporaryFile> solutionFile_;    // This window's solution file, removed with it
+    QThread* exportThread_ = nullptr;                 // Writes solution_'s file off the GUI thread
+    std::unique_ptr<solver::BackgroundSolver> background_;  // Runs solver_; declared after it so it stops first
     solver::GameState gameState_;
     core::Range oopRange_;
     core::Range ipRange_;
     bool solving_ = false;
     
-    // Timer for solver updates
+    // Picks up the solve thread's snapshots
     QTimer* solverTimer_;
 };
 
@@ -1,6 +1,7 @@
 #include "progress_panel.hpp"
 #include <QDateTime>
 #include <QScrollBar>
+#include <algorithm>
 
 namespace gui {
 
@@ -89,10 +90,20 @@ void ProgressPanel::setProgress(int current, int total) {
     }
 }
 
-void ProgressPanel::setExploitability(double value) {
-    if (value >= 0) {
-        exploitabilityLabel_->setText(QString("Exploitability: %1 mbb/hand")
-                                     .arg(value, 0, 'f', 2));
+void ProgressPanel::setTimeProgress(int iteration, double seconds, double budgetSeconds) {
+    progressBar_->setMaximum(static_cast<int>(budgetSeconds * 1000));
+    progressBar_->setValue(static_cast<int>(std::min(seconds, budgetSeconds) * 1000));
+    iterationLabel_->setText(QString("Iteration: %1 (%2s / %3s)")
+                             .arg(iteration)
+                             .arg(seconds, 0, 'f', 1)
+                             .arg(budgetSeconds, 0, 'f', 0));
+}
+
+void ProgressPanel::setExploitability(double bb, double percentPot) {
+    if (bb >= 0) {
+        exploitabilityLabel_->setText(QString("Exploitability: %1 bb (%2% pot)")
+                                     .arg(bb, 0, 'f', 3)
+                                     .arg(percentPot, 0, 'f', 2));
     } else {
         exploitabilityLabel_->setText("Exploitability: --");
     }
@@ -126,7 +137,7 @@ void ProgressPanel::clearLog() {
 
 void ProgressPanel::reset() {
     setProgress(0, 0);
-    setExploitability(-1);
+    setExploitability(-1, 0);
     setStatus("Ready");
 }
 
@@ -20,7 +20,8 @@ public:
     
     // Update progress
     void setProgress(int current, int total);
-    void setExploitability(double value);
+    void setTimeProgress(int iteration, double seconds, double budgetSeconds);  // Bar tracks the time budget
+    void setExploitability(double bb, double percentPot);
     void setStatus(const QString& status);
     
     // Log output
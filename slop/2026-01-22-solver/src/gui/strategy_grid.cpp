@@ -228,6 +228,98 @@ void StrategyGrid::setStrategyWithHands(const std::vector<solver::NodeStrategy>&
     updateDisplay();
 }
 
+bool StrategyGrid::setSolution(const solver::SolutionFile& solution,
+                               const solver::GameState& state,
+                               solver::Position player,
+                               const core::Range& range,
+                               const std::vector<std::string>& actionNames) {
+    int runout = 0;
+    int nodeIndex = solution.findNode(state, runout);
+    if (nodeIndex < 0 || solution.node(nodeIndex).player != static_cast<uint8_t>(player)) {
+        return false;
+    }
+    
+    int numActions = solution.node(nodeIndex).numActions;
+    std::vector<float> matrix(static_cast<size_t>(core::NUM_COMBOS) * numActions);
+    if (!solution.strategy(nodeIndex, runout, matrix.data())) {
+        return false;
+    }
+    
+    actionNames_ = actionNames;
+    for (auto& row : actionProbs_) {
+        for (auto& cell : row) {
+            cell.clear();
+        }
+    }
+    for (auto& row : handStrategies_) {
+        for (auto& cell : row) {
+            cell.clear();
+        }
+    }
+    
+    // Each cell shows the range-weighted mean over its live combos, as
+    // StrategyMatrix cells do; tooltips list the combos
+    double cellWeight[13][13] = {};
+    for (const auto& [hand, weight] : range.getAvailableHands(state.board())) {
+        if (weight <= 0) continue;
+        
+        const float* probs = matrix.data() + hand.comboIndex() * numActions;
+        core::HandType type(hand.card1().rank(), hand.card2().rank(), hand.isSuited());
+        auto [row, col] = type.gridPosition();
+        handStrategies_[row][col][hand.toString()] = std::vector<double>(probs, probs + numActions);
+        
+        auto& cell = actionProbs_[row][col];
+        cell.resize(numActions, 0.0);
+        for (int a = 0; a < numActions; ++a) {
+            cell[a] += weight * probs[a];
+        }
+        cellWeight[row][col] += weight;
+    }
+    for (int row = 0; row < 13; ++row) {
+        for (int col = 0; col < 13; ++col) {
+            for (auto& p : actionProbs_[row][col]) {
+                p /= cellWeight[row][col];
+            }
+        }
+    }
+    
+    updateDisplay();
+    return true;
+}
+
+void StrategyGrid::setStrategyMatrix(const solver::StrategyMatrix& matrix,
+                                     const std::vector<std::string>& actionNames) {
+    if (!matrix.valid()) {
+        clear();
+        return;
+    }
+    
+    actionNames_ = actionNames;
+    int numActions = matrix.numActions();
+    for (int row = 0; row < 13; ++row) {
+        for (int col = 0; col < 13; ++col) {
+            auto& cell = actionProbs_[row][col];
+            cell.clear();
+            handStrategies_[row][col].clear();
+            if (matrix.cellWeight(row, col) > 0) {
+                const float* probs = matrix.cell(row, col);
+                cell.assign(probs, probs + numActions);
+            }
+        }
+    }
+    
+    for (int c = 0; c < core::NUM_COMBOS; ++c) {
+        if (matrix.comboWeight(c) <= 0) continue;
+        core::Hand hand = core::Hand::fromComboIndex(c);
+        core::HandType type(hand.card1().rank(), hand.card2().rank(), hand.isSuited());
+        auto [row, col] = type.gridPosition();
+        const float* probs = matrix.combo(c);
+        handStrategies_[row][col][hand.toString()] = std::vector<double>(probs, probs + numActions);
+    }
+    
+    updateDisplay();
+}
+
 void StrategyGrid::clear() {
     for (auto& row : actionProbs_) {
         for (auto& cell : row) {
@@ -10,6 +10,8 @@
 #include <map>
 #include "solver/mccfr.hpp"
 #include "solver/game_state.hpp"
+#include "solver/solution_file.hpp"
+#include "solver/strategy_matrix.hpp"
 
 namespace gui {
 
@@ -58,6 +60,19 @@ public:
                               const std::map<std::string, std::vector<solver::NodeStrategy>>& handStrategies,
                               const std::vector<std::string>& actionNames);
     
+    // Show a finished solution at a state's node; false if the solution has
+    // no decision for the player there
+    bool setSolution(const solver::SolutionFile& solution,
+                     const solver::GameState& state,
+                     solver::Position player,
+                     const core::Range& range,
+                     const std::vector<std::string>& actionNames);
+    
+    // Show a live solve's node: cells are the matrix's range-weighted cell
+    // averages, tooltips its combos
+    void setStrategyMatrix(const solver::StrategyMatrix& matrix,
+                           const std::vector<std::string>& actionNames);
+    
     // Set available actions for color mapping
     void setAvailableActions(const std::vector<solver::Action>& actions);
     
@@ -17,6 +17,18 @@ constexpr uint16_t FULL_HOUSE_OFFSET = 7140;    // + 1277 possible flushes
 constexpr uint16_t FOUR_KIND_OFFSET = 7296;     // + 156 possible full houses
 constexpr uint16_t STRAIGHT_FLUSH_OFFSET = 7452;// + 156 possible quads
 
+// Start of each paired category's range in the rank table; one pair
+// hashes below TWO_PAIR_HASH
+constexpr uint32_t TWO_PAIR_HASH = 100000;
+constexpr uint32_t TRIPS_HASH = 110000;
+constexpr uint32_t FULL_HOUSE_HASH = 120000;
+constexpr uint32_t QUADS_HASH = 130000;
+constexpr size_t RANK_TABLE_SIZE = 140000;
+
+constexpr uint32_t pairHash(int pair, int k1, int k2, int k3) {
+    return pair * 7000 + k1 * 500 + k2 * 40 + k3;
+}
+
 HandEvaluator& HandEvaluator::instance() {
     static HandEvaluator evaluator;
     return evaluator;
@@ -109,15 +121,15 @@ void HandEvaluator::generateFlushTable() {
         }
     }
     
-    // Now add straight flushes
+    // Now add straight flushes, the wheel (A-2-3-4-5) lowest
     uint16_t sfRank = 0;
+    flush_lookup_[0x100F] = STRAIGHT_FLUSH_OFFSET + sfRank;
+    ++sfRank;
     for (int high = 4; high <= 12; ++high) {
         int bits = 0x1F << (high - 4);
         flush_lookup_[bits] = STRAIGHT_FLUSH_OFFSET + sfRank;
         ++sfRank;
     }
-    // Wheel straight flush (A-2-3-4-5)
-    flush_lookup_[0x100F] = STRAIGHT_FLUSH_OFFSET + sfRank;
 }
 
 void HandEvaluator::generateUnique5Table() {
@@ -127,14 +139,15 @@ void HandEvaluator::generateUnique5Table() {
     unique5_lookup_.fill(0);
     
     // Straights first (higher value than high cards)
+    // The wheel (A-2-3-4-5) is the lowest straight
     uint16_t straightRank = 0;
+    unique5_lookup_[0x100F] = STRAIGHT_OFFSET + straightRank;
+    ++straightRank;
     for (int high = 4; high <= 12; ++high) {
         int bits = 0x1F << (high - 4);
         unique5_lookup_[bits] = STRAIGHT_OFFSET + straightRank;
         ++straightRank;
     }
-    // Wheel (A-2-3-4-5)
-    unique5_lookup_[0x100F] = STRAIGHT_OFFSET + straightRank;
     
     // High card hands (no straight, no pairs)
     uint16_t highCardRank = 0;
@@ -159,31 +172,22 @@ void HandEvaluator::generateUnique5Table() {
 
 void HandEvaluator::generateRankTable() {
     // Generate lookup table for hands with duplicate ranks
-    // This uses a hash based on rank counts
-    
-    // Calculate size needed: we need to handle all possible rank distributions
-    // Maximum hash value estimation
-    constexpr size_t TABLE_SIZE = 100000;  // Conservative estimate
-    rank_lookup_.resize(TABLE_SIZE, 0);
-    
-    // Generate all possible rank count patterns for 5 cards
-    // and assign hand values
+    // This uses a hash based on rank counts; each category has its own
+    // hash range, and within a category hands are numbered weakest first
+    rank_lookup_.resize(RANK_TABLE_SIZE, 0);
     
     // One pair hands
     uint16_t pairRank = 0;
-    for (int pair = 12; pair >= 0; --pair) {
-        for (int k1 = 12; k1 >= 0; --k1) {
+    for (int pair = 0; pair <= 12; ++pair) {
+        for (int k1 = 0; k1 <= 12; ++k1) {
             if (k1 == pair) continue;
-            for (int k2 = k1 - 1; k2 >= 0; --k2) {
+            for (int k2 = 0; k2 < k1; ++k2) {
                 if (k2 == pair) continue;
-                for (int k3 = k2 - 1; k3 >= 0; --k3) {
+                for (int k3 = 0; k3 < k2; ++k3) {
                     if (k3 == pair) continue;
                     
                     // Hash for this hand: pair rank * offset + kickers
-                    uint32_t hash = pair * 7000 + k1 * 500 + k2 * 40 + k3;
-                    if (hash < TABLE_SIZE) {
-                        rank_lookup_[hash] = PAIR_OFFSET + pairRank;
-                    }
+                    rank_lookup_[pairHash(pair, k1, k2, k3)] = PAIR_OFFSET + pairRank;
                     ++pairRank;
                 }
             }
@@ -192,15 +196,12 @@ void HandEvaluator::generateRankTable() {
     
     // Two pair hands
     uint16_t twoPairRank = 0;
-    for (int high = 12; high >= 1; --high) {
-        for (int low = high - 1; low >= 0; --low) {
-            for (int kicker = 12; kicker >= 0; --kicker) {
+    for (int high = 1; high <= 12; ++high) {
+        for (int low = 0; low < high; ++low) {
+            for (int kicker = 0; kicker <= 12; ++kicker) {
                 if (kicker == high || kicker == low) continue;
                 
-                uint32_t hash = 50000 + high * 200 + low * 15 + kicker;
-                if (hash < TABLE_SIZE) {
-                    rank_lookup_[hash] = TWO_PAIR_OFFSET + twoPairRank;
-                }
+                rank_lookup_[TWO_PAIR_HASH + high * 200 + low * 15 + kicker] = TWO_PAIR_OFFSET + twoPairRank;
                 ++twoPairRank;
             }
         }
@@ -208,16 +209,13 @@ void HandEvaluator::generateRankTable() {
     
     // Three of a kind
     uint16_t tripsRank = 0;
-    for (int trips = 12; trips >= 0; --trips) {
-        for (int k1 = 12; k1 >= 0; --k1) {
+    for (int trips = 0; trips <= 12; ++trips) {
+        for (int k1 = 0; k1 <= 12; ++k1) {
             if (k1 == trips) continue;
-            for (int k2 = k1 - 1; k2 >= 0; --k2) {
+            for (int k2 = 0; k2 < k1; ++k2) {
                 if (k2 == trips) continue;
                 
-                uint32_t hash = 60000 + trips * 200 + k1 * 15 + k2;
-                if (hash < TABLE_SIZE) {
-                    rank_lookup_[hash] = THREE_KIND_OFFSET + tripsRank;
-                }
+                rank_lookup_[TRIPS_HASH + trips * 200 + k1 * 15 + k2] = THREE_KIND_OFFSET + tripsRank;
                 ++tripsRank;
             }
         }
@@ -225,28 +223,22 @@ void HandEvaluator::generateRankTable() {
     
     // Full house
     uint16_t fhRank = 0;
-    for (int trips = 12; trips >= 0; --trips) {
-        for (int pair = 12; pair >= 0; --pair) {
+    for (int trips = 0; trips <= 12; ++trips) {
+        for (int pair = 0; pair <= 12; ++pair) {
             if (pair == trips) continue;
             
-            uint32_t hash = 70000 + trips * 15 + pair;
-            if (hash < TABLE_SIZE) {
-                rank_lookup_[hash] = FULL_HOUSE_OFFSET + fhRank;
-            }
+            rank_lookup_[FULL_HOUSE_HASH + trips * 15 + pair] = FULL_HOUSE_OFFSET + fhRank;
             ++fhRank;
         }
     }
     
     // Four of a kind
     uint16_t quadsRank = 0;
-    for (int quads = 12; quads >= 0; --quads) {
-        for (int kicker = 12; kicker >= 0; --kicker) {
+    for (int quads = 0; quads <= 12; ++quads) {
+        for (int kicker = 0; kicker <= 12; ++kicker) {
             if (kicker == quads) continue;
             
-            uint32_t hash = 80000 + quads * 15 + kicker;
-            if (hash < TABLE_SIZE) {
-                rank_lookup_[hash] = FOUR_KIND_OFFSET + quadsRank;
-            }
+            rank_lookup_[QUADS_HASH + quads * 15 + kicker] = FOUR_KIND_OFFSET + quadsRank;
             ++quadsRank;
         }
     }
@@ -345,31 +337,31 @@ uint16_t HandEvaluator::computeHandValue(const std::array<int, 13>& rankCounts,
     
     // Four of a kind
     if (quads >= 0) {
-        uint32_t hash = 80000 + quads * 15 + kickers[0];
+        uint32_t hash = QUADS_HASH + quads * 15 + kickers[0];
         return rank_lookup_[hash];
     }
     
     // Full house
     if (trips >= 0 && highPair >= 0) {
-        uint32_t hash = 70000 + trips * 15 + highPair;
+        uint32_t hash = FULL_HOUSE_HASH + trips * 15 + highPair;
         return rank_lookup_[hash];
     }
     
     // Three of a kind
     if (trips >= 0) {
-        uint32_t hash = 60000 + trips * 200 + kickers[0] * 15 + kickers[1];
+        uint32_t hash = TRIPS_HASH + trips * 200 + kickers[0] * 15 + kickers[1];
         return rank_lookup_[hash];
     }
     
     // Two pair
     if (highPair >= 0 && lowPair >= 0) {
-        uint32_t hash = 50000 + highPair * 200 + lowPair * 15 + kickers[0];
+        uint32_t hash = TWO_PAIR_HASH + highPair * 200 + lowPair * 15 + kickers[0];
         return rank_lookup_[hash];
     }
     
     // One pair
     if (highPair >= 0) {
-        uint32_t hash = highPair * 7000 + kickers[0] * 500 + kickers[1] * 40 + kickers[2];
+        uint32_t hash = pairHash(highPair, kickers[0], kickers[1], kickers[2]);
         return rank_lookup_[hash];
     }
     
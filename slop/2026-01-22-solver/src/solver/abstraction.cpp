@@ -0,0 +1,370 @@
+#include "abstraction.hpp"
+#include "solution_library.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace solver {
+
+namespace {
+
+constexpr char BUCKET_MAGIC[8] = {'T', 'F', 'B', 'K', 'T', '0', '0', '1'};
+
+struct BucketHeader {
+    char magic[8];
+    int32_t boardSize;
+    int32_t numBuckets;
+    uint64_t count;
+};
+
+// Canonical mask of a board under suit isomorphism: the smallest card mask
+// over all 24 relabellings, and the relabelling that reaches it
+uint64_t canonicalMask(const core::Card* board, int size, SuitPermutation& toCanonical) {
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    for (const SuitPermutation& perm : SUIT_PERMUTATIONS) {
+        uint64_t mask = 0;
+        for (int i = 0; i < size; ++i) {
+            mask |= uint64_t{1} << perm.apply(board[i]).value();
+        }
+        if (mask < best) {
+            best = mask;
+            toCanonical = perm;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int BucketMap::bucket(const std::vector<core::Card>& board, const core::Hand& hand) const {
+    SuitPermutation perm;
+    auto it = boards_.find(canonicalMask(board.data(), static_cast<int>(board.size()), perm));
+    if (it == boards_.end()) return -1;
+    uint16_t b = it->second[perm.apply(hand).comboIndex()];
+    return b == NONE ? -1 : b;
+}
+
+bool BucketMap::contains(const std::vector<core::Card>& board) const {
+    SuitPermutation perm;
+    return static_cast<int>(board.size()) == boardSize_ &&
+           boards_.count(canonicalMask(board.data(), boardSize_, perm)) > 0;
+}
+
+void BucketMap::set(const std::vector<core::Card>& board, const std::vector<uint16_t>& buckets) {
+    SuitPermutation perm;
+    auto& row = boards_[canonicalMask(board.data(), static_cast<int>(board.size()), perm)];
+    row.assign(core::NUM_COMBOS, NONE);
+    for (int combo = 0; combo < core::NUM_COMBOS && combo < static_cast<int>(buckets.size()); ++combo) {
+        row[perm.apply(core::Hand::fromComboIndex(combo)).comboIndex()] = buckets[combo];
+    }
+}
+
+uint64_t BucketMap::fingerprint() const {
+    // FNV-1a over the boards in mask order, which does not depend on the hash map's
+    uint64_t hash = 14695981039346656037ull;
+    auto feed = [&hash](const void* data, size_t size) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ p[i]) * 1099511628211ull;
+        }
+    };
+    feed(&boardSize_, sizeof(boardSize_));
+    feed(&numBuckets_, sizeof(numBuckets_));
+
+    std::vector<uint64_t> masks;
+    masks.reserve(boards_.size());
+    for (const auto& entry : boards_) {
+        masks.push_back(entry.first);
+    }
+    std::sort(masks.begin(), masks.end());
+    for (uint64_t mask : masks) {
+        const auto& row = boards_.at(mask);
+        feed(&mask, sizeof(mask));
+        feed(row.data(), row.size() * sizeof(uint16_t));
+    }
+    return hash;
+}
+
+bool BucketMap::save(const std::string& path) const {
+    BucketHeader header{};
+    std::memcpy(header.magic, BUCKET_MAGIC, sizeof(header.magic));
+    header.boardSize = boardSize_;
+    header.numBuckets = numBuckets_;
+    header.count = boards_.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& [mask, row] : boards_) {
+        out.write(reinterpret_cast<const char*>(&mask), sizeof(mask));
+        out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(uint16_t));
+    }
+    return static_cast<bool>(out);
+}
+
+std::unique_ptr<BucketMap> BucketMap::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    BucketHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, BUCKET_MAGIC, sizeof(header.magic)) != 0 ||
+        header.boardSize < 3 || header.boardSize > 5 || header.numBuckets <= 0) {
+        return nullptr;
+    }
+
+    auto map = std::make_unique<BucketMap>(header.boardSize, header.numBuckets);
+    for (uint64_t i = 0; i < header.count; ++i) {
+        uint64_t mask = 0;
+        std::vector<uint16_t> row(core::NUM_COMBOS);
+        if (!in.read(reinterpret_cast<char*>(&mask), sizeof(mask)) ||
+            !in.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(uint16_t))) {
+            return nullptr;
+        }
+        map->boards_.emplace(mask, std::move(row));
+    }
+    return map;
+}
+
+double AbstractionBuilder::emd(const float* a, const float* b, int bins) {
+    double cdfA = 0.0, cdfB = 0.0, distance = 0.0;
+    for (int i = 0; i < bins; ++i) {
+        cdfA += a[i];
+        cdfB += b[i];
+        distance += std::abs(cdfA - cdfB);
+    }
+    return distance;
+}
+
+int AbstractionBuilder::numThreads() const {
+    if (config_.numThreads > 0) return config_.numThreads;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+BucketMap AbstractionBuilder::build(const std::vector<std::vector<core::Card>>& boards,
+                                    ProgressCallback progress) const {
+    int boardSize = boards.empty() ? 0 : static_cast<int>(boards.front().size());
+    int k = std::max(1, config_.numBuckets);
+    BucketMap out(boardSize, k);
+    if (boardSize < 3 || boardSize > 5) return out;
+
+    // One entry per canonical board, weighted by how many input boards map to it
+    std::map<uint64_t, size_t> indexByMask;
+    std::vector<std::vector<core::Card>> canonical;
+    std::vector<double> boardWeight;
+    for (const auto& board : boards) {
+        if (static_cast<int>(board.size()) != boardSize) continue;
+        SuitPermutation perm;
+        uint64_t mask = canonicalMask(board.data(), boardSize, perm);
+        auto [it, inserted] = indexByMask.emplace(mask, canonical.size());
+        if (inserted) {
+            std::vector<core::Card> mapped;
+            for (const auto& card : board) mapped.push_back(perm.apply(card));
+            canonical.push_back(std::move(mapped));
+            boardWeight.push_back(0.0);
+        }
+        boardWeight[it->second] += 1.0;
+    }
+
+    // Points are stored as what the distance compares: a CDF for histograms,
+    // so EMD is plain L1 and the mean of CDFs is the CDF of the mean histogram
+    bool histogram = config_.feature == AbstractionFeature::EQUITY_DISTRIBUTION ||
+                     config_.feature == AbstractionFeature::POTENTIAL_AWARE;
+    int bins = std::max(2, config_.histogramBins);
+    int dims = histogram ? bins : 1;
+
+    struct BoardPoints {
+        std::vector<int> combos;
+        std::vector<float> data;  // combos.size() x dims
+    };
+    std::vector<BoardPoints> points(canonical.size());
+
+    int threadCount = numThreads();
+    auto parallel = [threadCount](size_t count, const std::function<void(size_t)>& body) {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++) body(i);
+        };
+        std::vector<std::thread> threads;
+        for (int t = 1; t < threadCount; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    std::atomic<int> featurized{0};
+    std::mutex progressMutex;
+    EquityEngine().compute(canonical, bins, [&](size_t i, const BoardFeatures& features) {
+        const std::vector<float>& hist =
+            config_.feature == AbstractionFeature::POTENTIAL_AWARE ? features.potential : features.histogram;
+
+        BoardPoints& bp = points[i];
+        for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+            if (!features.live[combo]) continue;
+            bp.combos.push_back(combo);
+            if (!histogram) {
+                bp.data.push_back(config_.feature == AbstractionFeature::EHS ? features.ehs[combo]
+                                                                             : features.ehs2[combo]);
+                continue;
+            }
+            float cdf = 0.0f;
+            for (int b = 0; b < bins; ++b) {
+                cdf += hist[static_cast<size_t>(combo) * bins + b];
+                bp.data.push_back(cdf);
+            }
+        }
+
+        int done = ++featurized;
+        if (progress) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            progress("features", done, static_cast<int>(canonical.size()));
+        }
+    }, threadCount);
+
+    // Flat index of every point: (board, row)
+    std::vector<std::pair<uint32_t, uint32_t>> index;
+    for (size_t b = 0; b < points.size(); ++b) {
+        for (size_t r = 0; r < points[b].combos.size(); ++r) {
+            index.emplace_back(static_cast<uint32_t>(b), static_cast<uint32_t>(r));
+        }
+    }
+    if (index.empty()) return out;
+    auto point = [&](size_t i) { return &points[index[i].first].data[static_cast<size_t>(index[i].second) * dims]; };
+    auto distance = [dims](const float* a, const float* b) {
+        double d = 0.0;
+        for (int j = 0; j < dims; ++j) d += std::abs(a[j] - b[j]);
+        return d;
+    };
+
+    // k-means++ seeding on a sample of the points
+    std::mt19937 rng(config_.seed);
+    std::vector<size_t> sample;
+    if (config_.seedSample <= 0 || index.size() <= static_cast<size_t>(config_.seedSample)) {
+        for (size_t i = 0; i < index.size(); ++i) sample.push_back(i);
+    } else {
+        std::uniform_int_distribution<size_t> pick(0, index.size() - 1);
+        for (int i = 0; i < config_.seedSample; ++i) sample.push_back(pick(rng));
+    }
+    k = std::min<int>(k, static_cast<int>(sample.size()));
+
+    std::vector<float> centroids(static_cast<size_t>(k) * dims);
+    std::vector<double> nearest(sample.size(), std::numeric_limits<double>::max());
+    size_t first = sample[std::uniform_int_distribution<size_t>(0, sample.size() - 1)(rng)];
+    std::copy_n(point(first), dims, centroids.begin());
+    for (int c = 1; c <= k; ++c) {
+        const float* last = &centroids[static_cast<size_t>(c - 1) * dims];
+        double total = 0.0;
+        for (size_t s = 0; s < sample.size(); ++s) {
+            nearest[s] = std::min(nearest[s], distance(point(sample[s]), last));
+            total += nearest[s] * nearest[s];
+        }
+        if (c == k) break;
+
+        size_t chosen = sample[std::uniform_int_distribution<size_t>(0, sample.size() - 1)(rng)];
+        if (total > 0) {
+            double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+            for (size_t s = 0; s < sample.size(); ++s) {
+                target -= nearest[s] * nearest[s];
+                if (target <= 0) {
+                    chosen = sample[s];
+                    break;
+                }
+            }
+        }
+        std::copy_n(point(chosen), dims, centroids.begin() + static_cast<size_t>(c) * dims);
+    }
+
+    // Lloyd iterations; assignment is split into chunks across threads
+    std::vector<int> assignment(index.size(), -1);
+    constexpr size_t CHUNK = 4096;
+    size_t chunks = (index.size() + CHUNK - 1) / CHUNK;
+    for (int iteration = 0; iteration < std::max(1, config_.iterations); ++iteration) {
+        std::atomic<size_t> changed{0};
+        parallel(chunks, [&](size_t chunk) {
+            size_t moved = 0;
+            size_t end = std::min(index.size(), (chunk + 1) * CHUNK);
+            for (size_t i = chunk * CHUNK; i < end; ++i) {
+                const float* p = point(i);
+                int best = 0;
+                double bestDistance = std::numeric_limits<double>::max();
+                for (int c = 0; c < k; ++c) {
+                    double d = distance(p, &centroids[static_cast<size_t>(c) * dims]);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        best = c;
+                    }
+                }
+                if (assignment[i] != best) {
+                    assignment[i] = best;
+                    ++moved;
+                }
+            }
+            changed += moved;
+        });
+        if (progress) progress("clustering", iteration + 1, config_.iterations);
+        if (changed == 0) break;
+
+        // Weighted means; an empty cluster takes the point farthest from its centroid
+        std::vector<double> sums(centroids.size(), 0.0);
+        std::vector<double> weights(k, 0.0);
+        for (size_t i = 0; i < index.size(); ++i) {
+            double w = boardWeight[index[i].first];
+            const float* p = point(i);
+            double* s = &sums[static_cast<size_t>(assignment[i]) * dims];
+            for (int j = 0; j < dims; ++j) s[j] += w * p[j];
+            weights[assignment[i]] += w;
+        }
+        for (int c = 0; c < k; ++c) {
+            float* centroid = &centroids[static_cast<size_t>(c) * dims];
+            if (weights[c] > 0) {
+                for (int j = 0; j < dims; ++j) {
+                    centroid[j] = static_cast<float>(sums[static_cast<size_t>(c) * dims + j] / weights[c]);
+                }
+                continue;
+            }
+            size_t farthest = 0;
+            double farthestDistance = -1.0;
+            for (size_t i = 0; i < index.size(); ++i) {
+                double d = distance(point(i), &centroids[static_cast<size_t>(assignment[i]) * dims]);
+                if (d > farthestDistance) {
+                    farthestDistance = d;
+                    farthest = i;
+                }
+            }
+            std::copy_n(point(farthest), dims, centroid);
+            assignment[farthest] = c;
+        }
+    }
+
+    // Bucket numbers in order of centroid mean, so bucket 0 is the weakest
+    std::vector<double> strength(k, 0.0);
+    for (int c = 0; c < k; ++c) {
+        const float* centroid = &centroids[static_cast<size_t>(c) * dims];
+        // A CDF that rises late is a strong hand
+        for (int j = 0; j < dims; ++j) strength[c] += histogram ? -centroid[j] : centroid[j];
+    }
+    std::vector<int> order(k);
+    for (int c = 0; c < k; ++c) order[c] = c;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return strength[a] < strength[b]; });
+    std::vector<uint16_t> rank(k);
+    for (int r = 0; r < k; ++r) rank[order[r]] = static_cast<uint16_t>(r);
+
+    size_t i = 0;
+    for (size_t b = 0; b < points.size(); ++b) {
+        std::vector<uint16_t> buckets(core::NUM_COMBOS, BucketMap::NONE);
+        for (int combo : points[b].combos) {
+            buckets[combo] = rank[assignment[i++]];
+        }
+        out.set(canonical[b], buckets);
+    }
+    return out;
+}
+
+} // namespace solver
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "equity_engine.hpp"
+#include "core/card.hpp"
+#include "core/hand.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace solver {
+
+/**
+ * What the clustering compares
+ */
+enum class AbstractionFeature {
+    EHS,                  // Scalar expected hand strength
+    EHS2,                 // Scalar EHS^2
+    EQUITY_DISTRIBUTION,  // Histogram of river hand strength
+    POTENTIAL_AWARE       // Histogram of next-street EHS (river: hand strength)
+};
+
+struct AbstractionConfig {
+    int numBuckets = 50;
+    int histogramBins = 30;
+    AbstractionFeature feature = AbstractionFeature::POTENTIAL_AWARE;
+    int iterations = 25;      // Lloyd iterations after k-means++ seeding
+    int seedSample = 20000;   // Points k-means++ draws its seeds from
+    int numThreads = 0;       // 0: hardware concurrency
+    uint32_t seed = 1;
+};
+
+/**
+ * Card abstraction for one street: the bucket of every combo on every
+ * board it covers. Boards are stored in canonical suits (suit isomorphism),
+ * so one entry serves every isomorphic board.
+ *
+ * A GameTree built with a bucket map groups a player's combos into one
+ * info set per bucket instead of one per canonical hand name.
+ */
+class BucketMap {
+public:
+    static constexpr uint16_t NONE = 0xffff;
+
+    BucketMap() = default;
+    BucketMap(int boardSize, int numBuckets) : boardSize_(boardSize), numBuckets_(numBuckets) {}
+
+    int boardSize() const { return boardSize_; }
+    int numBuckets() const { return numBuckets_; }
+    size_t size() const { return boards_.size(); }
+
+    // Bucket of a combo on a board, -1 if the board is not covered or the
+    // combo is blocked by it
+    int bucket(const std::vector<core::Card>& board, const core::Hand& hand) const;
+    bool contains(const std::vector<core::Card>& board) const;
+
+    // Set the buckets of a board, given per combo in the board's own suits
+    void set(const std::vector<core::Card>& board, const std::vector<uint16_t>& buckets);
+
+    // Hash of the sizes and every board's buckets; equal maps key info sets
+    // identically (checkpoints)
+    uint64_t fingerprint() const;
+
+    bool save(const std::string& path) const;
+    static std::unique_ptr<BucketMap> load(const std::string& path);
+
+private:
+    int boardSize_ = 0;
+    int numBuckets_ = 0;
+    std::unordered_map<uint64_t, std::vector<uint16_t>> boards_;  // Canonical board mask -> bucket per canonical combo
+};
+
+/**
+ * Offline abstraction builder.
+ *
+ * Computes BoardFeatures for every canonical board of a street with the
+ * EquityEngine (in parallel over boards), then clusters all (board, combo) points into K buckets:
+ * k-means++ seeding on a sample, followed by Lloyd iterations whose
+ * assignment step is split across threads. Histograms are compared with
+ * the earth mover's distance, which for 1-D histograms is the L1 distance
+ * between their cumulative sums.
+ */
+class AbstractionBuilder {
+public:
+    using ProgressCallback = std::function<void(const std::string& stage, int done, int total)>;
+
+    explicit AbstractionBuilder(const AbstractionConfig& config) : config_(config) {}
+
+    // Bucket map over a set of boards of one size (3, 4 or 5 cards);
+    // isomorphic boards are featurized once
+    BucketMap build(const std::vector<std::vector<core::Card>>& boards,
+                    ProgressCallback progress = nullptr) const;
+
+    // Earth mover's distance between two histograms of `bins` bins
+    static double emd(const float* a, const float* b, int bins);
+
+private:
+    AbstractionConfig config_;
+
+    int numThreads() const;
+};
+
+} // namespace solver
@@ -0,0 +1,79 @@
+#include "background_solver.hpp"
+#include "solve_loop.hpp"
+#include <chrono>
+
+namespace solver {
+
+BackgroundSolver::BackgroundSolver(MCCFRSolver& solver, int snapshotMs, int exploitabilityMs)
+    : solver_(solver), snapshotMs_(snapshotMs), exploitabilityMs_(exploitabilityMs) {}
+
+BackgroundSolver::~BackgroundSolver() {
+    stop();
+    join();
+}
+
+void BackgroundSolver::start() {
+    if (thread_.joinable()) return;
+    finished_ = false;
+    thread_ = std::thread(&BackgroundSolver::run, this);
+}
+
+void BackgroundSolver::join() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void BackgroundSolver::run() {
+    using Clock = SolveLoop::Clock;
+    const auto snapshotPeriod = std::chrono::milliseconds(snapshotMs_);
+    SolveLoop loop(solver_, std::chrono::milliseconds(exploitabilityMs_));
+    auto lastSnapshot = Clock::now();
+
+    // The root's matrices are bound once; each snapshot re-reads the strategy
+    // sums and copies them into a slot whose vectors are already sized
+    std::vector<std::string> actionNames;
+    for (const auto& action : solver_.initialState().getAvailableActions()) {
+        actionNames.push_back(action.toString());
+    }
+    for (Position player : {Position::OOP, Position::IP}) {
+        matrices_[static_cast<int>(player)].bind(solver_, player, solver_.initialState());
+    }
+
+    auto publish = [&](bool complete) {
+        StrategySnapshot& snapshot = snapshots_.back();
+        snapshot.iteration = solver_.currentIteration();
+        snapshot.totalIterations = solver_.config().numIterations;
+        snapshot.seconds = loop.seconds();
+        snapshot.actionNames = actionNames;
+        for (int player = 0; player < 2; ++player) {
+            matrices_[player].update();
+            snapshot.players[player] = matrices_[player];
+        }
+        snapshot.complete = complete;
+        snapshot.reason = loop.reason();
+        snapshot.measured = loop.measured();
+        snapshot.exploitability = loop.exploitability();
+        snapshots_.publish();
+        lastSnapshot = Clock::now();
+    };
+
+    // Measurements come every exploitabilityMs, before the stopping rules
+    // so the target is checked against each
+    while (loop.step()) {
+        int measuredAt = loop.measuredAt();
+        loop.measure();
+        if (loop.shouldStop()) break;
+        if (loop.measuredAt() != measuredAt || Clock::now() - lastSnapshot >= snapshotPeriod) {
+            publish(false);
+        }
+    }
+
+    if (solver_.currentIteration() > 0) {
+        loop.measureNow();
+    }
+    publish(true);
+    finished_.store(true, std::memory_order_release);
+}
+
+} // namespace solver
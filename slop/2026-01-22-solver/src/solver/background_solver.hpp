@@ -0,0 +1,115 @@
+#pragma once
+
+#include "mccfr.hpp"
+#include "best_response.hpp"
+#include "strategy_matrix.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace solver {
+
+/**
+ * Lock-free single-producer single-consumer handoff of the latest value.
+ *
+ * Three slots: the writer fills its back slot and publish() swaps it with
+ * the shared middle slot; the reader's update() swaps the middle slot with
+ * its front slot when something new was published. Neither side ever
+ * waits, and slots are reused, so a T holding vectors stops allocating
+ * once their capacities settle.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer: the slot to fill, then publish it
+    T& back() { return slots_[back_]; }
+    void publish() {
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader: take the newest published value, if any; false if nothing
+    // was published since the last call
+    bool update() {
+        if (!(middle_.load(std::memory_order_acquire) & FRESH)) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;  // Middle slot holds a value the reader has not taken
+
+    std::array<T, 3> slots_;
+    uint8_t back_ = 0;                    // Writer only
+    uint8_t front_ = 1;                   // Reader only
+    std::atomic<uint8_t> middle_{2};
+};
+
+/**
+ * Progress of a solve and the average strategy at its root, per combo and
+ * per grid cell, for whichever player acts there.
+ */
+struct StrategySnapshot {
+    int iteration = 0;
+    int totalIterations = 0;
+    double seconds = 0;         // Solving time so far
+    bool complete = false;      // Last snapshot of the solve
+    StopReason reason = StopReason::ITERATIONS;  // Why it ended, once complete
+    bool measured = false;      // exploitability has been computed at least once
+    ExploitabilityReport exploitability;  // Latest measurement
+    std::vector<std::string> actionNames;
+    std::array<StrategyMatrix, 2> players;  // By Position; invalid for the player not acting at the root
+};
+
+/**
+ * Runs an initialized MCCFRSolver on its own thread and publishes
+ * snapshots of its average strategy through a TripleBuffer.
+ *
+ * The worker iterates without pause, stopping to capture a snapshot every
+ * snapshotMs milliseconds and to measure exploitability (a full best
+ * response, far dearer than an iteration) every exploitabilityMs, or
+ * after four times the last measurement's cost if that is longer. A
+ * viewer polling latest() never blocks the solve and never sees a
+ * half-written strategy. The solver must not be touched by anything else
+ * until finished() (or after stop() and join()).
+ *
+ * The config's stopping rules apply as in MCCFRSolver::solve() (see
+ * SolveLoop); the exploitability target is also checked at each of these
+ * measurements.
+ */
+class BackgroundSolver {
+public:
+    explicit BackgroundSolver(MCCFRSolver& solver, int snapshotMs = 100, int exploitabilityMs = 1000);
+    ~BackgroundSolver();
+    BackgroundSolver(const BackgroundSolver&) = delete;
+    BackgroundSolver& operator=(const BackgroundSolver&) = delete;
+
+    // Start the worker; runs until a stopping rule of the solver's config or stop()
+    void start();
+    void stop() { solver_.stop(); }
+    void join();
+
+    // The final snapshot has been published (the solver is idle)
+    bool finished() const { return finished_.load(std::memory_order_acquire); }
+
+    // Reader side, one thread: take the newest snapshot; false if there is none new
+    bool poll() { return snapshots_.update(); }
+    const StrategySnapshot& latest() const { return snapshots_.front(); }
+
+private:
+    MCCFRSolver& solver_;
+    int snapshotMs_;
+    int exploitabilityMs_;
+    TripleBuffer<StrategySnapshot> snapshots_;
+    std::array<StrategyMatrix, 2> matrices_;  // Worker only; copied into each snapshot
+    std::thread thread_;
+    std::atomic<bool> finished_{false};
+
+    void run();
+};
+
+} // namespace solver
@@ -0,0 +1,552 @@
+#include "best_response.hpp"
+#include "mccfr.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace solver {
+
+BestResponse::BestResponse(const MCCFRSolver& solver, TaskPool& pool)
+    : solver_(solver), tree_(solver.gameTree()), pool_(pool) {
+    buildRange(Position::OOP);
+    buildRange(Position::IP);
+    estimateWork();
+
+    // Normalizer: total weight of all compatible (OOP, IP) combo pairs
+    const auto& oop = ranges_[static_cast<int>(Position::OOP)];
+    const auto& ip = ranges_[static_cast<int>(Position::IP)];
+    std::vector<double> ipWeights(ip.combos.size());
+    for (size_t i = 0; i < ip.combos.size(); ++i) {
+        ipWeights[i] = ip.combos[i].weight;
+    }
+    std::vector<double> compatible(oop.combos.size());
+    compatibleReach(Position::OOP, ipWeights.data(), compatible.data());
+    for (size_t i = 0; i < oop.combos.size(); ++i) {
+        normalizer_ += oop.combos[i].weight * compatible[i];
+    }
+}
+
+void BestResponse::buildRange(Position player) {
+    const auto& weights = solver_.comboWeights(player);
+    PlayerRange& out = ranges_[static_cast<int>(player)];
+
+    out.indexOf.assign(core::NUM_COMBOS, -1);
+
+    for (int index = 0; index < static_cast<int>(weights.size()); ++index) {
+        core::Hand hand = core::Hand::fromComboIndex(index);
+        if (weights[index] <= 0 || tree_.slots(player, 0).slotOf(hand) < 0) continue;
+
+        Combo combo;
+        combo.hand = hand;
+        combo.weight = weights[index];
+        combo.card1 = hand.card1().value();
+        combo.card2 = hand.card2().value();
+        for (int level = 0; level < 3; ++level) {
+            combo.slot[level] = tree_.slots(player, level).slotOf(hand);
+        }
+        combo.index = hand.comboIndex();
+
+        out.indexOf[hand.comboIndex()] = static_cast<int>(out.combos.size());
+        out.combos.push_back(combo);
+    }
+}
+
+void BestResponse::estimateWork() {
+    double rangeSize = static_cast<double>(std::max(ranges_[0].combos.size(), ranges_[1].combos.size()));
+    int rootCards = static_cast<int>(solver_.initialState().board().size());
+
+    // Children follow their parents in the tree, so one backward pass does
+    work_.assign(tree_.numNodes(), 1.0);
+    for (int n = static_cast<int>(tree_.numNodes()) - 1; n >= 0; --n) {
+        const TreeNode& node = tree_.node(n);
+        if (node.isEstimated()) {
+            work_[n] = std::max(1.0, rangeSize);
+        } else if (node.type == NodeType::CHANCE) {
+            int cards = core::NUM_CARDS - rootCards - node.level;
+            work_[n] = 1 + cards * (work_[node.firstChild] + 1);
+        } else if (!node.isLeaf()) {
+            for (int a = 0; a < node.numActions; ++a) {
+                work_[n] += work_[node.firstChild + a];
+            }
+        }
+    }
+}
+
+void BestResponse::prepareBoard(Board& board) const {
+    board.strengths = &solver_.strengthCache().get(board.cards, board.size);
+
+    for (int player = 0; player < 2; ++player) {
+        const auto& combos = ranges_[player].combos;
+        auto& order = board.byStrength[player];
+        order.clear();
+        for (size_t i = 0; i < combos.size(); ++i) {
+            if (board.dead >> combos[i].card1 & 1 || board.dead >> combos[i].card2 & 1) continue;
+            order.push_back(static_cast<int>(i));
+        }
+
+        const auto& strengths = *board.strengths;
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return strengths[combos[a].index] < strengths[combos[b].index];
+        });
+    }
+}
+
+ExploitabilityReport BestResponse::compute() const {
+    ExploitabilityReport report;
+
+    // The two best responses are independent passes over the tree
+    TaskGroup group(pool_);
+    group.run([this, &report]() { report.ipBestResponse = bestResponseValue(Position::IP); });
+    report.oopBestResponse = bestResponseValue(Position::OOP);
+    group.wait();
+
+    // In a zero-sum game the two values sum to >= 0, with equality at Nash
+    report.bb = (report.oopBestResponse + report.ipBestResponse) / 2.0;
+    if (!tree_.empty() && tree_.node(0).pot > 0) {
+        report.percentPot = report.bb / tree_.node(0).pot * 100.0;
+    }
+    return report;
+}
+
+double BestResponse::bestResponseValue(Position player) const {
+    if (normalizer_ <= 0 || tree_.empty()) return 0;
+
+    const auto& br = ranges_[static_cast<int>(player)];
+    const auto& opp = ranges_[1 - static_cast<int>(player)];
+
+    Workspace ws = makeWorkspace(player);
+    Board& root = ws.boards[0];
+    for (const auto& card : solver_.initialState().board()) {
+        root.cards[root.size++] = card;
+        root.dead |= uint64_t{1} << card.value();
+    }
+    prepareBoard(root);
+
+    std::vector<double> oppReach(opp.combos.size());
+    for (size_t i = 0; i < opp.combos.size(); ++i) {
+        oppReach[i] = opp.combos[i].weight;
+    }
+
+    std::vector<double> values(br.combos.size());
+    walk(0, 0, player, oppReach.data(), values.data(), ws);
+
+    double total = 0;
+    for (size_t i = 0; i < br.combos.size(); ++i) {
+        total += br.combos[i].weight * values[i];
+    }
+    return total / normalizer_;
+}
+
+std::vector<double> BestResponse::counterfactualValues(Position player, int nodeIndex, int runout,
+                                                     const std::vector<core::Card>& board,
+                                                     const std::vector<double>& oppReach) const {
+    std::vector<double> out(core::NUM_COMBOS, 0.0);
+    if (tree_.empty() || nodeIndex < 0 || board.size() > 5) return out;
+
+    const auto& br = ranges_[static_cast<int>(player)];
+    const auto& opp = ranges_[1 - static_cast<int>(player)];
+    const TreeNode& node = tree_.node(nodeIndex);
+
+    Workspace ws = makeWorkspace(player);
+    Board& start = ws.boards[node.level];
+    start.runout = runout;
+    for (const auto& card : board) {
+        start.cards[start.size++] = card;
+        start.dead |= uint64_t{1} << card.value();
+    }
+    prepareBoard(start);
+
+    // Opponent combos on the board drop out
+    std::vector<double> reach(opp.combos.size());
+    for (size_t i = 0; i < opp.combos.size(); ++i) {
+        bool blocked = start.dead >> opp.combos[i].card1 & 1 || start.dead >> opp.combos[i].card2 & 1;
+        reach[i] = blocked ? 0.0 : oppReach[opp.combos[i].index];
+    }
+
+    std::vector<double> values(br.combos.size());
+    walk(nodeIndex, 0, player, reach.data(), values.data(), ws);
+
+    // Per unit of opponent reach, i.e. per hand played
+    std::vector<double> compatible(br.combos.size());
+    compatibleReach(player, reach.data(), compatible.data());
+    for (size_t i = 0; i < br.combos.size(); ++i) {
+        const auto& combo = br.combos[i];
+        if (start.dead >> combo.card1 & 1 || start.dead >> combo.card2 & 1) continue;
+        if (compatible[i] > 0) out[combo.index] = values[i] / compatible[i];
+    }
+    return out;
+}
+
+BestResponse::Workspace BestResponse::makeWorkspace(Position player) const {
+    const auto& br = ranges_[static_cast<int>(player)];
+    const auto& opp = ranges_[1 - static_cast<int>(player)];
+
+    Workspace ws;
+    int levels = tree_.maxDepth() + 1;
+    ws.childValues.assign(levels, std::vector<double>(br.combos.size()));
+    ws.childReach.assign(levels, std::vector<double>(opp.combos.size()));
+    int oppSlots = 0;
+    for (int level = 0; level < 3; ++level) {
+        oppSlots = std::max(oppSlots, tree_.slots(static_cast<Position>(1 - static_cast<int>(player)), level).size());
+    }
+    ws.strategies.assign(levels, std::vector<double>(static_cast<size_t>(oppSlots) * MAX_ACTIONS));
+    ws.tied.resize(br.combos.size());
+    return ws;
+}
+
+std::unique_ptr<BestResponse::Workspace> BestResponse::leaseWorkspace(Position player, const Board& board,
+                                                                      int level) const {
+    std::unique_ptr<Workspace> ws;
+    {
+        std::lock_guard<std::mutex> lock(spareMutex_);
+        auto& spare = spare_[static_cast<int>(player)];
+        if (!spare.empty()) {
+            ws = std::move(spare.back());
+            spare.pop_back();
+        }
+    }
+    if (!ws) ws = std::make_unique<Workspace>(makeWorkspace(player));
+    ws->boards[level] = board;
+    return ws;
+}
+
+void BestResponse::returnWorkspace(Position player, std::unique_ptr<Workspace> ws) const {
+    std::lock_guard<std::mutex> lock(spareMutex_);
+    spare_[static_cast<int>(player)].push_back(std::move(ws));
+}
+
+void BestResponse::walk(int nodeIndex, int depth, Position brPlayer,
+                        const double* oppReach, double* values, Workspace& ws) const {
+    const TreeNode& node = tree_.node(nodeIndex);
+    const auto& br = ranges_[static_cast<int>(brPlayer)];
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+    size_t numBr = br.combos.size();
+
+    if (node.isEstimated()) {
+        estimatedValues(node, brPlayer, oppReach, values, ws);
+        return;
+    }
+
+    if (node.isLeaf()) {
+        if (node.showdown) {
+            showdownValues(node, brPlayer, oppReach, values, ws);
+        } else {
+            foldValues(node, brPlayer, oppReach, values);
+        }
+        return;
+    }
+
+    if (node.type == NodeType::CHANCE) {
+        chanceValues(node, depth, brPlayer, oppReach, values, ws);
+        return;
+    }
+
+    double* childValues = ws.childValues[depth].data();
+
+    if (node.player == brPlayer) {
+        if (forkActions(node, depth, brPlayer, oppReach, values, ws)) return;
+
+        // Best responder: pick the maximizing action for every combo
+        std::fill(values, values + numBr, -std::numeric_limits<double>::infinity());
+        for (int a = 0; a < node.numActions; ++a) {
+            walk(node.firstChild + a, depth + 1, brPlayer, oppReach, childValues, ws);
+            for (size_t i = 0; i < numBr; ++i) {
+                values[i] = std::max(values[i], childValues[i]);
+            }
+        }
+        return;
+    }
+
+    // Opponent: play the average strategy, one lookup per info set slot
+    double* strategies = ws.strategies[depth].data();
+    int runout = ws.boards[node.level].runout;
+    int numSlots = tree_.slots(node.player, node.level).size();
+    for (int slot = 0; slot < numSlots; ++slot) {
+        tree_.averageStrategy(node, runout, slot, strategies + slot * node.numActions);
+    }
+    if (forkActions(node, depth, brPlayer, oppReach, values, ws)) return;
+
+    std::fill(values, values + numBr, 0.0);
+    double* childReach = ws.childReach[depth].data();
+
+    for (int a = 0; a < node.numActions; ++a) {
+        bool reachable = false;
+        for (size_t i = 0; i < opp.combos.size(); ++i) {
+            childReach[i] = oppReach[i] * strategies[opp.combos[i].slot[node.level] * node.numActions + a];
+            reachable |= childReach[i] > 0;
+        }
+        if (!reachable) continue;
+
+        walk(node.firstChild + a, depth + 1, brPlayer, childReach, childValues, ws);
+        for (size_t i = 0; i < numBr; ++i) {
+            values[i] += childValues[i];
+        }
+    }
+}
+
+void BestResponse::chanceValues(const TreeNode& node, int depth, Position brPlayer,
+                                const double* oppReach, double* values, Workspace& ws) const {
+    const Board& board = ws.boards[node.level];
+    size_t numBr = ranges_[static_cast<int>(brPlayer)].combos.size();
+
+    std::vector<int> cards;
+    for (int card = 0; card < core::NUM_CARDS; ++card) {
+        if (!(board.dead >> card & 1)) cards.push_back(card);
+    }
+
+    std::fill(values, values + numBr, 0.0);
+
+    // Cards in chunks of about PARALLEL_GRAIN work, each chunk on its own
+    // task and summing into its own buffer, when there are two or more
+    double perCard = work_[node.firstChild] + 1;
+    size_t chunk = static_cast<size_t>(std::max(1.0, std::ceil(PARALLEL_GRAIN / perCard)));
+    size_t numChunks = (cards.size() + chunk - 1) / chunk;
+    if (numChunks > 1) {
+        std::vector<std::vector<double>> sums(numChunks, std::vector<double>(numBr, 0.0));
+        TaskGroup group(pool_);
+        for (size_t k = 0; k < numChunks; ++k) {
+            group.run([&, k]() {
+                auto local = leaseWorkspace(brPlayer, board, node.level);
+                for (size_t c = k * chunk; c < std::min(cards.size(), (k + 1) * chunk); ++c) {
+                    dealValues(node, depth, cards[c], brPlayer, oppReach, sums[k].data(), *local);
+                }
+                returnWorkspace(brPlayer, std::move(local));
+            });
+        }
+        group.wait();
+        for (const auto& sum : sums) {
+            for (size_t i = 0; i < numBr; ++i) {
+                values[i] += sum[i];
+            }
+        }
+    } else {
+        for (int card : cards) {
+            dealValues(node, depth, card, brPlayer, oppReach, values, ws);
+        }
+    }
+
+    // Once both hands are known, each remaining card is equally likely
+    double unseen = static_cast<double>(cards.size()) - 4;
+    for (size_t i = 0; i < numBr; ++i) {
+        values[i] /= unseen;
+    }
+}
+
+bool BestResponse::forkActions(const TreeNode& node, int depth, Position brPlayer,
+                               const double* oppReach, double* values, Workspace& ws) const {
+    int large = 0;
+    for (int a = 0; a < node.numActions; ++a) {
+        large += work_[node.firstChild + a] >= PARALLEL_GRAIN;
+    }
+    if (large < 2) return false;
+
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+    size_t numBr = ranges_[static_cast<int>(brPlayer)].combos.size();
+    bool responder = node.player == brPlayer;
+    const double* strategies = ws.strategies[depth].data();  // Opponent's, filled by walk()
+
+    // Each action's values in its own buffer, combined in action order below
+    std::vector<std::vector<double>> results(node.numActions, std::vector<double>(numBr, 0.0));
+    auto walkAction = [&](int a, Workspace& local) {
+        const double* reach = oppReach;
+        if (!responder) {
+            double* childReach = local.childReach[depth].data();
+            bool reachable = false;
+            for (size_t i = 0; i < opp.combos.size(); ++i) {
+                childReach[i] = oppReach[i] * strategies[opp.combos[i].slot[node.level] * node.numActions + a];
+                reachable |= childReach[i] > 0;
+            }
+            if (!reachable) return;
+            reach = childReach;
+        }
+        walk(node.firstChild + a, depth + 1, brPlayer, reach, results[a].data(), local);
+    };
+
+    TaskGroup group(pool_);
+    for (int a = 0; a < node.numActions; ++a) {
+        if (work_[node.firstChild + a] < PARALLEL_GRAIN) continue;
+        group.run([&, a]() {
+            auto local = leaseWorkspace(brPlayer, ws.boards[node.level], node.level);
+            walkAction(a, *local);
+            returnWorkspace(brPlayer, std::move(local));
+        });
+    }
+    for (int a = 0; a < node.numActions; ++a) {
+        if (work_[node.firstChild + a] < PARALLEL_GRAIN) walkAction(a, ws);
+    }
+    group.wait();
+
+    std::fill(values, values + numBr, responder ? -std::numeric_limits<double>::infinity() : 0.0);
+    for (const auto& result : results) {
+        for (size_t i = 0; i < numBr; ++i) {
+            values[i] = responder ? std::max(values[i], result[i]) : values[i] + result[i];
+        }
+    }
+    return true;
+}
+
+void BestResponse::dealValues(const TreeNode& node, int depth, int card, Position brPlayer,
+                              const double* oppReach, double* values, Workspace& ws) const {
+    const auto& br = ranges_[static_cast<int>(brPlayer)];
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+
+    const Board& board = ws.boards[node.level];
+    Board& next = ws.boards[node.level + 1];
+    next.runout = GameTree::nextRunout(board.runout, card);
+    next.size = board.size;
+    std::copy(board.cards, board.cards + board.size, next.cards);
+    next.cards[next.size++] = core::Card(card);
+    next.dead = board.dead | uint64_t{1} << card;
+    prepareBoard(next);
+
+    // Opponent combos holding the card cannot reach the next street
+    double* childReach = ws.childReach[depth].data();
+    for (size_t i = 0; i < opp.combos.size(); ++i) {
+        bool blocked = opp.combos[i].card1 == card || opp.combos[i].card2 == card;
+        childReach[i] = blocked ? 0.0 : oppReach[i];
+    }
+
+    double* childValues = ws.childValues[depth].data();
+    walk(node.firstChild, depth + 1, brPlayer, childReach, childValues, ws);
+
+    for (size_t i = 0; i < br.combos.size(); ++i) {
+        if (br.combos[i].card1 == card || br.combos[i].card2 == card) continue;
+        values[i] += childValues[i];
+    }
+}
+
+void BestResponse::compatibleReach(Position brPlayer, const double* oppReach,
+                                   double* out) const {
+    const auto& br = ranges_[static_cast<int>(brPlayer)];
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+
+    // Opponent reach blocked by each card
+    std::array<double, core::NUM_CARDS> cardReach{};
+    double total = 0;
+    for (size_t i = 0; i < opp.combos.size(); ++i) {
+        cardReach[opp.combos[i].card1] += oppReach[i];
+        cardReach[opp.combos[i].card2] += oppReach[i];
+        total += oppReach[i];
+    }
+
+    for (size_t i = 0; i < br.combos.size(); ++i) {
+        const auto& combo = br.combos[i];
+        out[i] = total - cardReach[combo.card1] - cardReach[combo.card2];
+
+        // The identical combo was subtracted twice above
+        int same = opp.indexOf[combo.hand.comboIndex()];
+        if (same >= 0) out[i] += oppReach[same];
+    }
+}
+
+void BestResponse::foldValues(const TreeNode& node, Position brPlayer,
+                              const double* oppReach, double* values) const {
+    double oopPayoff = node.oopPayoff(0);
+    double payoff = (brPlayer == Position::OOP) ? oopPayoff : -oopPayoff;
+
+    compatibleReach(brPlayer, oppReach, values);
+    size_t numBr = ranges_[static_cast<int>(brPlayer)].combos.size();
+    for (size_t i = 0; i < numBr; ++i) {
+        values[i] *= payoff;
+    }
+}
+
+void BestResponse::showdownValues(const TreeNode& node, Position brPlayer,
+                                  const double* oppReach, double* values,
+                                  Workspace& ws) const {
+    const auto& br = ranges_[static_cast<int>(brPlayer)];
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+    const Board& board = ws.boards[node.level];
+    const auto& strengths = *board.strengths;
+    const auto& brOrder = board.byStrength[static_cast<int>(brPlayer)];
+    const auto& oppOrder = board.byStrength[1 - static_cast<int>(brPlayer)];
+
+    // Payoffs from the best responder's point of view
+    double sign = (brPlayer == Position::OOP) ? 1.0 : -1.0;
+    double winPayoff = sign * node.oopPayoff(static_cast<int>(sign));
+    double losePayoff = sign * node.oopPayoff(-static_cast<int>(sign));
+    double tiePayoff = sign * node.oopPayoff(0);
+
+    // Tied reach is whatever compatible reach is neither beaten nor winning
+    double* tied = ws.tied.data();
+    compatibleReach(brPlayer, oppReach, tied);
+
+    std::fill(values, values + br.combos.size(), 0.0);
+
+    // Ascending sweep: opponent reach with strictly weaker hands
+    std::array<double, core::NUM_CARDS> cardReach{};
+    double total = 0;
+    size_t j = 0;
+    for (int i : brOrder) {
+        const auto& combo = br.combos[i];
+        int strength = strengths[combo.index];
+        while (j < oppOrder.size() && strengths[opp.combos[oppOrder[j]].index] < strength) {
+            int o = oppOrder[j++];
+            cardReach[opp.combos[o].card1] += oppReach[o];
+            cardReach[opp.combos[o].card2] += oppReach[o];
+            total += oppReach[o];
+        }
+        double beaten = total - cardReach[combo.card1] - cardReach[combo.card2];
+        values[i] = winPayoff * beaten;
+        tied[i] -= beaten;
+    }
+
+    // Descending sweep: opponent reach with strictly stronger hands
+    cardReach.fill(0);
+    total = 0;
+    size_t k = oppOrder.size();
+    for (auto it = brOrder.rbegin(); it != brOrder.rend(); ++it) {
+        int i = *it;
+        const auto& combo = br.combos[i];
+        int strength = strengths[combo.index];
+        while (k > 0 && strengths[opp.combos[oppOrder[k - 1]].index] > strength) {
+            int o = oppOrder[--k];
+            cardReach[opp.combos[o].card1] += oppReach[o];
+            cardReach[opp.combos[o].card2] += oppReach[o];
+            total += oppReach[o];
+        }
+        double losing = total - cardReach[combo.card1] - cardReach[combo.card2];
+        values[i] += losePayoff * losing;
+        tied[i] -= losing;
+    }
+
+    if (tiePayoff != 0) {
+        for (size_t i = 0; i < br.combos.size(); ++i) {
+            values[i] += tiePayoff * tied[i];
+        }
+    }
+}
+
+void BestResponse::estimatedValues(const TreeNode& node, Position brPlayer,
+                                   const double* oppReach, double* values,
+                                   Workspace& ws) const {
+    const auto& br = ranges_[static_cast<int>(brPlayer)];
+    const auto& opp = ranges_[1 - static_cast<int>(brPlayer)];
+    const Board& board = ws.boards[node.level];
+    const LeafEstimator& estimator = *solver_.leafEstimator();
+
+    // OOP's chips in the pot, plus its estimated return against each combo
+    double sign = (brPlayer == Position::OOP) ? 1.0 : -1.0;
+    double committed = node.oopPayoff(0);
+    for (size_t i = 0; i < br.combos.size(); ++i) {
+        const auto& combo = br.combos[i];
+        values[i] = 0;
+        if (board.dead >> combo.card1 & 1 || board.dead >> combo.card2 & 1) continue;
+
+        double value = 0;
+        for (size_t o = 0; o < opp.combos.size(); ++o) {
+            const auto& other = opp.combos[o];
+            if (oppReach[o] <= 0 || other.card1 == combo.card1 || other.card1 == combo.card2 ||
+                other.card2 == combo.card1 || other.card2 == combo.card2) {
+                continue;
+            }
+            int oopCombo = (brPlayer == Position::OOP) ? combo.index : other.index;
+            int ipCombo = (brPlayer == Position::OOP) ? other.index : combo.index;
+            double oopValue = committed + estimator.value(node, board.cards, board.size, oopCombo, ipCombo);
+            value += oppReach[o] * sign * oopValue;
+        }
+        values[i] = value;
+    }
+}
+
+} // namespace solver
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "game_tree.hpp"
+#include "strength_cache.hpp"
+#include "task_pool.hpp"
+#include "core/hand.hpp"
+#include "core/range.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * Exploitability of an average strategy profile.
+ * All values are in big blinds per hand.
+ */
+struct ExploitabilityReport {
+    double oopBestResponse = 0;  // OOP best-response value vs IP average strategy
+    double ipBestResponse = 0;   // IP best-response value vs OOP average strategy
+    double bb = 0;               // Mean of the two best-response values
+    double percentPot = 0;       // bb as a percentage of the starting pot
+};
+
+/**
+ * Exact best-response computation against a solver's average strategy.
+ *
+ * Walks the solver's flat game tree once per best-responding player,
+ * carrying the opponent's reach probability for every live combo. The best
+ * responder picks the maximizing action per combo; the opponent plays its
+ * average strategy. Showdowns are valued with the sorted-strength prefix-sum
+ * method so each terminal costs O(n) in the combo count. Buffers are
+ * allocated per tree depth up front, so the walk itself does not allocate.
+ *
+ * Chance nodes are enumerated exactly: every unseen card is dealt, combos
+ * it blocks drop out, and the results are averaged. The leaves of a
+ * depth-limited tree take the leaf estimator's values, pair by pair.
+ *
+ * A walk forks onto a work-stealing TaskPool wherever the work below is
+ * large: turn and river cards in chunks of about PARALLEL_GRAIN, and the
+ * actions of a node when two or more of them lead to that much. A flop
+ * walk thus splits into up to 49 x 48 runouts that keep every core busy,
+ * while smaller subtrees stay serial. Forked results are combined in a
+ * fixed order, so values do not depend on the number of threads.
+ */
+class BestResponse {
+public:
+    // Work (combo-vector passes, see work_) of the smallest forked task
+    static constexpr double PARALLEL_GRAIN = 1024;
+
+    explicit BestResponse(const MCCFRSolver& solver, TaskPool& pool = TaskPool::shared());
+
+    // Compute both best responses (in parallel) and the resulting exploitability
+    ExploitabilityReport compute() const;
+
+    // Expected value (bb) of the best response for one player
+    double bestResponseValue(Position player) const;
+
+    // Best-response value (bb per hand) of each of a player's combos at a
+    // PLAYER node below the root, against the opponent's average strategy
+    // with the given reach per combo. The board is the node's (root board
+    // plus the runout's cards). Indexed by core::Hand::comboIndex(); zero
+    // for combos outside the range or without compatible opponent reach.
+    std::vector<double> counterfactualValues(Position player, int nodeIndex, int runout,
+                                             const std::vector<core::Card>& board,
+                                             const std::vector<double>& oppReach) const;
+
+private:
+    // A live combo of one player's range
+    struct Combo {
+        core::Hand hand;
+        double weight;
+        int card1;
+        int card2;
+        int slot[3];     // Info set slot per tree level
+        int index;       // core::Hand::comboIndex()
+    };
+
+    struct PlayerRange {
+        std::vector<Combo> combos;
+        std::vector<int> indexOf;     // core combo index -> combo index, -1 if absent
+    };
+
+    // The board at one tree level: the root board plus the cards dealt so far
+    struct Board {
+        int runout = 0;  // Storage index, see GameTree::nextRunout
+        int size = 0;
+        core::Card cards[5];
+        uint64_t dead = 0;
+        const StrengthCache::Table* strengths = nullptr;
+        std::array<std::vector<int>, 2> byStrength;  // Live combos by ascending strength, per player
+    };
+
+    // Scratch buffers for one best-response pass, one set per tree depth
+    struct Workspace {
+        std::vector<std::vector<double>> childValues;  // Best-responder combos
+        std::vector<std::vector<double>> childReach;   // Opponent combos
+        std::vector<std::vector<double>> strategies;   // Opponent slots x actions
+        std::vector<double> tied;                      // Showdown scratch
+        std::array<Board, 3> boards;                   // Per tree level
+    };
+
+    const MCCFRSolver& solver_;
+    const GameTree& tree_;
+    TaskPool& pool_;
+    std::array<PlayerRange, 2> ranges_;
+    double normalizer_ = 0;  // Sum of weight products over compatible combo pairs
+
+    // Estimated cost of walking each node's subtree, in passes over a range:
+    // one per node, one per dealt card, a range's worth per estimated leaf
+    std::vector<double> work_;
+
+    // Workspaces of finished tasks, per best-responding player
+    mutable std::mutex spareMutex_;
+    mutable std::array<std::vector<std::unique_ptr<Workspace>>, 2> spare_;
+
+    void buildRange(Position player);
+    void estimateWork();
+
+    // Set a board's strengths and per-player strength order
+    void prepareBoard(Board& board) const;
+
+    // Per-depth buffers for a walk by one best-responding player
+    Workspace makeWorkspace(Position player) const;
+
+    // Workspace for a forked task starting at a tree level, with that
+    // level's board; hand it back once the task is done
+    std::unique_ptr<Workspace> leaseWorkspace(Position player, const Board& board, int level) const;
+    void returnWorkspace(Position player, std::unique_ptr<Workspace> ws) const;
+
+    // Walk a player node's actions with the large ones on their own tasks;
+    // false, with nothing done, unless two or more are large
+    bool forkActions(const TreeNode& node, int depth, Position brPlayer,
+                     const double* oppReach, double* values, Workspace& ws) const;
+
+    // Values (unnormalized) for each best-responder combo at a node
+    void walk(int nodeIndex, int depth, Position brPlayer,
+              const double* oppReach, double* values, Workspace& ws) const;
+
+    // Average over the unseen cards of a chance node
+    void chanceValues(const TreeNode& node, int depth, Position brPlayer,
+                      const double* oppReach, double* values, Workspace& ws) const;
+
+    // Add the values of the subtree after dealing one card
+    void dealValues(const TreeNode& node, int depth, int card, Position brPlayer,
+                    const double* oppReach, double* values, Workspace& ws) const;
+
+    // Opponent reach that does not share a card with each best-responder combo
+    void compatibleReach(Position brPlayer, const double* oppReach, double* out) const;
+
+    void foldValues(const TreeNode& node, Position brPlayer,
+                    const double* oppReach, double* values) const;
+
+    void showdownValues(const TreeNode& node, Position brPlayer,
+                        const double* oppReach, double* values, Workspace& ws) const;
+
+    // Depth-limit leaf: every compatible pair valued by the leaf estimator
+    void estimatedValues(const TreeNode& node, Position brPlayer,
+                         const double* oppReach, double* values, Workspace& ws) const;
+};
+
+} // namespace solver
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace solver {
+
+/**
+ * A two-player zero-sum game as the templated CFR engine sees it.
+ *
+ * The initial state is a chance node (the deal). Players are 0 and 1;
+ * utility() is player 0's payoff at a terminal state. Every decision state
+ * belongs to an info set numbered in [0, numInfoSets()), with at most
+ * MAX_ACTIONS actions known at compile time.
+ */
+template <typename G>
+concept Game = requires(const G& game, const typename G::State& state, std::mt19937& rng, int action) {
+    typename G::State;
+    requires std::copyable<typename G::State>;
+    { G::MAX_ACTIONS } -> std::convertible_to<int>;
+    { game.numInfoSets() } -> std::convertible_to<size_t>;
+    { game.initial() } -> std::same_as<typename G::State>;
+    { game.isTerminal(state) } -> std::convertible_to<bool>;
+    { game.isChance(state) } -> std::convertible_to<bool>;
+    { game.sampleChance(state, rng) } -> std::same_as<typename G::State>;
+    { game.utility(state) } -> std::convertible_to<double>;
+    { game.player(state) } -> std::convertible_to<int>;
+    { game.numActions(state) } -> std::convertible_to<int>;
+    { game.infoSet(state) } -> std::convertible_to<size_t>;
+    { game.apply(state, action) } -> std::same_as<typename G::State>;
+};
+
+/**
+ * A game small enough to enumerate its chance outcomes, which exact
+ * best responses and exploitability need.
+ */
+template <typename G>
+concept EnumerableGame = Game<G> && requires(const G& game, const typename G::State& state, int outcome) {
+    { game.numChanceOutcomes(state) } -> std::convertible_to<int>;
+    { game.chanceProbability(state, outcome) } -> std::convertible_to<double>;
+    { game.applyChance(state, outcome) } -> std::same_as<typename G::State>;
+};
+
+// Regret matching: positive regrets normalized, uniform if none
+inline void regretMatching(const double* regrets, int numActions, double* strategy) {
+    double positive = 0;
+    for (int a = 0; a < numActions; ++a) {
+        strategy[a] = regrets[a] > 0 ? regrets[a] : 0.0;
+        positive += strategy[a];
+    }
+    if (positive > 0) {
+        for (int a = 0; a < numActions; ++a) strategy[a] /= positive;
+    } else {
+        for (int a = 0; a < numActions; ++a) strategy[a] = 1.0 / numActions;
+    }
+}
+
+/**
+ * Which parts of the tree an iteration samples. All schemes train the same
+ * tree and storage, so they can be switched between runs of one spot.
+ */
+enum class SamplingScheme {
+    EXTERNAL,  // Deal and opponent actions sampled; every traverser action walked
+    OUTCOME,   // One sampled path per traversal, importance-weighted; cheapest iterations
+    CHANCE,    // Deal and runouts sampled; every action of both players walked
+    VANILLA    // Nothing sampled: every deal, card and action, regrets applied per iteration
+};
+
+/**
+ * MCCFR over any Game, with the sampling schemes of MCCFRSolver.
+ *
+ * Regrets and strategy sums are two flat arrays of MAX_ACTIONS entries per
+ * info set, so the traversal is the same inlined loop for Kuhn, Leduc and
+ * hold'em, and an optimization made here is checked against the small
+ * games' known values before it reaches the poker tree. External sampling
+ * averages the opponent's strategy where it is played (simple averaging);
+ * the other schemes average the traverser's, weighted by its reach.
+ * VANILLA needs an EnumerableGame and samples chance like CHANCE otherwise.
+ *
+ * This engine stands beside MCCFRSolver, not under it: the solver keeps its
+ * own traversal over GameTree storage, and an idea proven here has to be
+ * ported to it by hand.
+ */
+template <Game G>
+class CFREngine {
+public:
+    using State = typename G::State;
+    static constexpr int N = G::MAX_ACTIONS;
+    static constexpr double EXPLORATION = 0.6;  // OUTCOME: share of uniform exploration at the traverser's nodes
+
+    explicit CFREngine(const G& game, SamplingScheme sampling = SamplingScheme::EXTERNAL, uint32_t seed = 1)
+        : game_(game),
+          sampling_(sampling),
+          regrets_(game.numInfoSets() * N, 0.0),
+          strategySum_(game.numInfoSets() * N, 0.0),
+          rng_(seed) {
+        if (enumerates()) pendingRegrets_.assign(regrets_.size(), 0.0);
+    }
+
+    // One iteration: a traversal for each player (over one sampled deal
+    // unless VANILLA)
+    void iterate() {
+        for (int traverser = 0; traverser < 2; ++traverser) {
+            switch (sampling_) {
+                case SamplingScheme::EXTERNAL:
+                    traverse(game_.initial(), traverser);
+                    break;
+                case SamplingScheme::OUTCOME: {
+                    double tailReach = 1.0;
+                    outcomeSample(game_.initial(), traverser, 1.0, 1.0, 1.0, tailReach);
+                    break;
+                }
+                default:
+                    fullTraversal(game_.initial(), traverser, 1.0, 1.0);
+                    if (enumerates()) applyPendingRegrets();
+                    break;
+            }
+        }
+        ++iterations_;
+    }
+    void iterate(int count) {
+        for (int i = 0; i < count; ++i) iterate();
+    }
+
+    int iterations() const { return iterations_; }
+    SamplingScheme sampling() const { return sampling_; }
+    const G& game() const { return game_; }
+
+    void reset() {
+        std::fill(regrets_.begin(), regrets_.end(), 0.0);
+        std::fill(strategySum_.begin(), strategySum_.end(), 0.0);
+        iterations_ = 0;
+    }
+
+    // Regret-matching strategy of an info set
+    void currentStrategy(size_t infoSet, int numActions, double* out) const {
+        regretMatching(&regrets_[infoSet * N], numActions, out);
+    }
+
+    // Accumulated strategy of an info set, MAX_ACTIONS entries
+    const double* strategySum(size_t infoSet) const { return &strategySum_[infoSet * N]; }
+
+    // Average strategy of an info set, uniform if it was never reached
+    void averageStrategy(size_t infoSet, int numActions, double* out) const {
+        const double* sum = &strategySum_[infoSet * N];
+        double total = 0;
+        for (int a = 0; a < numActions; ++a) total += sum[a];
+        for (int a = 0; a < numActions; ++a) {
+            out[a] = total > 0 ? sum[a] / total : 1.0 / numActions;
+        }
+    }
+
+private:
+    const G& game_;
+    SamplingScheme sampling_;
+    std::vector<double> regrets_;
+    std::vector<double> strategySum_;
+    std::vector<double> pendingRegrets_;  // VANILLA: this traversal's regrets, applied after it
+    std::mt19937 rng_;
+    int iterations_ = 0;
+
+    bool enumerates() const {
+        if constexpr (EnumerableGame<G>) return sampling_ == SamplingScheme::VANILLA;
+        return false;
+    }
+
+    void applyPendingRegrets() {
+        for (size_t i = 0; i < regrets_.size(); ++i) {
+            regrets_[i] += pendingRegrets_[i];
+            pendingRegrets_[i] = 0.0;
+        }
+    }
+
+    // Samples an action from a distribution over numActions
+    int sampleAction(const double* distribution, int numActions) {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double r = unit(rng_);
+        for (int a = 0; a < numActions - 1; ++a) {
+            r -= distribution[a];
+            if (r < 0) return a;
+        }
+        return numActions - 1;
+    }
+
+    double traverse(const State& state, int traverser) {
+        if (game_.isTerminal(state)) {
+            double u = game_.utility(state);
+            return traverser == 0 ? u : -u;
+        }
+        if (game_.isChance(state)) {
+            return traverse(game_.sampleChance(state, rng_), traverser);
+        }
+
+        int numActions = game_.numActions(state);
+        size_t infoSet = game_.infoSet(state);
+        double* regrets = &regrets_[infoSet * N];
+        std::array<double, N> strategy;
+        regretMatching(regrets, numActions, strategy.data());
+
+        if (game_.player(state) == traverser) {
+            std::array<double, N> values;
+            double nodeValue = 0;
+            for (int a = 0; a < numActions; ++a) {
+                values[a] = traverse(game_.apply(state, a), traverser);
+                nodeValue += strategy[a] * values[a];
+            }
+            for (int a = 0; a < numActions; ++a) {
+                regrets[a] += values[a] - nodeValue;
+            }
+            return nodeValue;
+        }
+
+        double* sum = &strategySum_[infoSet * N];
+        for (int a = 0; a < numActions; ++a) sum[a] += strategy[a];
+        return traverse(game_.apply(state, sampleAction(strategy.data(), numActions)), traverser);
+    }
+
+    // CHANCE and VANILLA: every action of both players, regrets weighted by
+    // the opponent's and chance's reach
+    double fullTraversal(const State& state, int traverser, double ownReach, double oppReach) {
+        if (game_.isTerminal(state)) {
+            double u = game_.utility(state);
+            return traverser == 0 ? u : -u;
+        }
+        if (game_.isChance(state)) {
+            if constexpr (EnumerableGame<G>) {
+                if (sampling_ == SamplingScheme::VANILLA) {
+                    double value = 0;
+                    for (int o = 0; o < game_.numChanceOutcomes(state); ++o) {
+                        double p = game_.chanceProbability(state, o);
+                        value += p * fullTraversal(game_.applyChance(state, o), traverser, ownReach, oppReach * p);
+                    }
+                    return value;
+                }
+            }
+            return fullTraversal(game_.sampleChance(state, rng_), traverser, ownReach, oppReach);
+        }
+
+        int numActions = game_.numActions(state);
+        size_t infoSet = game_.infoSet(state);
+        std::array<double, N> strategy;
+        regretMatching(&regrets_[infoSet * N], numActions, strategy.data());
+        bool traversing = game_.player(state) == traverser;
+
+        std::array<double, N> values;
+        double nodeValue = 0;
+        for (int a = 0; a < numActions; ++a) {
+            values[a] = fullTraversal(game_.apply(state, a), traverser,
+                                      traversing ? ownReach * strategy[a] : ownReach,
+                                      traversing ? oppReach : oppReach * strategy[a]);
+            nodeValue += strategy[a] * values[a];
+        }
+        if (!traversing) return nodeValue;
+
+        double* regrets = enumerates() ? &pendingRegrets_[infoSet * N] : &regrets_[infoSet * N];
+        double* sum = &strategySum_[infoSet * N];
+        for (int a = 0; a < numActions; ++a) {
+            regrets[a] += oppReach * (values[a] - nodeValue);
+            sum[a] += ownReach * strategy[a];
+        }
+        return nodeValue;
+    }
+
+    // OUTCOME: one path, sampled with exploration at the traverser's nodes;
+    // returns the payoff over the path's sampling probability, and the
+    // strategy's reach from this state to the terminal in tailReach
+    double outcomeSample(const State& state, int traverser, double ownReach, double oppReach,
+                         double sampleReach, double& tailReach) {
+        if (game_.isTerminal(state)) {
+            tailReach = 1.0;
+            double u = game_.utility(state);
+            return (traverser == 0 ? u : -u) / sampleReach;
+        }
+        if (game_.isChance(state)) {
+            // Chance is sampled with its own probability, which cancels out
+            return outcomeSample(game_.sampleChance(state, rng_), traverser, ownReach, oppReach,
+                                 sampleReach, tailReach);
+        }
+
+        int numActions = game_.numActions(state);
+        size_t infoSet = game_.infoSet(state);
+        double* regrets = &regrets_[infoSet * N];
+        std::array<double, N> strategy;
+        regretMatching(regrets, numActions, strategy.data());
+        bool traversing = game_.player(state) == traverser;
+
+        std::array<double, N> sampling = {};
+        double epsilon = traversing ? EXPLORATION : 0.0;
+        for (int a = 0; a < numActions; ++a) {
+            sampling[a] = epsilon / numActions + (1.0 - epsilon) * strategy[a];
+        }
+        int sampled = sampleAction(sampling.data(), numActions);
+
+        double value = outcomeSample(game_.apply(state, sampled), traverser,
+                                     traversing ? ownReach * strategy[sampled] : ownReach,
+                                     traversing ? oppReach : oppReach * strategy[sampled],
+                                     sampleReach * sampling[sampled], tailReach);
+
+        if (traversing) {
+            double weighted = value * oppReach;
+            double* sum = &strategySum_[infoSet * N];
+            for (int a = 0; a < numActions; ++a) {
+                regrets[a] += (a == sampled) ? weighted * tailReach * (1.0 - strategy[sampled])
+                                             : -weighted * tailReach * strategy[sampled];
+                sum[a] += ownReach / sampleReach * strategy[a];  // Stochastically weighted averaging
+            }
+        }
+        tailReach *= strategy[sampled];
+        return value;
+    }
+};
+
+/**
+ * Exact best response to a CFREngine's average strategy in an enumerable
+ * game.
+ *
+ * A first pass lists every history of each info set of the responder,
+ * with the opponent's and chance's reach. Decisions are then taken per
+ * info set, the deepest first being implied by recursion: an info set's
+ * action maximizes the reach-weighted value over all its histories, and
+ * each decision is memoized.
+ */
+template <EnumerableGame G>
+class ExactBestResponse {
+public:
+    using State = typename G::State;
+    static constexpr int N = G::MAX_ACTIONS;
+
+    using Strategy = std::function<void(size_t infoSet, int numActions, double* out)>;
+
+    ExactBestResponse(const G& game, Strategy strategy, int responder)
+        : game_(game), responder_(responder), strategy_(std::move(strategy)) {
+        collect(game.initial(), 1.0);
+    }
+
+    // Responder's expected payoff
+    double value() { return evaluate(game_.initial()); }
+
+private:
+    const G& game_;
+    int responder_;
+    Strategy strategy_;
+    std::map<size_t, std::vector<std::pair<State, double>>> histories_;  // Info set -> (history, reach)
+    std::map<size_t, int> decisions_;
+
+    void collect(const State& state, double reach) {
+        if (game_.isTerminal(state)) return;
+        if (game_.isChance(state)) {
+            for (int o = 0; o < game_.numChanceOutcomes(state); ++o) {
+                collect(game_.applyChance(state, o), reach * game_.chanceProbability(state, o));
+            }
+            return;
+        }
+        int numActions = game_.numActions(state);
+        if (game_.player(state) == responder_) {
+            histories_[game_.infoSet(state)].emplace_back(state, reach);
+            for (int a = 0; a < numActions; ++a) collect(game_.apply(state, a), reach);
+            return;
+        }
+        std::array<double, N> strategy;
+        strategy_(game_.infoSet(state), numActions, strategy.data());
+        for (int a = 0; a < numActions; ++a) {
+            if (strategy[a] > 0) collect(game_.apply(state, a), reach * strategy[a]);
+        }
+    }
+
+    int decision(size_t infoSet) {
+        auto it = decisions_.find(infoSet);
+        if (it != decisions_.end()) return it->second;
+
+        const auto& histories = histories_[infoSet];
+        int numActions = game_.numActions(histories.front().first);
+        int best = 0;
+        double bestValue = 0;
+        for (int a = 0; a < numActions; ++a) {
+            double total = 0;
+            for (const auto& [state, reach] : histories) {
+                total += reach * evaluate(game_.apply(state, a));
+            }
+            if (a == 0 || total > bestValue) {
+                bestValue = total;
+                best = a;
+            }
+        }
+        decisions_[infoSet] = best;
+        return best;
+    }
+
+    // Chance- and opponent-weighted value below a state, for the responder
+    double evaluate(const State& state) {
+        if (game_.isTerminal(state)) {
+            double u = game_.utility(state);
+            return responder_ == 0 ? u : -u;
+        }
+        if (game_.isChance(state)) {
+            double value = 0;
+            for (int o = 0; o < game_.numChanceOutcomes(state); ++o) {
+                value += game_.chanceProbability(state, o) * evaluate(game_.applyChance(state, o));
+            }
+            return value;
+        }
+        int numActions = game_.numActions(state);
+        if (game_.player(state) == responder_) {
+            return evaluate(game_.apply(state, decision(game_.infoSet(state))));
+        }
+        std::array<double, N> strategy;
+        strategy_(game_.infoSet(state), numActions, strategy.data());
+        double value = 0;
+        for (int a = 0; a < numActions; ++a) {
+            if (strategy[a] > 0) value += strategy[a] * evaluate(game_.apply(state, a));
+        }
+        return value;
+    }
+};
+
+// Expected payoff of player 0 when both play the engine's average strategy
+template <EnumerableGame G>
+double gameValue(const CFREngine<G>& engine) {
+    const G& game = engine.game();
+    auto value = [&](auto&& self, const typename G::State& state) -> double {
+        if (game.isTerminal(state)) return game.utility(state);
+        if (game.isChance(state)) {
+            double v = 0;
+            for (int o = 0; o < game.numChanceOutcomes(state); ++o) {
+                v += game.chanceProbability(state, o) * self(self, game.applyChance(state, o));
+            }
+            return v;
+        }
+        int numActions = game.numActions(state);
+        std::array<double, G::MAX_ACTIONS> strategy;
+        engine.averageStrategy(game.infoSet(state), numActions, strategy.data());
+        double v = 0;
+        for (int a = 0; a < numActions; ++a) {
+            if (strategy[a] > 0) v += strategy[a] * self(self, game.apply(state, a));
+        }
+        return v;
+    };
+    return value(value, game.initial());
+}
+
+// Exploitability of the engine's average strategy: the mean of both best
+// responses' gains, in the game's payoff units (0 at a Nash equilibrium)
+template <EnumerableGame G>
+double exploitability(const CFREngine<G>& engine) {
+    auto strategy = [&engine](size_t infoSet, int numActions, double* out) {
+        engine.averageStrategy(infoSet, numActions, out);
+    };
+    double br0 = ExactBestResponse<G>(engine.game(), strategy, 0).value();
+    double br1 = ExactBestResponse<G>(engine.game(), strategy, 1).value();
+    return (br0 + br1) / 2;
+}
+
+} // namespace solver
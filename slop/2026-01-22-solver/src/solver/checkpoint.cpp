@@ -0,0 +1,382 @@
+#include "checkpoint.hpp"
+#include "mccfr.hpp"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solver {
+
+static_assert(std::is_trivially_copyable_v<MCCFRConfig>);
+
+namespace {
+
+constexpr char END_MARKER[8] = {'T', 'F', 'C', 'K', 'E', 'N', 'D', '1'};
+
+// Sequential writer over a stdio stream; remembers the first failure
+class Writer {
+public:
+    explicit Writer(std::FILE* file) : file_(file) {}
+
+    void bytes(const void* data, size_t size) {
+        if (ok_ && size > 0) ok_ = std::fwrite(data, 1, size, file_) == size;
+    }
+
+    template <typename T>
+    void value(const T& v) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void array(const std::vector<T>& values) {
+        value<uint64_t>(values.size());
+        bytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void string(const std::string& s) {
+        value<uint64_t>(s.size());
+        bytes(s.data(), s.size());
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    std::FILE* file_;
+    bool ok_ = true;
+};
+
+// Bounds-checked reader over a mapped file
+class Reader {
+public:
+    Reader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+    const char* bytes(size_t size) {
+        if (!ok_ || static_cast<size_t>(end_ - pos_) < size) {
+            ok_ = false;
+            return nullptr;
+        }
+        const char* at = pos_;
+        pos_ += size;
+        return at;
+    }
+
+    template <typename T>
+    T value() {
+        T v{};
+        if (const char* at = bytes(sizeof(T))) std::memcpy(&v, at, sizeof(T));
+        return v;
+    }
+
+    template <typename T>
+    std::vector<T> array() {
+        uint64_t count = value<uint64_t>();
+        if (count > static_cast<size_t>(end_ - pos_) / sizeof(T)) {
+            ok_ = false;
+            return {};
+        }
+        std::vector<T> out(count);
+        if (const char* at = bytes(count * sizeof(T))) std::memcpy(out.data(), at, count * sizeof(T));
+        return out;
+    }
+
+    // Bytes of an array that must hold exactly `expected` values; nullptr
+    // (and failed) for any other length
+    template <typename T>
+    const char* arrayOf(size_t expected) {
+        uint64_t count = value<uint64_t>();
+        if (count != expected) {
+            ok_ = false;
+            return nullptr;
+        }
+        return bytes(count * sizeof(T));
+    }
+
+    std::string string() {
+        uint64_t size = value<uint64_t>();
+        const char* at = bytes(size);
+        return at ? std::string(at, size) : std::string();
+    }
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+
+private:
+    const char* pos_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+void writeRange(Writer& out, const core::Range& range) {
+    out.value<uint64_t>(range.getHandTypes().size());
+    for (const auto& [type, weight] : range.getHandTypes()) {
+        out.string(type.toString());
+        out.value(weight);
+    }
+}
+
+core::Range readRange(Reader& in) {
+    core::Range range;
+    uint64_t count = in.value<uint64_t>();
+    for (uint64_t i = 0; i < count && in.ok(); ++i) {
+        auto type = core::HandType::fromString(in.string());
+        double weight = in.value<double>();
+        if (type) range.setWeight(*type, weight);
+    }
+    return range;
+}
+
+void writeBetSizing(Writer& out, const BetSizingConfig& config) {
+    out.array(config.oopFlopBets);
+    out.array(config.oopTurnBets);
+    out.array(config.oopRiverBets);
+    out.array(config.ipFlopBets);
+    out.array(config.ipTurnBets);
+    out.array(config.ipRiverBets);
+    out.value(config.raiseMultiplier);
+    out.value(config.allInThreshold);
+    out.value(config.stackSize);
+    out.value(config.initialPot);
+}
+
+BetSizingConfig readBetSizing(Reader& in) {
+    BetSizingConfig config;
+    config.oopFlopBets = in.array<double>();
+    config.oopTurnBets = in.array<double>();
+    config.oopRiverBets = in.array<double>();
+    config.ipFlopBets = in.array<double>();
+    config.ipTurnBets = in.array<double>();
+    config.ipRiverBets = in.array<double>();
+    config.raiseMultiplier = in.value<double>();
+    config.allInThreshold = in.value<double>();
+    config.stackSize = in.value<double>();
+    config.initialPot = in.value<double>();
+    return config;
+}
+
+// Leaf estimator a solve with this config uses: the solver's, or the
+// EquityEstimator initialize() creates; none at full depth
+std::string leafSignature(const MCCFRConfig& config, const LeafEstimator* estimator) {
+    if (config.lastStreet == Street::RIVER) return {};
+    return estimator ? estimator->signature() : EquityEstimator().signature();
+}
+
+uint64_t bucketFingerprint(const BucketMap* buckets) {
+    return buckets ? buckets->fingerprint() : 0;
+}
+
+// One runout record, pointing into the mapped file
+struct RunoutRecord {
+    int runout;
+    size_t size;
+    size_t infoSets;
+    const char* regrets;
+    const char* strategySum;
+    const char* regretShift;
+    const char* sumShift;
+};
+
+} // namespace
+
+bool Checkpoint::save(const MCCFRSolver& solver, const std::string& path) {
+    const GameTree& tree = solver.gameTree_;
+    const GameState& root = solver.initialState_;
+
+    // A subgame's reach and gadget are not part of the file format
+    if (solver.isSubgame()) return false;
+
+    std::string tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) return false;
+
+    Writer out(file);
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.storageMode = static_cast<uint32_t>(tree.storageMode());
+    header.iteration = solver.iteration_;
+    header.strategyWeight = tree.strategyWeight();
+    header.numRunouts = tree.numRunouts();
+    out.value(header);
+
+    // Solve setup, enough to rebuild the identical tree
+    out.value(solver.config_);
+    writeBetSizing(out, root.config());
+    out.value(root.betting());
+    std::vector<int8_t> board;
+    for (const auto& card : root.board()) {
+        board.push_back(static_cast<int8_t>(card.value()));
+    }
+    out.array(board);
+    out.array(root.actionHistory());
+    writeRange(out, solver.oopRange_);
+    writeRange(out, solver.ipRange_);
+
+    // Leaf values and info set keys are not in the file; resuming needs the same
+    out.string(leafSignature(solver.config_, solver.leafEstimator()));
+    out.value(bucketFingerprint(solver.bucketMap()));
+
+    out.value<uint64_t>(solver.rngs_.size());
+    for (const auto& rng : solver.rngs_) {
+        std::ostringstream state;
+        state << rng;
+        out.string(state.str());
+    }
+
+    // Runouts are streamed one at a time, never copied as a whole
+    uint64_t written = 0;
+    for (int runout = 0; runout < GameTree::MAX_RUNOUTS && written < header.numRunouts; ++runout) {
+        const RunoutStorage* storage = tree.runoutStorage(runout);
+        if (!storage) continue;
+
+        out.value<int32_t>(runout);
+        if (tree.storageMode() == StorageMode::COMPACT) {
+            out.array(storage->compactRegrets);
+            out.array(storage->compactStrategySum);
+            out.array(storage->compactRegretShift);
+            out.array(storage->compactSumShift);
+        } else {
+            out.array(storage->regrets);
+            out.array(storage->strategySum);
+        }
+        ++written;
+    }
+    out.bytes(END_MARKER, sizeof(END_MARKER));
+
+    bool ok = out.ok() && written == header.numRunouts && std::fflush(file) == 0 &&
+              ::fsync(::fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+
+    // The rename replaces the previous checkpoint only once this one is complete
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::load(MCCFRSolver& solver, const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CheckpointHeader))) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    const char* data = static_cast<const char*>(mapped);
+    bool ok = load(solver, data, size);
+    ::munmap(mapped, size);
+    return ok;
+}
+
+bool Checkpoint::load(MCCFRSolver& solver, const char* data, size_t size) {
+    // Everything is parsed and checked before the solver is touched, so a
+    // bad file leaves it as it was
+    Reader in(data, size);
+    auto header = in.value<CheckpointHeader>();
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION ||
+        std::memcmp(data + size - sizeof(END_MARKER), END_MARKER, sizeof(END_MARKER)) != 0 ||
+        header.numRunouts > static_cast<uint64_t>(GameTree::MAX_RUNOUTS)) {
+        return false;
+    }
+
+    auto config = in.value<MCCFRConfig>();
+    auto betSizing = readBetSizing(in);
+    auto betting = in.value<BettingState>();
+    std::vector<core::Card> board;
+    for (int8_t card : in.array<int8_t>()) {
+        if (card < 0 || card >= core::NUM_CARDS) return false;
+        board.emplace_back(card);
+    }
+    auto history = in.array<Action>();
+    auto oopRange = readRange(in);
+    auto ipRange = readRange(in);
+    std::string leaves = in.string();
+    auto buckets = in.value<uint64_t>();
+
+    std::vector<std::mt19937> rngs;
+    uint64_t numRngs = in.value<uint64_t>();
+    for (uint64_t i = 0; i < numRngs && in.ok(); ++i) {
+        std::istringstream state(in.string());
+        if (!(state >> rngs.emplace_back())) return false;
+    }
+
+    if (!in.ok() || config.storageMode != static_cast<StorageMode>(header.storageMode) ||
+        leaves != leafSignature(config, solver.leafEstimator()) ||
+        buckets != bucketFingerprint(solver.bucketMap())) {
+        return false;
+    }
+
+    // The tree initialize() will build, for the record sizes
+    GameState root(betSizing);
+    root.restore(betting, board, history);
+    DepthLimit limit;
+    if (config.lastStreet != Street::RIVER) {
+        limit.lastStreet = config.lastStreet;
+        limit.continuations = solver.leafEstimator() ? solver.leafEstimator()->numContinuations() : 1;
+    }
+    GameTree shape;
+    shape.build(root, oopRange, ipRange, config.storageMode, limit, solver.bucketMap());
+
+    bool compact = config.storageMode == StorageMode::COMPACT;
+    std::vector<RunoutRecord> records;
+    std::vector<bool> seen(GameTree::MAX_RUNOUTS, false);
+    for (uint64_t r = 0; r < header.numRunouts; ++r) {
+        RunoutRecord record{};
+        record.runout = in.value<int32_t>();
+        if (!in.ok() || record.runout < 0 || record.runout >= GameTree::MAX_RUNOUTS ||
+            seen[record.runout] || shape.runoutSize(record.runout) == 0) {
+            return false;
+        }
+        seen[record.runout] = true;
+        record.size = shape.runoutSize(record.runout);
+        record.infoSets = shape.runoutInfoSets(record.runout);
+        if (compact) {
+            record.regrets = in.arrayOf<int32_t>(record.size);
+            record.strategySum = in.arrayOf<uint16_t>(record.size);
+            record.regretShift = in.arrayOf<uint8_t>(record.infoSets);
+            record.sumShift = in.arrayOf<uint8_t>(record.infoSets);
+        } else {
+            record.regrets = in.arrayOf<double>(record.size);
+            record.strategySum = in.arrayOf<double>(record.size);
+        }
+        if (!in.ok()) return false;
+        records.push_back(record);
+    }
+    if (in.remaining() != sizeof(END_MARKER)) return false;
+
+    // The file is sound: rebuild the solve and copy the arrays in
+    solver.setConfig(config);
+    solver.initialize(root, oopRange, ipRange);
+    GameTree& tree = solver.gameTree_;
+    for (const RunoutRecord& record : records) {
+        RunoutStorage& storage = tree.allocateRunout(record.runout);
+        if (compact) {
+            std::memcpy(storage.compactRegrets.data(), record.regrets, record.size * sizeof(int32_t));
+            std::memcpy(storage.compactStrategySum.data(), record.strategySum, record.size * sizeof(uint16_t));
+            std::memcpy(storage.compactRegretShift.data(), record.regretShift, record.infoSets);
+            std::memcpy(storage.compactSumShift.data(), record.sumShift, record.infoSets);
+        } else {
+            std::memcpy(storage.regrets.data(), record.regrets, record.size * sizeof(double));
+            std::memcpy(storage.strategySum.data(), record.strategySum, record.size * sizeof(double));
+        }
+    }
+    tree.setStrategyWeight(header.strategyWeight);
+    solver.iteration_ = static_cast<int>(header.iteration);
+    if (!rngs.empty()) solver.rngs_ = std::move(rngs);
+    return true;
+}
+
+} // namespace solver
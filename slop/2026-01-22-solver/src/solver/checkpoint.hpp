@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * Header of a checkpoint file.
+ *
+ * A checkpoint is one native-endian file: this header, the solve setup
+ * (solver config, bet sizing, root state, both ranges, the signature of
+ * the leaf estimator and the fingerprint of the bucket map), the RNG streams,
+ * then one record per allocated runout holding its raw regret and
+ * strategy-sum arrays, and a trailing end marker. A file without the end
+ * marker is rejected, so a partially written checkpoint is never loaded.
+ */
+struct CheckpointHeader {
+    char magic[8];            // CHECKPOINT_MAGIC
+    uint32_t version;
+    uint32_t storageMode;     // StorageMode of the runout records
+    int64_t iteration;
+    double strategyWeight;    // Discount state of compact strategy sums
+    uint64_t numRunouts;      // Runout records in the file
+};
+
+inline constexpr char CHECKPOINT_MAGIC[8] = {'T', 'F', 'C', 'K', 'P', 'T', '0', '1'};
+inline constexpr uint32_t CHECKPOINT_VERSION = 6;
+
+/**
+ * Saves and restores the complete state of an MCCFRSolver, so a long solve
+ * can resume where it stopped.
+ *
+ * Every save is a full snapshot: it rewrites all allocated runouts, not
+ * only those dirtied since the last save, so a checkpoint costs about as
+ * much as the tree's memoryUsage() in writes. Pick the frequency with that
+ * in mind.
+ *
+ * save() streams the state runout by runout into "<path>.tmp", syncs it and
+ * renames it over the path, so an interrupted write leaves the previous
+ * checkpoint intact. load() maps the file and checks all of it first: the
+ * solver must already hold the leaf estimator and bucket map the file was
+ * written with, and every record must fit the tree the setup builds. Only
+ * then is the tree rebuilt and the arrays copied straight in; a rejected
+ * file leaves the solver untouched.
+ */
+class Checkpoint {
+public:
+    static bool save(const MCCFRSolver& solver, const std::string& path);
+    static bool load(MCCFRSolver& solver, const std::string& path);
+
+private:
+    static bool load(MCCFRSolver& solver, const char* data, size_t size);
+};
+
+} // namespace solver
@@ -0,0 +1,252 @@
+#include "equity_engine.hpp"
+#include "ompeval/hand_evaluator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <thread>
+
+namespace solver {
+
+namespace {
+
+struct Entry {
+    int strength;
+    int combo;
+    int card1;
+    int card2;
+};
+
+// Live combos of a river board, sorted by showdown strength
+void evaluateRiver(const int* cards, std::vector<Entry>& entries) {
+    const auto& evaluator = ompeval::HandEvaluator::instance();
+    uint64_t boardMask = 0;
+    int hand[7];
+    for (int i = 0; i < 5; ++i) {
+        hand[i + 2] = cards[i];
+        boardMask |= uint64_t{1} << cards[i];
+    }
+
+    entries.clear();
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        core::Hand h = core::Hand::fromComboIndex(combo);
+        hand[0] = h.card1().value();
+        hand[1] = h.card2().value();
+        if ((boardMask >> hand[0] & 1) || (boardMask >> hand[1] & 1)) continue;
+        entries.push_back({evaluator.evaluate(hand, 7).value, combo, hand[0], hand[1]});
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.strength < b.strength; });
+}
+
+/**
+ * Wins plus half ties, and the opponent weight they are out of, for every
+ * live combo against opponent weights (nullptr: every combo weighs 1).
+ *
+ * An opponent blocked by the hand is one holding either of its cards, so
+ * per-card sums of the weight passed so far give each hand's result
+ * without a pairwise loop. The hand itself is counted once in each total
+ * and once per card, which the corrections add back.
+ */
+void sweep(const std::vector<Entry>& entries, const double* weights,
+           std::vector<double>& share, std::vector<double>& opponents) {
+    auto weightOf = [weights](const Entry& e) { return weights ? weights[e.combo] : 1.0; };
+
+    double total = 0.0;
+    double cardTotal[core::NUM_CARDS] = {};
+    for (const auto& e : entries) {
+        double w = weightOf(e);
+        total += w;
+        cardTotal[e.card1] += w;
+        cardTotal[e.card2] += w;
+    }
+
+    double lower = 0.0;
+    double cardLower[core::NUM_CARDS] = {};
+    double cardTied[core::NUM_CARDS] = {};
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin;
+        double tied = 0.0;
+        for (; end < entries.size() && entries[end].strength == entries[begin].strength; ++end) {
+            double w = weightOf(entries[end]);
+            tied += w;
+            cardTied[entries[end].card1] += w;
+            cardTied[entries[end].card2] += w;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            const Entry& e = entries[i];
+            double w = weightOf(e);
+            double wins = lower - cardLower[e.card1] - cardLower[e.card2];
+            double ties = tied - cardTied[e.card1] - cardTied[e.card2] + w;
+            share[e.combo] = wins + 0.5 * ties;
+            opponents[e.combo] = total - cardTotal[e.card1] - cardTotal[e.card2] + w;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            const Entry& e = entries[i];
+            double w = weightOf(e);
+            cardTied[e.card1] -= w;
+            cardTied[e.card2] -= w;
+            cardLower[e.card1] += w;
+            cardLower[e.card2] += w;
+        }
+        lower += tied;
+        begin = end;
+    }
+}
+
+int binOf(double strength, int bins) {
+    return std::clamp(static_cast<int>(strength * bins), 0, bins - 1);
+}
+
+} // namespace
+
+EquityEngine::EquityEngine(const core::Range& range) {
+    weights_.assign(core::NUM_COMBOS, 0.0);
+    for (const auto& [hand, weight] : range.getAvailableHands({})) {
+        weights_[hand.comboIndex()] = std::max(weight, 0.0);
+    }
+}
+
+EquityEngine::EquityEngine(std::vector<double> weights) : weights_(std::move(weights)) {
+    if (weights_.size() != static_cast<size_t>(core::NUM_COMBOS)) weights_.clear();
+}
+
+BoardFeatures EquityEngine::compute(const core::Card* board, int boardSize, int bins) const {
+    BoardFeatures out;
+    bins = std::max(1, bins);
+    out.bins = bins;
+    out.live.assign(core::NUM_COMBOS, 0);
+    out.equity.assign(core::NUM_COMBOS, 0.0f);
+    out.ehs.assign(core::NUM_COMBOS, 0.0f);
+    out.ehs2.assign(core::NUM_COMBOS, 0.0f);
+    out.histogram.assign(static_cast<size_t>(core::NUM_COMBOS) * bins, 0.0f);
+    out.potential.assign(static_cast<size_t>(core::NUM_COMBOS) * bins, 0.0f);
+    if (boardSize < 3 || boardSize > 5) return out;
+
+    int cards[5];
+    uint64_t boardMask = 0;
+    for (int i = 0; i < boardSize; ++i) {
+        cards[i] = board[i].value();
+        boardMask |= uint64_t{1} << cards[i];
+    }
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        core::Hand h = core::Hand::fromComboIndex(combo);
+        out.live[combo] = !(boardMask >> h.card1().value() & 1) && !(boardMask >> h.card2().value() & 1);
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(core::NUM_COMBOS);
+    std::vector<double> share(core::NUM_COMBOS), opponents(core::NUM_COMBOS);
+    std::vector<double> rangeShare(core::NUM_COMBOS), rangeOpponents(core::NUM_COMBOS);
+
+    std::vector<double> equityWon(core::NUM_COMBOS, 0.0), equityOf(core::NUM_COMBOS, 0.0);
+    std::vector<double> sum(core::NUM_COMBOS, 0.0), sumSquares(core::NUM_COMBOS, 0.0);
+    std::vector<double> rivers(core::NUM_COMBOS, 0.0);
+    std::vector<double> histogram(static_cast<size_t>(core::NUM_COMBOS) * bins, 0.0);
+
+    // Sum of river strengths per (next card, combo), for next-street EHS
+    std::vector<double> nextSum;
+    if (boardSize == 3) nextSum.assign(static_cast<size_t>(core::NUM_CARDS) * core::NUM_COMBOS, 0.0);
+
+    auto addRiver = [&](int turn) {
+        evaluateRiver(cards, entries);
+        sweep(entries, nullptr, share, opponents);
+        if (!weights_.empty()) sweep(entries, weights_.data(), rangeShare, rangeOpponents);
+
+        for (const auto& e : entries) {
+            int combo = e.combo;
+            double s = opponents[combo] > 0 ? share[combo] / opponents[combo] : 0.0;
+            sum[combo] += s;
+            sumSquares[combo] += s * s;
+            rivers[combo] += 1;
+            histogram[static_cast<size_t>(combo) * bins + binOf(s, bins)] += 1;
+            if (turn >= 0) {
+                // The pair (turn, river) is dealt in either order
+                nextSum[static_cast<size_t>(turn) * core::NUM_COMBOS + combo] += s;
+                nextSum[static_cast<size_t>(cards[4]) * core::NUM_COMBOS + combo] += s;
+            }
+            // Every (runout, opponent hand) pair is equally likely up to the
+            // opponent's weight, so equity is a ratio of sums
+            equityWon[combo] += weights_.empty() ? share[combo] : rangeShare[combo];
+            equityOf[combo] += weights_.empty() ? opponents[combo] : rangeOpponents[combo];
+        }
+    };
+
+    if (boardSize == 5) {
+        addRiver(-1);
+    } else if (boardSize == 4) {
+        for (int river = 0; river < core::NUM_CARDS; ++river) {
+            if (boardMask >> river & 1) continue;
+            cards[4] = river;
+            addRiver(-1);
+        }
+    } else {
+        for (int turn = 0; turn < core::NUM_CARDS; ++turn) {
+            if (boardMask >> turn & 1) continue;
+            cards[3] = turn;
+            for (int river = turn + 1; river < core::NUM_CARDS; ++river) {
+                if (boardMask >> river & 1) continue;
+                cards[4] = river;
+                addRiver(turn);
+            }
+        }
+    }
+
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        if (!out.live[combo] || rivers[combo] == 0) continue;
+        if (equityOf[combo] > 0) out.equity[combo] = static_cast<float>(equityWon[combo] / equityOf[combo]);
+        out.ehs[combo] = static_cast<float>(sum[combo] / rivers[combo]);
+        out.ehs2[combo] = static_cast<float>(sumSquares[combo] / rivers[combo]);
+        size_t row = static_cast<size_t>(combo) * bins;
+        for (int b = 0; b < bins; ++b) {
+            out.histogram[row + b] = static_cast<float>(histogram[row + b] / rivers[combo]);
+        }
+    }
+
+    if (boardSize != 3) {
+        // The next street is the river (or there is none): potential is the histogram
+        out.potential = out.histogram;
+        return out;
+    }
+
+    // Flop: distribution of the turn EHS over the turn cards the hand allows
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        if (!out.live[combo]) continue;
+        core::Hand h = core::Hand::fromComboIndex(combo);
+        uint64_t dead = boardMask | uint64_t{1} << h.card1().value() | uint64_t{1} << h.card2().value();
+        int turns = core::NUM_CARDS - std::popcount(dead);
+        size_t row = static_cast<size_t>(combo) * bins;
+        for (int turn = 0; turn < core::NUM_CARDS; ++turn) {
+            if (dead >> turn & 1) continue;
+            double turnEhs = nextSum[static_cast<size_t>(turn) * core::NUM_COMBOS + combo] / (turns - 1);
+            out.potential[row + binOf(turnEhs, bins)] += 1.0f / turns;
+        }
+    }
+    return out;
+}
+
+void EquityEngine::compute(const std::vector<std::vector<core::Card>>& boards, int bins,
+                           const BoardCallback& onBoard, int numThreads) const {
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Boards are handed out one at a time; a flop takes long enough that
+    // the shared counter costs nothing
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < boards.size(); i = next++) {
+            onBoard(i, compute(boards[i], bins));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace solver
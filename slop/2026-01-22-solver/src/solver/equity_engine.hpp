@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/card.hpp"
+#include "core/hand.hpp"
+#include "core/range.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace solver {
+
+/**
+ * Equity features of every combo on one board. Rows are indexed by
+ * core::Hand::comboIndex(); combos that share a card with the board are
+ * not live and have all-zero features.
+ */
+struct BoardFeatures {
+    int bins = 0;
+    std::vector<uint8_t> live;
+    std::vector<float> equity;     // Equity against the engine's range over all runouts
+    std::vector<float> ehs;        // Expected hand strength against a random hand
+    std::vector<float> ehs2;       // Mean squared river hand strength
+    std::vector<float> histogram;  // bins per combo: distribution of river hand strength
+    std::vector<float> potential;  // bins per combo: distribution of next-street EHS
+};
+
+/**
+ * Batch equity features for all 1326 combos of a board.
+ *
+ * Every runout of the board is dealt once and every combo is evaluated on
+ * it, instead of enumerating runouts hand by hand. On each river the
+ * combos are swept in strength order with per-card counts of the combos
+ * already passed, so wins and ties against a whole range cost O(n log n)
+ * rather than O(n^2). A flop is 1,081 rivers; boards are independent and
+ * are spread across threads.
+ *
+ * Equity is against the engine's range (a uniformly random hand by
+ * default). EHS, EHS^2 and the histograms are always against a random hand,
+ * which is what card abstraction compares.
+ */
+class EquityEngine {
+public:
+    using BoardCallback = std::function<void(size_t index, const BoardFeatures& features)>;
+
+    // Equity against a uniformly random hand
+    EquityEngine() = default;
+    // Equity against a weighted range
+    explicit EquityEngine(const core::Range& range);
+    // Equity against weights per core::Hand::comboIndex()
+    explicit EquityEngine(std::vector<double> weights);
+
+    // Features of a board of 3 to 5 cards
+    BoardFeatures compute(const core::Card* board, int boardSize, int bins) const;
+    BoardFeatures compute(const std::vector<core::Card>& board, int bins) const {
+        return compute(board.data(), static_cast<int>(board.size()), bins);
+    }
+
+    // Features of many boards on worker threads (0: hardware concurrency).
+    // The callback runs on the worker that finished the board.
+    void compute(const std::vector<std::vector<core::Card>>& boards, int bins,
+                 const BoardCallback& onBoard, int numThreads = 0) const;
+
+private:
+    std::vector<double> weights_;  // Empty: uniform
+};
+
+} // namespace solver
@@ -21,100 +21,15 @@ std::string Action::toString() const {
     }
 }
 
-GameState::GameState() : GameState(BetSizingConfig{}) {}
-
-GameState::GameState(const BetSizingConfig& config) : config_(config) {
-    pot_ = config_.initialPot;
-    oopStack_ = config_.stackSize - (config_.initialPot / 2);
-    ipStack_ = config_.stackSize - (config_.initialPot / 2);
-}
-
-void GameState::setStackSize(double bb) {
-    config_.stackSize = bb;
-    oopStack_ = bb - (config_.initialPot / 2);
-    ipStack_ = bb - (config_.initialPot / 2);
-}
-
-void GameState::setInitialPot(double bb) {
-    config_.initialPot = bb;
-    pot_ = bb;
-}
-
-void GameState::setOOPRange(const core::Range& range) {
-    oopRange_ = range;
-}
-
-void GameState::setIPRange(const core::Range& range) {
-    ipRange_ = range;
-}
-
-void GameState::setOOPHand(const core::Hand& hand) {
-    oopHand_ = hand;
-}
-
-void GameState::setIPHand(const core::Hand& hand) {
-    ipHand_ = hand;
-}
-
-void GameState::setBoard(const std::vector<core::Card>& board) {
-    board_ = board;
-    if (board.size() >= 3) street_ = Street::FLOP;
-    if (board.size() >= 4) street_ = Street::TURN;
-    if (board.size() >= 5) street_ = Street::RIVER;
-}
-
-void GameState::setFlop(const core::Card& c1, const core::Card& c2, const core::Card& c3) {
-    board_.clear();
-    board_.push_back(c1);
-    board_.push_back(c2);
-    board_.push_back(c3);
-    street_ = Street::FLOP;
-    currentPlayer_ = Position::OOP;
-    oopInvested_ = 0;
-    ipInvested_ = 0;
-}
-
-void GameState::setTurn(const core::Card& card) {
-    if (board_.size() == 3) {
-        board_.push_back(card);
-        street_ = Street::TURN;
-        currentPlayer_ = Position::OOP;
-        oopInvested_ = 0;
-        ipInvested_ = 0;
-    }
-}
-
-void GameState::setRiver(const core::Card& card) {
-    if (board_.size() == 4) {
-        board_.push_back(card);
-        street_ = Street::RIVER;
-        currentPlayer_ = Position::OOP;
-        oopInvested_ = 0;
-        ipInvested_ = 0;
-    }
-}
-
-double GameState::effectiveStack() const {
-    return std::min(oopStack_, ipStack_);
-}
-
-double GameState::getToCall() const {
-    if (currentPlayer_ == Position::OOP) {
-        return ipInvested_ - oopInvested_;
-    } else {
-        return oopInvested_ - ipInvested_;
-    }
-}
-
-std::vector<Action> GameState::getAvailableActions() const {
-    std::vector<Action> actions;
+void BettingState::getAvailableActions(const BetSizingConfig& config, ActionList& actions) const {
+    actions.clear();
     
-    if (isTerminal()) return actions;
+    if (isTerminal() || awaitingCard()) return;
     
-    double toCall = getToCall();
-    double currentStack = (currentPlayer_ == Position::OOP) ? oopStack_ : ipStack_;
-    double opponentInvested = (currentPlayer_ == Position::OOP) ? ipInvested_ : oopInvested_;
-    double myInvested = (currentPlayer_ == Position::OOP) ? oopInvested_ : ipInvested_;
+    double toCall = this->toCall();
+    double currentStack = (currentPlayer == Position::OOP) ? oopStack : ipStack;
+    double opponentInvested = (currentPlayer == Position::OOP) ? ipInvested : oopInvested;
+    double myInvested = (currentPlayer == Position::OOP) ? oopInvested : ipInvested;
     
     // Fold is available if there's something to call
     if (toCall > 0) {
@@ -135,27 +50,28 @@ std::vector<Action> GameState::getAvailableActions() const {
     }
     
     // Get bet sizes based on position and street
-    std::vector<double> betSizes;
-    if (currentPlayer_ == Position::OOP) {
-        switch (street_) {
-            case Street::FLOP: betSizes = config_.oopFlopBets; break;
-            case Street::TURN: betSizes = config_.oopTurnBets; break;
-            case Street::RIVER: betSizes = config_.oopRiverBets; break;
+    const std::vector<double>* betSizes = nullptr;
+    if (currentPlayer == Position::OOP) {
+        switch (street) {
+            case Street::FLOP: betSizes = &config.oopFlopBets; break;
+            case Street::TURN: betSizes = &config.oopTurnBets; break;
+            case Street::RIVER: betSizes = &config.oopRiverBets; break;
             default: break;
         }
     } else {
-        switch (street_) {
-            case Street::FLOP: betSizes = config_.ipFlopBets; break;
-            case Street::TURN: betSizes = config_.ipTurnBets; break;
-            case Street::RIVER: betSizes = config_.ipRiverBets; break;
+        switch (street) {
+            case Street::FLOP: betSizes = &config.ipFlopBets; break;
+            case Street::TURN: betSizes = &config.ipTurnBets; break;
+            case Street::RIVER: betSizes = &config.ipRiverBets; break;
             default: break;
         }
     }
     
     // If no bet has been made, these are bet sizes
     if (opponentInvested == 0) {
-        for (double pct : betSizes) {
-            double betAmount = pot_ * (pct / 100.0);
+        if (!betSizes) return;
+        for (double pct : *betSizes) {
+            double betAmount = pot * (pct / 100.0);
             
             if (betAmount >= currentStack) {
                 // All-in
@@ -166,9 +82,9 @@ std::vector<Action> GameState::getAvailableActions() const {
             }
             
             // Check all-in threshold
-            double potAfterBet = pot_ + betAmount;
+            double potAfterBet = pot + betAmount;
             double remainingStack = currentStack - betAmount;
-            if (remainingStack <= potAfterBet * (config_.allInThreshold / 100.0)) {
+            if (remainingStack <= potAfterBet * (config.allInThreshold / 100.0)) {
                 actions.push_back(Action::allIn(currentStack));
                 break;
             }
@@ -179,102 +95,197 @@ std::vector<Action> GameState::getAvailableActions() const {
     // Raises
     else if (toCall > 0) {
         // Standard raise (2.5x or configured)
-        double raiseAmount = opponentInvested * config_.raiseMultiplier;
+        double raiseAmount = opponentInvested * config.raiseMultiplier;
         
         if (raiseAmount <= currentStack) {
             // Check all-in threshold
             double totalBet = myInvested + raiseAmount;
-            double potAfterRaise = pot_ + totalBet - myInvested + (totalBet - opponentInvested);
+            double potAfterRaise = pot + totalBet - myInvested + (totalBet - opponentInvested);
             double remainingStack = currentStack - raiseAmount;
             
-            if (remainingStack <= potAfterRaise * (config_.allInThreshold / 100.0)) {
+            if (remainingStack <= potAfterRaise * (config.allInThreshold / 100.0)) {
                 actions.push_back(Action::allIn(currentStack));
             } else {
-                actions.push_back(Action::raise(raiseAmount, config_.raiseMultiplier));
+                actions.push_back(Action::raise(raiseAmount, config.raiseMultiplier));
             }
         } else if (currentStack > toCall) {
             // All-in raise
             actions.push_back(Action::allIn(currentStack));
         }
     }
-    
-    return actions;
 }
 
-void GameState::applyAction(const Action& action) {
-    history_.push_back(action);
+BettingState BettingState::apply(const Action& action) {
+    BettingState before = *this;
     
-    double& myStack = (currentPlayer_ == Position::OOP) ? oopStack_ : ipStack_;
-    double& myInvested = (currentPlayer_ == Position::OOP) ? oopInvested_ : ipInvested_;
-    double& oppInvested = (currentPlayer_ == Position::OOP) ? ipInvested_ : oopInvested_;
+    double& myStack = (currentPlayer == Position::OOP) ? oopStack : ipStack;
+    double& myInvested = (currentPlayer == Position::OOP) ? oopInvested : ipInvested;
     
     switch (action.type) {
         case ActionType::FOLD:
-            folded_ = true;
-            foldedPlayer_ = currentPlayer_;
+            folded = true;
+            foldedPlayer = currentPlayer;
             break;
             
         case ActionType::CHECK:
-            // If IP checks after OOP checks, advance street
-            if (currentPlayer_ == Position::IP && oopInvested_ == 0 && ipInvested_ == 0) {
-                advanceStreet();
-                return;
+            // If IP checks after OOP checks, the street is complete
+            if (currentPlayer == Position::IP && oopInvested == 0 && ipInvested == 0) {
+                closeStreet();
+                return before;
             }
             break;
             
         case ActionType::CALL:
             myStack -= action.amount;
             myInvested += action.amount;
-            pot_ += action.amount;
-            // After a call, advance street
-            advanceStreet();
-            return;
+            pot += action.amount;
+            // After a call, the street is complete
+            closeStreet();
+            return before;
             
         case ActionType::BET:
         case ActionType::RAISE:
         case ActionType::ALL_IN:
             myStack -= action.amount;
             myInvested += action.amount;
-            pot_ += action.amount;
+            pot += action.amount;
             break;
     }
     
     // Switch players
-    currentPlayer_ = (currentPlayer_ == Position::OOP) ? Position::IP : Position::OOP;
+    currentPlayer = (currentPlayer == Position::OOP) ? Position::IP : Position::OOP;
+    return before;
 }
 
-void GameState::undo() {
-    if (history_.empty()) return;
-    
-    // This is a simplified undo - for full support, we'd need to store more state
-    // For now, this is a placeholder
-    history_.pop_back();
+void BettingState::closeStreet() {
+    // Investments are already in the pot; the street changes when a card is dealt
+    oopInvested = 0;
+    ipInvested = 0;
+    currentPlayer = Position::OOP;
+    streetClosed = true;
+}
+
+void BettingState::startStreet(Street next) {
+    street = next;
+    streetClosed = false;
+    currentPlayer = Position::OOP;
+    oopInvested = 0;
+    ipInvested = 0;
 }
 
-bool GameState::isTerminal() const {
+bool BettingState::isTerminal() const {
     // Folded
-    if (folded_) return true;
+    if (folded) return true;
     
     // All-in and called
-    if (isAllIn() && oopInvested_ == ipInvested_) return true;
+    if (isAllIn() && oopInvested == ipInvested) return true;
     
     // River action complete (both checked or bet called)
-    if (street_ == Street::RIVER && oopInvested_ == ipInvested_ && 
-        !history_.empty() && 
-        (history_.back().type == ActionType::CALL || 
-         (history_.back().type == ActionType::CHECK && history_.size() >= 2))) {
-        return true;
-    }
+    if (street == Street::RIVER && streetClosed) return true;
     
     return false;
 }
 
-bool GameState::isAllIn() const {
-    return oopStack_ == 0 || ipStack_ == 0;
+double BettingState::toCall() const {
+    if (currentPlayer == Position::OOP) {
+        return ipInvested - oopInvested;
+    } else {
+        return oopInvested - ipInvested;
+    }
+}
+
+GameState::GameState() : GameState(BetSizingConfig{}) {}
+
+GameState::GameState(const BetSizingConfig& config) : config_(config) {
+    betting_.pot = config_.initialPot;
+    betting_.oopStack = config_.stackSize - (config_.initialPot / 2);
+    betting_.ipStack = config_.stackSize - (config_.initialPot / 2);
+}
+
+void GameState::setStackSize(double bb) {
+    config_.stackSize = bb;
+    betting_.oopStack = bb - (config_.initialPot / 2);
+    betting_.ipStack = bb - (config_.initialPot / 2);
+}
+
+void GameState::setInitialPot(double bb) {
+    config_.initialPot = bb;
+    betting_.pot = bb;
+}
+
+void GameState::setOOPRange(const core::Range& range) {
+    oopRange_ = range;
+}
+
+void GameState::setIPRange(const core::Range& range) {
+    ipRange_ = range;
+}
+
+void GameState::setOOPHand(const core::Hand& hand) {
+    oopHand_ = hand;
+}
+
+void GameState::setIPHand(const core::Hand& hand) {
+    ipHand_ = hand;
+}
+
+void GameState::setBoard(const std::vector<core::Card>& board) {
+    board_ = board;
+    if (board.size() >= 3) betting_.street = Street::FLOP;
+    if (board.size() >= 4) betting_.street = Street::TURN;
+    if (board.size() >= 5) betting_.street = Street::RIVER;
+}
+
+void GameState::setFlop(const core::Card& c1, const core::Card& c2, const core::Card& c3) {
+    board_.clear();
+    board_.push_back(c1);
+    board_.push_back(c2);
+    board_.push_back(c3);
+    dealStreet(Street::FLOP);
+}
+
+void GameState::setTurn(const core::Card& card) {
+    if (board_.size() == 3) {
+        board_.push_back(card);
+        dealStreet(Street::TURN);
+    }
+}
+
+void GameState::setRiver(const core::Card& card) {
+    if (board_.size() == 4) {
+        board_.push_back(card);
+        dealStreet(Street::RIVER);
+    }
+}
+
+void GameState::dealStreet(Street street) {
+    betting_.startStreet(street);
+    
+    // Dealing a card commits the previous street's actions
+    undoStack_.clear();
+}
+
+ActionList GameState::getAvailableActions() const {
+    ActionList actions;
+    betting_.getAvailableActions(config_, actions);
+    return actions;
+}
+
+void GameState::applyAction(const Action& action) {
+    history_.push_back(action);
+    undoStack_.push_back(betting_.apply(action));
+}
+
+void GameState::undo() {
+    if (undoStack_.empty()) return;
+    
+    betting_.undo(undoStack_.back());
+    undoStack_.pop_back();
+    history_.pop_back();
 }
 
 bool GameState::hasShowdown() const {
-    return isTerminal() && !folded_;
+    return isTerminal() && !hasFolded();
 }
 
 GameState GameState::afterAction(const Action& action) const {
@@ -284,33 +295,28 @@ GameState GameState::afterAction(const Action& action) const {
 }
 
 void GameState::resetStreet() {
-    // Reset investments for current street
-    oopInvested_ = 0;
-    ipInvested_ = 0;
-    currentPlayer_ = Position::OOP;
-    
-    // Clear actions from current street
-    while (!history_.empty()) {
-        history_.pop_back();
+    // Undo every action taken on the current street
+    while (canUndo()) {
+        undo();
     }
 }
 
-void GameState::advanceStreet() {
-    // Add investments to pot (they should already be there from actions)
-    oopInvested_ = 0;
-    ipInvested_ = 0;
-    currentPlayer_ = Position::OOP;
-    
-    // Don't actually change the street - that's done when cards are dealt
+void GameState::restore(const BettingState& betting,
+                        const std::vector<core::Card>& board,
+                        const std::vector<Action>& history) {
+    betting_ = betting;
+    board_ = board;
+    history_ = history;
+    undoStack_.clear();
 }
 
 std::string GameState::toString() const {
     std::stringstream ss;
-    ss << "Street: " << streetToString(street_) << "\n";
-    ss << "Pot: " << pot_ << "bb\n";
-    ss << "OOP Stack: " << oopStack_ << "bb (invested: " << oopInvested_ << ")\n";
-    ss << "IP Stack: " << ipStack_ << "bb (invested: " << ipInvested_ << ")\n";
-    ss << "To act: " << positionToString(currentPlayer_) << "\n";
+    ss << "Street: " << streetToString(betting_.street) << "\n";
+    ss << "Pot: " << betting_.pot << "bb\n";
+    ss << "OOP Stack: " << betting_.oopStack << "bb (invested: " << betting_.oopInvested << ")\n";
+    ss << "IP Stack: " << betting_.ipStack << "bb (invested: " << betting_.ipInvested << ")\n";
+    ss << "To act: " << positionToString(betting_.currentPlayer) << "\n";
     ss << "Board: ";
     for (const auto& card : board_) {
         ss << card.toString() << " ";
@@ -3,9 +3,12 @@
 #include "core/card.hpp"
 #include "core/hand.hpp"
 #include "core/range.hpp"
+#include <array>
+#include <cassert>
 #include <vector>
 #include <string>
 #include <memory>
+#include <type_traits>
 
 namespace solver {
 
@@ -58,6 +61,13 @@ struct Action {
     static Action allIn(double amount) { return {ActionType::ALL_IN, amount, 0}; }
 };
 
+// Upper bound on the actions of a single decision node
+constexpr int MAX_ACTIONS = 16;
+
+// Bet sizes per player and street a decision node has room for: an
+// unopened node offers a check and one bet per size
+constexpr int MAX_BET_SIZES = MAX_ACTIONS - 1;
+
 // Available bet sizing presets
 struct BetSizingConfig {
     // OOP bet sizes (as % of pot)
@@ -81,8 +91,83 @@ struct BetSizingConfig {
     
     // Single raised pot opening (3bb open, call from BTN)
     double initialPot = 7.0;  // 3bb + 3bb + 0.5sb + 0.5bb blinds
+    
+    // Every size list fits MAX_BET_SIZES
+    bool fits() const {
+        for (const auto* sizes : {&oopFlopBets, &oopTurnBets, &oopRiverBets,
+                                  &ipFlopBets, &ipTurnBets, &ipRiverBets}) {
+            if (sizes->size() > static_cast<size_t>(MAX_BET_SIZES)) return false;
+        }
+        return true;
+    }
 };
 
+/**
+ * Fixed-capacity list of the actions available at a decision.
+ * Lives on the stack, so listing actions never allocates.
+ */
+class ActionList {
+public:
+    // BetSizingConfig::fits() keeps every node within MAX_ACTIONS
+    void push_back(const Action& action) {
+        assert(size_ < MAX_ACTIONS);
+        if (size_ < MAX_ACTIONS) actions_[size_++] = action;
+    }
+    void clear() { size_ = 0; }
+    
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Action& operator[](int i) const { return actions_[i]; }
+    const Action* begin() const { return actions_.data(); }
+    const Action* end() const { return actions_.data() + size_; }
+    
+    std::vector<Action> toVector() const { return {begin(), end()}; }
+
+private:
+    std::array<Action, MAX_ACTIONS> actions_;
+    int size_ = 0;
+};
+
+/**
+ * Chip and turn state of a hand - the part a tree traversal mutates.
+ * Plain data of a few dozen bytes: apply() returns the previous state
+ * and undo() restores it, so walking the tree never allocates.
+ */
+struct BettingState {
+    Street street = Street::FLOP;
+    Position currentPlayer = Position::OOP;
+    Position foldedPlayer = Position::OOP;  // Who folded (if anyone)
+    bool folded = false;
+    bool streetClosed = false;  // Betting on the current street is complete
+    
+    double pot = 0;
+    double oopStack = 0;
+    double ipStack = 0;
+    double oopInvested = 0;  // Invested this street
+    double ipInvested = 0;
+    
+    // Actions for the player to act, sized from the config without copying it
+    void getAvailableActions(const BetSizingConfig& config, ActionList& out) const;
+    
+    // Apply an action; the returned snapshot undoes it
+    BettingState apply(const Action& action);
+    void undo(const BettingState& before) { *this = before; }
+    
+    // Start betting on a newly dealt street
+    void startStreet(Street next);
+    
+    // Betting on the current street is complete
+    void closeStreet();
+    
+    bool isTerminal() const;
+    bool isAllIn() const { return oopStack == 0 || ipStack == 0; }
+    bool awaitingCard() const { return streetClosed && !isTerminal(); }
+    double toCall() const;
+};
+
+static_assert(std::is_trivially_copyable_v<BettingState>);
+static_assert(std::is_trivially_copyable_v<Action>);
+
 /**
  * Represents the current state of a poker hand.
  */
@@ -106,13 +191,14 @@ public:
     void setRiver(const core::Card& card);
     
     // Accessors
-    Street currentStreet() const { return street_; }
-    Position currentPlayer() const { return currentPlayer_; }
-    double pot() const { return pot_; }
-    double oopStack() const { return oopStack_; }
-    double ipStack() const { return ipStack_; }
-    double oopInvested() const { return oopInvested_; }
-    double ipInvested() const { return ipInvested_; }
+    Street currentStreet() const { return betting_.street; }
+    Position currentPlayer() const { return betting_.currentPlayer; }
+    double pot() const { return betting_.pot; }
+    double oopStack() const { return betting_.oopStack; }
+    double ipStack() const { return betting_.ipStack; }
+    double oopInvested() const { return betting_.oopInvested; }
+    double ipInvested() const { return betting_.ipInvested; }
+    const BettingState& betting() const { return betting_; }
     const std::vector<core::Card>& board() const { return board_; }
     const core::Range& oopRange() const { return oopRange_; }
     const core::Range& ipRange() const { return ipRange_; }
@@ -120,17 +206,19 @@ public:
     const BetSizingConfig& config() const { return config_; }
     
     // Action management
-    std::vector<Action> getAvailableActions() const;
+    ActionList getAvailableActions() const;
     void applyAction(const Action& action);
-    bool canUndo() const { return !history_.empty(); }
-    void undo();
+    bool canUndo() const { return !undoStack_.empty(); }
+    void undo();  // Undo the last action on the current street
     
     // State queries
-    bool isTerminal() const;
-    bool isAllIn() const;
+    bool isTerminal() const { return betting_.isTerminal(); }
+    bool isAllIn() const { return betting_.isAllIn(); }
     bool hasShowdown() const;
-    double getToCall() const;  // Amount to call for current player
-    Position foldedPlayer() const { return foldedPlayer_; }  // Who folded (if anyone)
+    bool hasFolded() const { return betting_.folded; }
+    bool awaitingCard() const { return betting_.awaitingCard(); }  // Betting round closed, next board card not dealt yet
+    double getToCall() const { return betting_.toCall(); }  // Amount to call for current player
+    Position foldedPlayer() const { return betting_.foldedPlayer; }  // Who folded (if anyone)
     
     // Create a copy with a specific action applied
     GameState afterAction(const Action& action) const;
@@ -138,20 +226,17 @@ public:
     // Reset to start of current street
     void resetStreet();
     
+    // Restore a saved position (checkpoints); its actions cannot be undone
+    void restore(const BettingState& betting,
+                 const std::vector<core::Card>& board,
+                 const std::vector<Action>& history);
+    
     // Get string representation
     std::string toString() const;
 
 private:
     BetSizingConfig config_;
-    
-    Street street_ = Street::FLOP;
-    Position currentPlayer_ = Position::OOP;
-    
-    double pot_ = 0;
-    double oopStack_ = 0;
-    double ipStack_ = 0;
-    double oopInvested_ = 0;  // Invested this street
-    double ipInvested_ = 0;
+    BettingState betting_;
     
     std::vector<core::Card> board_;
     core::Range oopRange_;
@@ -160,12 +245,10 @@ private:
     core::Hand ipHand_;
     
     std::vector<Action> history_;
+    std::vector<BettingState> undoStack_;  // Betting state before each action this street
     
-    bool folded_ = false;
-    Position foldedPlayer_;
-    
-    void advanceStreet();
-    double effectiveStack() const;
+    // Begin betting on a newly dealt street
+    void dealStreet(Street street);
 };
 
 // Convert enums to strings
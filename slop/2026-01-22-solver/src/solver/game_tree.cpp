@@ -1,226 +1,589 @@
 #include "game_tree.hpp"
-#include "ompeval/hand_evaluator.hpp"
+#include "abstraction.hpp"
 #include <algorithm>
-#include <sstream>
-#include <numeric>
+#include <cmath>
+#include <map>
 
 namespace solver {
 
-// InfoSet implementation
+GameTree::GameTree() {}
+
+void GameTree::build(const GameState& initialState,
+                     const core::Range& oopRange,
+                     const core::Range& ipRange,
+                     StorageMode mode,
+                     const DepthLimit& limit,
+                     const BucketMap* buckets) {
+    mode_ = mode;
+    limit_ = limit;
+    limit_.continuations = std::max(1, limit.continuations);
+    nodes_.clear();
+    actions_.clear();
+    cuts_.clear();
+    maxDepth_ = 0;
+
+    rootBoard_ = initialState.board();
+    rootHistoryLength_ = initialState.actionHistory().size();
 
-InfoSet::InfoSet(Position player, const std::string& key)
-    : player_(player), key_(key) {}
+    // Chips already in the pot that are not part of a live bet are split evenly
+    double deadMoney = initialState.pot() - initialState.oopInvested() - initialState.ipInvested();
+    oopRootCommitted_ = deadMoney / 2 + initialState.oopInvested();
+    oopRootStack_ = initialState.oopStack();
 
-void InfoSet::setStrategy(const std::vector<double>& strategy) {
-    strategy_ = strategy;
+    // A bucket map only covers the root street's boards: streets below it
+    // group by canonical name
+    for (int level = 0; level < 3; ++level) {
+        const BucketMap* levelBuckets = level == 0 ? buckets : nullptr;
+        slots_[level][static_cast<int>(Position::OOP)] = buildSlots(oopRange, rootBoard_, levelBuckets);
+        slots_[level][static_cast<int>(Position::IP)] = buildSlots(ipRange, rootBoard_, levelBuckets);
+    }
+
+    BettingState state = initialState.betting();
+    addNode(state, initialState.config(), -1, 0, Action::check());
+    expand(0, state, initialState.config(), 0);
+
+    // Lay out one regret/strategy block per (decision node, hand slot) within
+    // each level; every runout of a level gets storage of that size
+    levelSize_.fill(0);
+    levelInfoSets_.fill(0);
+    numLevels_ = 1;
+    for (auto& node : nodes_) {
+        numLevels_ = std::max(numLevels_, node.level + 1);
+        if (node.type != NodeType::PLAYER) continue;
+        int numSlots = slots(node.player, node.level).size();
+        node.offset = levelSize_[node.level];
+        node.infoSet = levelInfoSets_[node.level];
+        levelSize_[node.level] += static_cast<size_t>(numSlots) * node.numActions;
+        levelInfoSets_[node.level] += numSlots;
+    }
+    clearInfoSets();
 }
 
-void InfoSet::setNumActions(int n) {
-    regrets_.resize(n, 0.0);
-    strategy_.resize(n, 1.0 / n);  // Uniform initial strategy
-    strategySum_.resize(n, 0.0);
+int GameTree::addNode(const BettingState& state, const BetSizingConfig& config,
+                      int parent, int level, const Action& action) {
+    TreeNode node;
+    node.parent = parent;
+    node.street = state.street;
+    node.level = level;
+    node.pot = state.pot;
+    node.oopStack = state.oopStack;
+    node.ipStack = state.ipStack;
+
+    ActionList actions;
+    state.getAvailableActions(config, actions);
+
+    if (!actions.empty()) {
+        node.type = NodeType::PLAYER;
+        node.player = state.currentPlayer;
+    } else if (!state.folded && state.street != Street::RIVER && state.street < limit_.lastStreet) {
+        // Street closed (or all-in) before the river: deal the next card
+        node.type = NodeType::CHANCE;
+    } else {
+        node.type = NodeType::TERMINAL;
+
+        // Net results relative to what each player had before the root
+        double oopCommitted = oopRootCommitted_ + (oopRootStack_ - state.oopStack);
+        double lose = -oopCommitted;
+        double win = state.pot - oopCommitted;
+        if (state.folded) {
+            double result = (state.foldedPlayer == Position::IP) ? win : lose;
+            std::fill(std::begin(node.payoff), std::end(node.payoff), result);
+        } else if (state.street != Street::RIVER) {
+            // Depth limit: the estimator adds what OOP gets back
+            std::fill(std::begin(node.payoff), std::end(node.payoff), lose);
+            node.cut = static_cast<int>(cuts_.size());
+            cuts_.push_back(static_cast<int>(nodes_.size()));
+        } else {
+            node.showdown = true;
+            node.payoff[0] = lose;
+            node.payoff[1] = state.pot / 2 - oopCommitted;
+            node.payoff[2] = win;
+        }
+    }
+
+    nodes_.push_back(node);
+    actions_.push_back(action);
+    return static_cast<int>(nodes_.size()) - 1;
 }
 
-std::vector<double> InfoSet::getAverageStrategy() const {
-    if (strategySum_.empty()) return strategy_;
-    
-    double sum = std::accumulate(strategySum_.begin(), strategySum_.end(), 0.0);
-    
-    if (sum <= 0) {
-        // Return uniform if no accumulated strategy
-        std::vector<double> uniform(strategy_.size(), 1.0 / strategy_.size());
-        return uniform;
+void GameTree::expand(int index, BettingState& state, const BetSizingConfig& config, int depth) {
+    maxDepth_ = std::max(maxDepth_, depth);
+    if (nodes_[index].isEstimated() && limit_.continuations > 1) {
+        expandCut(index, depth);
+        return;
+    }
+    if (nodes_[index].isLeaf()) return;
+
+    int level = nodes_[index].level;
+
+    if (nodes_[index].type == NodeType::CHANCE) {
+        // One subtree for the next street, whatever card is dealt
+        BettingState before = state;
+        state.startStreet(static_cast<Street>(static_cast<int>(state.street) + 1));
+        int child = addNode(state, config, index, level + 1, Action::check());
+        nodes_[index].firstChild = child;
+        nodes_[index].numActions = 1;
+        expand(child, state, config, depth + 1);
+        state.undo(before);
+        return;
+    }
+
+    ActionList actions;
+    state.getAvailableActions(config, actions);
+
+    // Children are appended as one contiguous block before any grandchild
+    int first = static_cast<int>(nodes_.size());
+    nodes_[index].firstChild = first;
+    nodes_[index].numActions = actions.size();
+
+    for (const auto& action : actions) {
+        BettingState before = state.apply(action);
+        addNode(state, config, index, level, action);
+        state.undo(before);
+    }
+
+    for (int a = 0; a < actions.size(); ++a) {
+        BettingState before = state.apply(actions[a]);
+        expand(first + a, state, config, depth + 1);
+        state.undo(before);
+    }
+}
+
+void GameTree::expandCut(int index, int depth) {
+    int numChoices = limit_.continuations;
+    TreeNode leaf = nodes_[index];
+    Action choice = Action::check();  // Placeholder: the choices are not betting actions
+
+    // OOP picks its continuation, then IP; the leaves carry the pair
+    int first = static_cast<int>(nodes_.size());
+    TreeNode& oopChoice = nodes_[index];
+    oopChoice.type = NodeType::PLAYER;
+    oopChoice.player = Position::OOP;
+    oopChoice.numActions = numChoices;
+    oopChoice.firstChild = first;
+
+    for (int k = 0; k < numChoices; ++k) {
+        TreeNode ipChoice = leaf;
+        ipChoice.type = NodeType::PLAYER;
+        ipChoice.player = Position::IP;
+        ipChoice.parent = index;
+        ipChoice.numActions = numChoices;
+        nodes_.push_back(ipChoice);
+        actions_.push_back(choice);
     }
-    
-    std::vector<double> avgStrategy(strategySum_.size());
-    for (size_t i = 0; i < strategySum_.size(); ++i) {
-        avgStrategy[i] = strategySum_[i] / sum;
+    for (int k = 0; k < numChoices; ++k) {
+        int ipIndex = first + k;
+        nodes_[ipIndex].firstChild = static_cast<int>(nodes_.size());
+        for (int j = 0; j < numChoices; ++j) {
+            TreeNode estimated = leaf;
+            estimated.parent = ipIndex;
+            estimated.continuation = k * numChoices + j;
+            nodes_.push_back(estimated);
+            actions_.push_back(choice);
+        }
     }
-    
-    return avgStrategy;
+    maxDepth_ = std::max(maxDepth_, depth + 2);
 }
 
-void InfoSet::addRegret(int actionIndex, double regret) {
-    if (actionIndex >= 0 && actionIndex < static_cast<int>(regrets_.size())) {
-        regrets_[actionIndex] += regret;
+HandSlots GameTree::buildSlots(const core::Range& range,
+                               const std::vector<core::Card>& board,
+                               const BucketMap* buckets) const {
+    HandSlots out;
+    out.comboToSlot.assign(core::NUM_COMBOS, -1);
+    if (buckets && !buckets->contains(board)) buckets = nullptr;
+
+    std::map<std::string, int> slotByName;
+    std::map<int, int> slotByBucket;
+    for (const auto& [hand, weight] : range.getAvailableHands(board)) {
+        if (weight <= 0) continue;
+
+        // Group by bucket, or by canonical name: suits are not part of the info set
+        int slot = out.size();
+        if (buckets) {
+            slot = slotByBucket.emplace(buckets->bucket(board, hand), slot).first->second;
+        } else {
+            slot = slotByName.emplace(hand.canonicalName(), slot).first->second;
+        }
+        if (slot == out.size()) {
+            out.representatives.push_back(hand);
+        }
+        out.comboToSlot[hand.comboIndex()] = slot;
     }
+    return out;
 }
 
-void InfoSet::updateStrategy() {
-    // Regret matching: strategy proportional to positive regrets
-    std::vector<double> positiveRegrets(regrets_.size());
+int GameTree::findNode(const GameState& state, int& runout) const {
+    runout = 0;
+    if (nodes_.empty()) return -1;
+
+    const auto& board = state.board();
+    if (board.size() < rootBoard_.size() ||
+        !std::equal(rootBoard_.begin(), rootBoard_.end(), board.begin())) {
+        return -1;
+    }
+
+    const auto& history = state.actionHistory();
+    if (history.size() < rootHistoryLength_) return -1;
+
+    int index = 0;
+    size_t dealt = rootBoard_.size();
+
+    // Step through a chance node using the state's next board card
+    auto deal = [&]() {
+        if (dealt >= board.size()) return false;
+        runout = nextRunout(runout, board[dealt++].value());
+        index = nodes_[index].firstChild;
+        return true;
+    };
+
+    for (size_t i = rootHistoryLength_; i < history.size(); ++i) {
+        while (nodes_[index].type == NodeType::CHANCE) {
+            if (!deal()) return -1;
+        }
+
+        const TreeNode& node = nodes_[index];
+        int next = -1;
+        for (int a = 0; a < node.numActions; ++a) {
+            const Action& action = actions_[node.firstChild + a];
+            if (action.type == history[i].type &&
+                std::abs(action.amount - history[i].amount) < 1e-9) {
+                next = node.firstChild + a;
+                break;
+            }
+        }
+        if (next < 0) return -1;
+        index = next;
+    }
+
+    // Cards dealt after the last action
+    while (nodes_[index].type == NodeType::CHANCE && dealt < board.size()) {
+        deal();
+    }
+    return (dealt == board.size()) ? index : -1;
+}
+
+void GameTree::loadRegrets(const TreeNode& node, int runout, int slot, double* out) const {
+    const RunoutStorage* storage = runoutStorage(runout);
+    if (!storage) {
+        std::fill(out, out + node.numActions, 0.0);
+        return;
+    }
+
+    size_t offset = blockOffset(node, slot);
+    if (mode_ == StorageMode::COMPACT) {
+        const int32_t* regret = storage->compactRegrets.data() + offset;
+        double unit = std::ldexp(1.0 / REGRET_UNITS, storage->compactRegretShift[node.infoSet + slot]);
+        for (int a = 0; a < node.numActions; ++a) {
+            out[a] = regret[a] * unit;
+        }
+    } else {
+        std::copy_n(storage->regrets.data() + offset, node.numActions, out);
+    }
+}
+
+// Round half away from zero; truncation would bias regrets toward zero
+static int32_t roundRegret(double units) {
+    return static_cast<int32_t>(units + std::copysign(0.5, units));
+}
+
+void GameTree::addRegrets(const TreeNode& node, int runout, int slot, const double* delta) {
+    RunoutStorage& storage = allocate(runout, node.level);
+    size_t offset = blockOffset(node, slot);
+
+    if (mode_ == StorageMode::COMPACT) {
+        // Like strategy sums, an info set whose regrets would overflow is
+        // halved and its shift raised. Regret matching only depends on their
+        // ratios, so the info set plays on as before with less resolution.
+        int32_t* regret = storage.compactRegrets.data() + offset;
+        uint8_t& shift = storage.compactRegretShift[node.infoSet + slot];
+        double unit = std::ldexp(REGRET_UNITS, -shift);
+        double updated[MAX_ACTIONS];
+        double peak = 0;
+        for (int a = 0; a < node.numActions; ++a) {
+            updated[a] = std::max(regret[a] / unit + delta[a], REGRET_FLOOR) * unit;
+            peak = std::max(peak, std::abs(updated[a]));
+        }
+        while (peak >= INT32_MAX && shift < UINT8_MAX) {
+            for (int a = 0; a < node.numActions; ++a) {
+                updated[a] *= 0.5;
+            }
+            peak *= 0.5;
+            ++shift;
+        }
+        for (int a = 0; a < node.numActions; ++a) {
+            regret[a] = roundRegret(std::min<double>(updated[a], INT32_MAX - 1));
+        }
+    } else {
+        double* regret = storage.regrets.data() + offset;
+        for (int a = 0; a < node.numActions; ++a) {
+            regret[a] += delta[a];
+        }
+    }
+}
+
+void GameTree::addStrategy(const TreeNode& node, int runout, int slot, const double* amounts,
+                           int iteration) {
+    RunoutStorage& storage = allocate(runout, node.level);
+    size_t offset = blockOffset(node, slot);
+
+    if (mode_ != StorageMode::COMPACT) {
+        double* sum = storage.strategySum.data() + offset;
+        for (int a = 0; a < node.numActions; ++a) {
+            sum[a] += amounts[a];
+        }
+        return;
+    }
+
+    // Sums are integers in units of 2^shift / 256 of a weighted contribution.
+    // When one would overflow, the info set's sums are halved and its shift
+    // raised, so earlier and later contributions keep their relative weight
+    // and the sums stay a true average. Rounding is dithered by a hash of the
+    // info set and the iteration, so fractions of a unit are kept on average
+    // instead of always rounding away.
+    uint16_t* sum = storage.compactStrategySum.data() + offset;
+    uint8_t& shift = storage.compactSumShift[node.infoSet + slot];
+    double unit = std::ldexp(strategyWeight_ * 256.0, -shift);
+    double updated[MAX_ACTIONS];
+    double peak = 0;
+    for (int a = 0; a < node.numActions; ++a) {
+        updated[a] = sum[a] + amounts[a] * unit;
+        peak = std::max(peak, updated[a]);
+    }
+    while (peak >= UINT16_MAX && shift < UINT8_MAX) {
+        for (int a = 0; a < node.numActions; ++a) {
+            updated[a] *= 0.5;
+        }
+        peak *= 0.5;
+        ++shift;
+    }
+
+    uint64_t dither = (static_cast<uint64_t>(iteration) * MAX_RUNOUTS + runout) * 0x9e3779b97f4a7c15ull + offset;
+    for (int a = 0; a < node.numActions; ++a) {
+        dither ^= dither >> 31;
+        dither *= 0xbf58476d1ce4e5b9ull;
+        double threshold = static_cast<double>(dither >> 11) * 0x1.0p-53;
+        sum[a] = static_cast<uint16_t>(std::min<double>(std::floor(updated[a] + threshold), UINT16_MAX));
+    }
+}
+
+void GameTree::discount(double positive, double negative, double strategy) {
+    for (int runout = 0; runouts_ && runout < MAX_RUNOUTS; ++runout) {
+        RunoutStorage* storage = runoutStorage(runout);
+        if (!storage) continue;
+
+        for (auto& regret : storage->regrets) {
+            regret *= (regret > 0) ? positive : negative;
+        }
+        for (auto& regret : storage->compactRegrets) {
+            regret = roundRegret(regret * ((regret > 0) ? positive : negative));
+        }
+        for (auto& sum : storage->strategySum) {
+            sum *= strategy;
+        }
+    }
+
+    // Compact sums only matter relative to each other within an info set
+    if (strategy > 0) strategyWeight_ /= strategy;
+}
+
+void GameTree::regretMatching(const double* regrets, int numActions, double* out) {
+    // Strategy proportional to positive regrets
     double regretSum = 0;
-    
-    for (size_t i = 0; i < regrets_.size(); ++i) {
-        positiveRegrets[i] = std::max(0.0, regrets_[i]);
-        regretSum += positiveRegrets[i];
+    for (int a = 0; a < numActions; ++a) {
+        out[a] = std::max(0.0, regrets[a]);
+        regretSum += out[a];
     }
-    
+
     if (regretSum > 0) {
-        for (size_t i = 0; i < strategy_.size(); ++i) {
-            strategy_[i] = positiveRegrets[i] / regretSum;
+        for (int a = 0; a < numActions; ++a) {
+            out[a] /= regretSum;
         }
     } else {
         // Uniform strategy if all regrets are non-positive
-        double uniform = 1.0 / strategy_.size();
-        std::fill(strategy_.begin(), strategy_.end(), uniform);
+        std::fill(out, out + numActions, 1.0 / numActions);
     }
 }
 
-void InfoSet::accumulateStrategy(const std::vector<double>& reachProb) {
-    if (reachProb.empty()) {
-        for (size_t i = 0; i < strategy_.size(); ++i) {
-            strategySum_[i] += strategy_[i];
+void GameTree::currentStrategy(const TreeNode& node, int runout, int slot, double* out) const {
+    double regrets[MAX_ACTIONS];
+    loadRegrets(node, runout, slot, regrets);
+    regretMatching(regrets, node.numActions, out);
+}
+
+void GameTree::averageStrategy(const TreeNode& node, int runout, int slot, double* out) const {
+    const RunoutStorage* storage = runoutStorage(runout);
+    double sum[MAX_ACTIONS] = {};
+    double total = 0;
+    if (storage) {
+        size_t offset = blockOffset(node, slot);
+        for (int a = 0; a < node.numActions; ++a) {
+            sum[a] = (mode_ == StorageMode::COMPACT) ? storage->compactStrategySum[offset + a]
+                                                     : storage->strategySum[offset + a];
+            total += sum[a];
         }
-    } else {
-        double reach = (player_ == Position::OOP) ? reachProb[0] : reachProb[1];
-        for (size_t i = 0; i < strategy_.size(); ++i) {
-            strategySum_[i] += reach * strategy_[i];
+    }
+
+    if (total > 0) {
+        for (int a = 0; a < node.numActions; ++a) {
+            out[a] = sum[a] / total;
         }
-        reachProbSum_ += reach;
+    } else {
+        // Return uniform if no accumulated strategy
+        std::fill(out, out + node.numActions, 1.0 / node.numActions);
     }
 }
 
-// GameTreeNode implementation
+// Fold, passive (check/call) and aggressive actions are matched only within their kind
+static int actionKind(ActionType type) {
+    switch (type) {
+        case ActionType::FOLD: return 0;
+        case ActionType::CHECK:
+        case ActionType::CALL: return 1;
+        default: return 2;
+    }
+}
 
-GameTreeNode::GameTreeNode(NodeType type, const GameState& state)
-    : type_(type), state_(state) {}
+bool GameTree::warmStart(const GameTree& previous) {
+    if (previous.empty() || empty() || previous.mode_ != mode_) return false;
+    for (int level = 0; level < 3; ++level) {
+        for (int player = 0; player < 2; ++player) {
+            if (previous.slots_[level][player].comboToSlot != slots_[level][player].comboToSlot) return false;
+        }
+    }
 
-void GameTreeNode::addChild(const Action& action, std::shared_ptr<GameTreeNode> child) {
-    actions_.push_back(action);
-    children_.push_back(child);
+    seedNode(previous, 0, 0, true);
+    strategyWeight_ = previous.strategyWeight_;
+    return true;
 }
 
-std::shared_ptr<GameTreeNode> GameTreeNode::getChild(int actionIndex) const {
-    if (actionIndex >= 0 && actionIndex < static_cast<int>(children_.size())) {
-        return children_[actionIndex];
+void GameTree::seedNode(const GameTree& previous, int index, int oldIndex, bool exactPath) {
+    const TreeNode& node = nodes_[index];
+    const TreeNode& old = previous.nodes_[oldIndex];
+    if (node.type != old.type || node.isLeaf()) return;
+
+    if (node.type == NodeType::CHANCE) {
+        seedNode(previous, node.firstChild, old.firstChild, exactPath);
+        return;
     }
-    return nullptr;
-}
+    if (node.player != old.player) return;
 
-double GameTreeNode::getPayoff(Position player, const core::Hand& oopHand,
-                                const core::Hand& ipHand) const {
-    // Calculate payoff at terminal node
-    const auto& evaluator = ompeval::HandEvaluator::instance();
-    
-    // Build full hand for each player
-    std::vector<int> oopCards = {
-        oopHand.card1().value(), oopHand.card2().value()
-    };
-    std::vector<int> ipCards = {
-        ipHand.card1().value(), ipHand.card2().value()
-    };
-    
-    for (const auto& card : state_.board()) {
-        oopCards.push_back(card.value());
-        ipCards.push_back(card.value());
-    }
-    
-    // Evaluate hands
-    auto oopEval = evaluator.evaluate(oopCards);
-    auto ipEval = evaluator.evaluate(ipCards);
-    
-    // Calculate net payoff: winner gets pot minus their investment
-    // Pot = oopInvested + ipInvested
-    // If OOP wins: they get the pot, net = pot - oopInvested = ipInvested
-    // If IP wins: OOP loses their investment, net = -oopInvested
-    double oopPayoff = 0;
-    
-    if (oopEval > ipEval) {
-        // OOP wins: gets pot minus their investment
-        oopPayoff = state_.pot() - state_.oopInvested();
-    } else if (ipEval > oopEval) {
-        // IP wins: OOP loses their investment
-        oopPayoff = -state_.oopInvested();
-    }
-    // Tie: split pot, each gets their investment back (net = 0)
-    
-    return (player == Position::OOP) ? oopPayoff : -oopPayoff;
-}
-
-void GameTreeNode::setChanceOutcomes(const std::vector<std::pair<core::Card, double>>& outcomes) {
-    chanceOutcomes_ = outcomes;
-}
-
-// GameTree implementation
+    // Old action each new action takes its values from: the same action
+    // if it still exists, else the nearest one of the same kind
+    int source[MAX_ACTIONS];
+    bool exact[MAX_ACTIONS];
+    for (int a = 0; a < node.numActions; ++a) {
+        const Action& action = actions_[node.firstChild + a];
+        source[a] = -1;
+        exact[a] = false;
+        double bestDistance = 0;
+        for (int b = 0; b < old.numActions; ++b) {
+            const Action& candidate = previous.actions_[old.firstChild + b];
+            if (actionKind(candidate.type) != actionKind(action.type)) continue;
 
-GameTree::GameTree() {}
+            double distance = std::abs(candidate.amount - action.amount);
+            if (candidate.type == action.type && distance < 1e-9) {
+                source[a] = b;
+                exact[a] = true;
+                break;
+            }
+            if (source[a] < 0 || distance < bestDistance) {
+                source[a] = b;
+                bestDistance = distance;
+            }
+        }
+    }
 
-void GameTree::build(const GameState& initialState,
-                     const core::Range& oopRange,
-                     const core::Range& ipRange) {
-    clearInfoSets();
-    nodeCount_ = 0;
-    root_ = buildNode(initialState);
-}
-
-std::shared_ptr<GameTreeNode> GameTree::buildNode(const GameState& state) {
-    ++nodeCount_;
-    
-    if (state.isTerminal()) {
-        return std::make_shared<GameTreeNode>(NodeType::TERMINAL, state);
-    }
-    
-    auto node = std::make_shared<GameTreeNode>(NodeType::PLAYER, state);
-    
-    // Get available actions
-    auto actions = state.getAvailableActions();
-    
-    // Build child nodes for each action
-    for (const auto& action : actions) {
-        auto childState = state.afterAction(action);
-        auto childNode = buildNode(childState);
-        node->addChild(action, childNode);
+    // Every runout the previous solve reached on this level
+    int numSlots = slots(node.player, node.level).size();
+    for (int runout = 0; runout < MAX_RUNOUTS; ++runout) {
+        const RunoutStorage* from = previous.runoutStorage(runout);
+        if (!from || runoutLevel(runout) != node.level) continue;
+        RunoutStorage& to = allocate(runout, node.level);
+
+        for (int slot = 0; slot < numSlots; ++slot) {
+            size_t oldBlock = blockOffset(old, slot);
+            size_t newBlock = blockOffset(node, slot);
+            for (int a = 0; a < node.numActions; ++a) {
+                if (source[a] < 0) continue;
+                size_t src = oldBlock + source[a];
+                size_t dst = newBlock + a;
+
+                // Strategy sums are kept only where the path is unchanged
+                bool keepSum = exactPath && exact[a];
+                if (mode_ == StorageMode::COMPACT) {
+                    to.compactRegrets[dst] = from->compactRegrets[src];
+                    to.compactRegretShift[node.infoSet + slot] = from->compactRegretShift[old.infoSet + slot];
+                    if (keepSum) {
+                        to.compactStrategySum[dst] = from->compactStrategySum[src];
+                        to.compactSumShift[node.infoSet + slot] = from->compactSumShift[old.infoSet + slot];
+                    }
+                } else {
+                    to.regrets[dst] = from->regrets[src];
+                    if (keepSum) to.strategySum[dst] = from->strategySum[src];
+                }
+            }
+        }
+    }
+
+    for (int a = 0; a < node.numActions; ++a) {
+        if (source[a] < 0) continue;
+        seedNode(previous, node.firstChild + a, old.firstChild + source[a], exactPath && exact[a]);
     }
-    
-    return node;
 }
 
-std::shared_ptr<InfoSet> GameTree::getOrCreateInfoSet(Position player,
-                                                       const std::string& key,
-                                                       int numActions) {
-    auto it = infoSets_.find(key);
-    if (it != infoSets_.end()) {
-        return it->second;
+RunoutStorage& GameTree::allocateSlow(int runout, int level) {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+
+    // Another thread may have allocated it while we waited
+    RunoutStorage* storage = runouts_[runout].load(std::memory_order_acquire);
+    if (storage) return *storage;
+
+    auto created = std::make_unique<RunoutStorage>();
+    if (mode_ == StorageMode::COMPACT) {
+        created->compactRegrets.assign(levelSize_[level], 0);
+        created->compactStrategySum.assign(levelSize_[level], 0);
+        created->compactRegretShift.assign(levelInfoSets_[level], 0);
+        created->compactSumShift.assign(levelInfoSets_[level], 0);
+    } else {
+        created->regrets.assign(levelSize_[level], 0.0);
+        created->strategySum.assign(levelSize_[level], 0.0);
     }
-    
-    auto infoSet = std::make_shared<InfoSet>(player, key);
-    infoSet->setNumActions(numActions);
-    infoSets_[key] = infoSet;
-    return infoSet;
+    storage = created.get();
+    owned_.push_back(std::move(created));
+    runouts_[runout].store(storage, std::memory_order_release);
+    return *storage;
 }
 
 void GameTree::clearInfoSets() {
-    infoSets_.clear();
-}
-
-std::string GameTree::generateInfoSetKey(Position player,
-                                          const core::Hand& hand,
-                                          const GameState& state) const {
-    std::stringstream ss;
-    
-    // Player position
-    ss << (player == Position::OOP ? "O" : "I") << ":";
-    
-    // Hand (canonical form)
-    ss << hand.canonicalName() << ":";
-    
-    // Board
-    for (const auto& card : state.board()) {
-        ss << card.toString();
-    }
-    ss << ":";
-    
-    // Action history
-    for (const auto& action : state.actionHistory()) {
-        ss << static_cast<int>(action.type);
-        if (action.type == ActionType::BET || action.type == ActionType::RAISE) {
-            ss << static_cast<int>(action.potFraction * 100);
-        }
-        ss << ",";
-    }
-    
-    return ss.str();
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    runouts_ = std::make_unique<std::atomic<RunoutStorage*>[]>(MAX_RUNOUTS);
+    owned_.clear();
+    strategyWeight_ = 1.0;
+}
+
+size_t GameTree::numInfoSets() const {
+    size_t count = 0;
+    for (int runout = 0; runouts_ && runout < MAX_RUNOUTS; ++runout) {
+        if (runoutStorage(runout)) count += levelInfoSets_[runoutLevel(runout)];
+    }
+    return count;
+}
+
+size_t GameTree::numRunouts() const {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    return owned_.size();
+}
+
+size_t GameTree::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(allocMutex_);
+    size_t bytes = 0;
+    for (const auto& storage : owned_) {
+        bytes += (storage->regrets.size() + storage->strategySum.size()) * sizeof(double) +
+                 storage->compactRegrets.size() * sizeof(int32_t) +
+                 storage->compactStrategySum.size() * sizeof(uint16_t) +
+                 storage->compactRegretShift.size() + storage->compactSumShift.size();
+    }
+    return bytes;
 }
 
 } // namespace solver
@@ -2,17 +2,18 @@
 
 #include "game_state.hpp"
 #include "core/hand.hpp"
-#include <vector>
-#include <memory>
-#include <unordered_map>
-#include <string>
+#include "core/range.hpp"
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace solver {
 
-// Forward declarations
-class GameTreeNode;
-class InfoSet;
+class BucketMap;
 
 /**
  * Types of game tree nodes
@@ -24,130 +25,287 @@ enum class NodeType {
 };
 
 /**
- * Information set - groups of game states that look the same to a player.
- * In poker, this is defined by: player's hand + public board + action history
+ * A node of the flat betting tree.
+ * Children occupy the contiguous index range [firstChild, firstChild + numActions)
+ * in the order of the parent's actions, so traversals walk the tree by index.
+ *
+ * The betting that follows a dealt card does not depend on the card, so a
+ * chance node has a single child: the next street's subtree, shared by every
+ * runout. Card-dependent data lives in per-runout storage instead.
  */
-class InfoSet {
-public:
-    InfoSet(Position player, const std::string& key);
-    
-    // Get/set strategy (action probabilities)
-    const std::vector<double>& getStrategy() const { return strategy_; }
-    void setStrategy(const std::vector<double>& strategy);
-    
-    // Get average strategy (for final result)
-    std::vector<double> getAverageStrategy() const;
-    
-    // Regret matching: update regrets and compute new strategy
-    void addRegret(int actionIndex, double regret);
-    void updateStrategy();
-    
-    // For strategy accumulation
-    void accumulateStrategy(const std::vector<double>& reachProb);
-    
-    // Info set key
-    const std::string& key() const { return key_; }
-    Position player() const { return player_; }
-    
-    // Number of actions available
-    int numActions() const { return static_cast<int>(strategy_.size()); }
-    void setNumActions(int n);
-    
-private:
-    Position player_;
-    std::string key_;
-    
-    std::vector<double> regrets_;           // Cumulative regrets
-    std::vector<double> strategy_;          // Current strategy
-    std::vector<double> strategySum_;       // Sum of strategies for averaging
-    double reachProbSum_ = 0;               // Sum of reach probabilities
+struct TreeNode {
+    NodeType type = NodeType::TERMINAL;
+    Position player = Position::OOP;  // Player to act (PLAYER nodes)
+    Street street = Street::FLOP;
+    int level = 0;       // Board cards dealt below the root
+    int numActions = 0;  // Children (1 for CHANCE nodes)
+    int parent = -1;
+    int firstChild = -1;
+
+    // Chip state on arrival at the node
+    double pot = 0;
+    double oopStack = 0;
+    double ipStack = 0;
+
+    // Offset of the node's regret/strategy block in its level's runout storage
+    // (PLAYER nodes). The block holds numActions values per hand slot of the
+    // acting player.
+    size_t offset = 0;
+    size_t infoSet = 0;  // Index of the node's first info set on its level (PLAYER nodes)
+
+    // OOP's net result at a leaf, indexed by showdown result + 1
+    // (lose, split, win). All three are equal after a fold.
+    double payoff[3] = {0, 0, 0};
+    bool showdown = false;  // Leaf reached without a fold
+
+    // Depth limit: cut point (index into GameTree::cutPoints()) of nodes at
+    // or below one, -1 elsewhere. A leaf below a cut holds OOP's chips in
+    // the pot as its payoff and is valued by a LeafEstimator, with the
+    // continuation strategies picked on the way (oop * continuations + ip).
+    int cut = -1;
+    int continuation = 0;
+
+    bool isLeaf() const { return type == NodeType::TERMINAL; }
+    bool isEstimated() const { return isLeaf() && cut >= 0; }
+    double oopPayoff(int showdownResult) const { return payoff[showdownResult + 1]; }
 };
 
 /**
- * A node in the game tree.
+ * Maps the combos of one player's range to info set slots on one level.
+ * Combos of the same canonical hand type share a slot, or on the root
+ * street with a card abstraction (BucketMap), combos in the same bucket.
  */
-class GameTreeNode {
-public:
-    GameTreeNode(NodeType type, const GameState& state);
-    
-    NodeType type() const { return type_; }
-    const GameState& state() const { return state_; }
-    GameState& state() { return state_; }
-    
-    // For player nodes
-    void setInfoSet(std::shared_ptr<InfoSet> infoSet) { infoSet_ = infoSet; }
-    std::shared_ptr<InfoSet> getInfoSet() const { return infoSet_; }
-    
-    // Child nodes (indexed by action)
-    void addChild(const Action& action, std::shared_ptr<GameTreeNode> child);
-    std::shared_ptr<GameTreeNode> getChild(int actionIndex) const;
-    const std::vector<Action>& getActions() const { return actions_; }
-    int numChildren() const { return static_cast<int>(children_.size()); }
-    
-    // For terminal nodes
-    double getPayoff(Position player, const core::Hand& oopHand, 
-                     const core::Hand& ipHand) const;
-    
-    // For chance nodes
-    void setChanceOutcomes(const std::vector<std::pair<core::Card, double>>& outcomes);
-    const std::vector<std::pair<core::Card, double>>& getChanceOutcomes() const { return chanceOutcomes_; }
+struct HandSlots {
+    std::vector<int> comboToSlot;             // core::Hand::comboIndex() -> slot, -1 if not in range
+    std::vector<core::Hand> representatives;  // One hand per slot
 
-private:
-    NodeType type_;
-    GameState state_;
-    std::shared_ptr<InfoSet> infoSet_;
-    
-    std::vector<Action> actions_;
-    std::vector<std::shared_ptr<GameTreeNode>> children_;
+    int size() const { return static_cast<int>(representatives.size()); }
+    int slotOf(const core::Hand& hand) const { return comboToSlot[hand.comboIndex()]; }
+};
+
+/**
+ * Where the tree stops. Streets after lastStreet are not built: closing
+ * lastStreet's betting ends in a leaf whose value is estimated. With more
+ * than one continuation strategy, OOP and then IP first pick the one they
+ * play for the rest of the hand (multi-valued states).
+ */
+struct DepthLimit {
+    Street lastStreet = Street::RIVER;
+    int continuations = 1;
+};
+
+/**
+ * How regrets and strategy sums are stored
+ */
+enum class StorageMode {
+    DOUBLE,   // 8 bytes per regret and per strategy sum
+    COMPACT   // int32 regrets, uint16 strategy sums (6 bytes per action instead of 16)
+};
+
+/**
+ * Regrets and strategy sums of every decision node on one level of the
+ * tree, for one runout (the public cards dealt below the root).
+ * Only the vectors of the tree's storage mode are allocated.
+ */
+struct RunoutStorage {
+    std::vector<double> regrets;
+    std::vector<double> strategySum;
     
-    // For chance nodes (card, probability)
-    std::vector<std::pair<core::Card, double>> chanceOutcomes_;
+    // COMPACT: regrets in fixed point, clamped to REGRET_FLOOR; regrets and
+    // strategy sums in units of 2^shift, each shift kept per info set and
+    // raised (halving the info set's values) whenever one would overflow
+    std::vector<int32_t> compactRegrets;
+    std::vector<uint16_t> compactStrategySum;
+    std::vector<uint8_t> compactRegretShift;
+    std::vector<uint8_t> compactSumShift;
 };
 
 /**
- * Manages the game tree and info sets for MCCFR.
+ * The betting tree below a root state, built once into a flat node array,
+ * together with the regret and strategy-sum storage the solver trains.
+ *
+ * Runouts are numbered 0 for the root board, 1 + c after dealing card c,
+ * and 1 + 52 + 52 * t + r after dealing t then r. Storage for a runout is
+ * allocated the first time a traversal reaches it.
  */
 class GameTree {
 public:
+    // Runout ids for up to two cards dealt below the root
+    static constexpr int MAX_RUNOUTS = 1 + core::NUM_CARDS + core::NUM_CARDS * core::NUM_CARDS;
+
     GameTree();
+
+    // COMPACT storage resolution (at shift 0) and floor, in bb
+    static constexpr double REGRET_UNITS = 1e5;
+    static constexpr double REGRET_FLOOR = -20000;
     
-    // Build tree from initial state
-    void build(const GameState& initialState, 
+    // Build tree from initial state; storage is sized for the given ranges.
+    // Root-street info sets are keyed by the buckets of a map that covers the
+    // root board; later streets by canonical hand name.
+    void build(const GameState& initialState,
                const core::Range& oopRange,
-               const core::Range& ipRange);
+               const core::Range& ipRange,
+               StorageMode mode = StorageMode::DOUBLE,
+               const DepthLimit& limit = {},
+               const BucketMap* buckets = nullptr);
+
+    // Nodes (the root is index 0)
+    const std::vector<TreeNode>& nodes() const { return nodes_; }
+    const TreeNode& node(int index) const { return nodes_[index]; }
+    bool empty() const { return nodes_.empty(); }
+
+    // OOP's chips in the pot at a node, counted from before the root like
+    // leaf payoffs are
+    double oopCommitted(const TreeNode& node) const {
+        return oopRootCommitted_ + (oopRootStack_ - node.oopStack);
+    }
+
+    // Nodes where a depth limit cut the tree: the estimated leaf, or the
+    // first continuation choice above the leaves
+    const std::vector<int>& cutPoints() const { return cuts_; }
+    const DepthLimit& depthLimit() const { return limit_; }
+
+    // Action leading into a node from its parent (unused below CHANCE nodes)
+    const Action& actionTo(int index) const { return actions_[index]; }
+
+    // Runout reached by dealing a card on top of another runout
+    static int nextRunout(int runout, int card) {
+        return (runout == 0) ? 1 + card : 1 + core::NUM_CARDS + (runout - 1) * core::NUM_CARDS + card;
+    }
+
+    // Cards dealt below the root for a runout id
+    static int runoutLevel(int runout) {
+        return (runout == 0) ? 0 : (runout <= core::NUM_CARDS) ? 1 : 2;
+    }
+
+    // Node reached by a state's board and action history below the root,
+    // -1 if none. Sets the runout the state's board corresponds to.
+    int findNode(const GameState& state, int& runout) const;
+
+    // Info set slots of each player's range on a level
+    const HandSlots& slots(Position player, int level) const {
+        return slots_[level][static_cast<int>(player)];
+    }
+
+    StorageMode storageMode() const { return mode_; }
     
-    // Get root node
-    std::shared_ptr<GameTreeNode> getRoot() const { return root_; }
+    // Cumulative regrets of one info set (numActions values, zero if never reached)
+    void loadRegrets(const TreeNode& node, int runout, int slot, double* out) const;
     
-    // Get info set by key (creates if doesn't exist)
-    std::shared_ptr<InfoSet> getOrCreateInfoSet(Position player, 
-                                                 const std::string& key,
-                                                 int numActions);
+    // Add to the regrets and strategy sums of one info set. These allocate
+    // the runout's storage on first use. The iteration seeds the dithered
+    // rounding of COMPACT strategy sums.
+    void addRegrets(const TreeNode& node, int runout, int slot, const double* delta);
+    void addStrategy(const TreeNode& node, int runout, int slot, const double* amounts, int iteration);
     
-    // Get all info sets
-    const std::unordered_map<std::string, std::shared_ptr<InfoSet>>& getInfoSets() const {
-        return infoSets_;
+    // Scale positive regrets, negative regrets and strategy sums (discounted CFR)
+    void discount(double positive, double negative, double strategy);
+
+    // Storage of a runout, nullptr if no traversal has reached it yet
+    RunoutStorage* runoutStorage(int runout) const {
+        return runouts_ ? runouts_[runout].load(std::memory_order_acquire) : nullptr;
     }
     
-    // Clear all info sets
-    void clearInfoSets();
+    // Storage of a runout, allocated (zeroed) if needed
+    RunoutStorage& allocateRunout(int runout) { return allocate(runout, runoutLevel(runout)); }
+
+    // Regret array length and info set count of a runout's storage, 0 for a
+    // runout deeper than the tree's chance levels
+    size_t runoutSize(int runout) const {
+        return runoutLevel(runout) < numLevels_ ? levelSize_[runoutLevel(runout)] : 0;
+    }
+    size_t runoutInfoSets(int runout) const {
+        return runoutLevel(runout) < numLevels_ ? levelInfoSets_[runoutLevel(runout)] : 0;
+    }
     
+    // Discount state of compact strategy sums (checkpoints)
+    double strategyWeight() const { return strategyWeight_; }
+    void setStrategyWeight(double weight) { strategyWeight_ = weight; }
+
+    // Strategy proportional to positive regrets (uniform if none is positive)
+    static void regretMatching(const double* regrets, int numActions, double* out);
+
+    // Regret-matching strategy of an info set (uniform if never reached)
+    void currentStrategy(const TreeNode& node, int runout, int slot, double* out) const;
+
+    // Normalized average strategy of an info set (uniform if never reached)
+    void averageStrategy(const TreeNode& node, int runout, int slot, double* out) const;
+
+    // Release all regrets and strategy sums
+    void clearInfoSets();
+
+    // Seed this (freshly built) tree from a tree solved with a different bet
+    // sizing over the same root and ranges. Nodes whose path still exists keep
+    // their regrets and strategy sums; actions and subtrees that are new
+    // take the regrets of the nearest old action of the same kind, so they
+    // start out playing like it. False if the trees are not compatible.
+    bool warmStart(const GameTree& previous);
+
     // Statistics
-    size_t numInfoSets() const { return infoSets_.size(); }
-    size_t numNodes() const { return nodeCount_; }
+    size_t numInfoSets() const;  // Over allocated runouts
+    size_t numNodes() const { return nodes_.size(); }
+    size_t numRunouts() const;   // Allocated runouts
+    size_t memoryUsage() const;  // Bytes of allocated regret/strategy storage
+    int maxDepth() const { return maxDepth_; }
+    int numLevels() const { return numLevels_; }
 
 private:
-    std::shared_ptr<GameTreeNode> root_;
-    std::unordered_map<std::string, std::shared_ptr<InfoSet>> infoSets_;
-    std::atomic<size_t> nodeCount_{0};
+    std::vector<TreeNode> nodes_;
+    std::vector<Action> actions_;
+    std::vector<int> cuts_;
+    DepthLimit limit_;
+    std::array<std::array<HandSlots, 2>, 3> slots_;  // Per level and player
+    int maxDepth_ = 0;
+    int numLevels_ = 1;
+    StorageMode mode_ = StorageMode::DOUBLE;
     
-    // Build tree recursively
-    std::shared_ptr<GameTreeNode> buildNode(const GameState& state);
+    // COMPACT: weight of new strategy-sum contributions. Discounting the
+    // sums is the same as weighting later contributions up.
+    double strategyWeight_ = 1.0;
+
+    // Storage size and info set count of one runout, per level
+    std::array<size_t, 3> levelSize_{};
+    std::array<size_t, 3> levelInfoSets_{};
+
+    // Lazily allocated storage, indexed by runout id
+    std::unique_ptr<std::atomic<RunoutStorage*>[]> runouts_;
+    std::vector<std::unique_ptr<RunoutStorage>> owned_;
+    mutable std::mutex allocMutex_;
+
+    // Root state, for locating nodes from a GameState
+    std::vector<core::Card> rootBoard_;
+    size_t rootHistoryLength_ = 0;
+
+    // OOP's share of the root pot and stack at the root, for zero-sum leaf payoffs
+    double oopRootCommitted_ = 0;
+    double oopRootStack_ = 0;
+
+    static size_t blockOffset(const TreeNode& node, int slot) {
+        return node.offset + static_cast<size_t>(slot) * node.numActions;
+    }
+
+    RunoutStorage& allocate(int runout, int level) {
+        RunoutStorage* storage = runouts_[runout].load(std::memory_order_acquire);
+        return storage ? *storage : allocateSlow(runout, level);
+    }
+    RunoutStorage& allocateSlow(int runout, int level);
+
+    // Append a node for a state (children are expanded separately)
+    int addNode(const BettingState& state, const BetSizingConfig& config,
+                int parent, int level, const Action& action);
+
+    // Create the children of a node and recurse into them, applying and
+    // undoing actions on one shared state
+    void expand(int index, BettingState& state, const BetSizingConfig& config, int depth);
     
-    // Generate info set key
-    std::string generateInfoSetKey(Position player, 
-                                   const core::Hand& hand,
-                                   const GameState& state) const;
+    // Turn a cut leaf into the continuation choices of both players
+    void expandCut(int index, int depth);
+
+    HandSlots buildSlots(const core::Range& range, const std::vector<core::Card>& board,
+                         const BucketMap* buckets) const;
+
+    // Copy one node's info sets from the previous tree, then its children's
+    void seedNode(const GameTree& previous, int index, int oldIndex, bool exactPath);
 };
 
 } // namespace solver
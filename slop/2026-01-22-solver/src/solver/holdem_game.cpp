@@ -0,0 +1,92 @@
+#include "holdem_game.hpp"
+
+namespace solver {
+
+HoldemGame::HoldemGame(const GameState& root, const core::Range& oopRange, const core::Range& ipRange) {
+    tree_.build(root, oopRange, ipRange);
+    rootBoard_ = root.board();
+    rootStrengths_ = &strengths_.get(rootBoard_);
+
+    for (Position player : {Position::OOP, Position::IP}) {
+        int p = static_cast<int>(player);
+        const core::Range& range = (player == Position::OOP) ? oopRange : ipRange;
+        const HandSlots& slots = tree_.slots(player, 0);
+        for (const auto& [hand, weight] : range.getAvailableHands(rootBoard_)) {
+            if (weight <= 0 || slots.slotOf(hand) < 0) continue;
+            combos_[p].push_back(hand.comboIndex());
+            weights_[p].push_back(weight);
+        }
+        dists_[p] = std::discrete_distribution<int>(weights_[p].begin(), weights_[p].end());
+    }
+
+    // Info sets of one runout of each level, then every runout laid out
+    nodeBase_.assign(tree_.numNodes(), 0);
+    for (size_t i = 0; i < tree_.numNodes(); ++i) {
+        const TreeNode& node = tree_.node(static_cast<int>(i));
+        if (node.type != NodeType::PLAYER) continue;
+        nodeBase_[i] = levelInfoSets_[node.level];
+        levelInfoSets_[node.level] += tree_.slots(node.player, node.level).size();
+    }
+    const size_t runoutsPerLevel[3] = {1, core::NUM_CARDS, static_cast<size_t>(core::NUM_CARDS) * core::NUM_CARDS};
+    for (int level = 0; level < 3; ++level) {
+        levelBase_[level] = numInfoSets_;
+        numInfoSets_ += runoutsPerLevel[level] * levelInfoSets_[level];
+    }
+}
+
+HoldemGame::State HoldemGame::initial() const {
+    State s;
+    for (const auto& card : rootBoard_) {
+        s.board[s.boardSize++] = card;
+        s.dead |= uint64_t{1} << card.value();
+    }
+    s.strengths = rootStrengths_;
+    return s;
+}
+
+HoldemGame::State HoldemGame::sampleChance(const State& s, std::mt19937& rng) const {
+    State out = s;
+    if (s.node < 0) {
+        // Rejection sampling: both combos are redrawn until they share no
+        // card, so each pair is dealt in proportion to its weight
+        out.noDeal = true;
+        if (combos_[0].empty() || combos_[1].empty()) return out;
+        const int maxAttempts = 1000;
+        core::Hand oop, ip;
+        int attempt = 0;
+        for (; attempt < maxAttempts; ++attempt) {
+            oop = core::Hand::fromComboIndex(combos_[0][dists_[0](rng)]);
+            ip = core::Hand::fromComboIndex(combos_[1][dists_[1](rng)]);
+            if (!ip.contains(oop.card1()) && !ip.contains(oop.card2())) break;
+        }
+        if (attempt == maxAttempts) return out;
+
+        out.noDeal = false;
+        out.combo[0] = oop.comboIndex();
+        out.combo[1] = ip.comboIndex();
+        // Built without a bucket map, every level shares the root's slots
+        out.slot[0] = tree_.slots(Position::OOP, 0).slotOf(oop);
+        out.slot[1] = tree_.slots(Position::IP, 0).slotOf(ip);
+        for (const auto& card : {oop.card1(), oop.card2(), ip.card1(), ip.card2()}) {
+            out.dead |= uint64_t{1} << card.value();
+        }
+        out.node = 0;
+        return out;
+    }
+
+    // A card uniformly from those not yet seen
+    std::uniform_int_distribution<int> pick(0, core::NUM_CARDS - 1);
+    int card;
+    do {
+        card = pick(rng);
+    } while (s.dead >> card & 1);
+
+    out.runout = GameTree::nextRunout(s.runout, card);
+    out.board[out.boardSize++] = core::Card(card);
+    out.dead |= uint64_t{1} << card;
+    out.strengths = &strengths_.get(out.board, out.boardSize);
+    out.node = tree_.node(s.node).firstChild;
+    return out;
+}
+
+} // namespace solver
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "cfr_engine.hpp"
+#include "game_tree.hpp"
+#include "strength_cache.hpp"
+#include "core/card.hpp"
+#include "core/range.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace solver {
+
+/**
+ * A postflop hold'em spot as a Game for CFREngine: the betting tree of a
+ * GameTree (built to the river, no depth limit), a deal of one combo per
+ * player weighted by range, and turn and river cards dealt at the tree's
+ * chance nodes. Player 0 is OOP.
+ *
+ * Info sets are (decision node, runout, hand slot), numbered level by
+ * level with every runout of a level laid out, and CFREngine allocates all
+ * of them up front (unlike GameTree, which allocates a runout when it is
+ * first reached). Meant for river and turn roots: a turn root with the
+ * default ranges and sizings needs about 40 MB of engine storage, a flop
+ * root roughly 10 GB. Solve flops with MCCFRSolver.
+ */
+class HoldemGame {
+public:
+    static constexpr int MAX_ACTIONS = solver::MAX_ACTIONS;
+
+    struct State {
+        int node = -1;  // -1 before the deal
+        bool noDeal = false;  // No deal fit both ranges: terminal, payoff 0
+        int runout = 0;
+        int combo[2] = {-1, -1};
+        int slot[2] = {-1, -1};
+        int boardSize = 0;
+        core::Card board[5];
+        uint64_t dead = 0;
+        const StrengthCache::Table* strengths = nullptr;
+    };
+
+    HoldemGame(const GameState& root, const core::Range& oopRange, const core::Range& ipRange);
+
+    size_t numInfoSets() const { return numInfoSets_; }
+    State initial() const;
+
+    bool isChance(const State& s) const {
+        return s.node < 0 ? !s.noDeal : tree_.node(s.node).type == NodeType::CHANCE;
+    }
+    bool isTerminal(const State& s) const {
+        return s.node < 0 ? s.noDeal : tree_.node(s.node).isLeaf();
+    }
+    int player(const State& s) const { return static_cast<int>(tree_.node(s.node).player); }
+    int numActions(const State& s) const { return tree_.node(s.node).numActions; }
+
+    size_t infoSet(const State& s) const {
+        const TreeNode& node = tree_.node(s.node);
+        return levelBase_[node.level] +
+               static_cast<size_t>(s.runout - FIRST_RUNOUT[node.level]) * levelInfoSets_[node.level] +
+               nodeBase_[s.node] + s.slot[static_cast<int>(node.player)];
+    }
+
+    State apply(const State& s, int action) const {
+        State out = s;
+        out.node = tree_.node(s.node).firstChild + action;
+        return out;
+    }
+
+    double utility(const State& s) const {
+        if (s.noDeal) return 0.0;
+        const TreeNode& node = tree_.node(s.node);
+        int showdown = 0;
+        if (node.showdown) {
+            int oop = (*s.strengths)[s.combo[0]];
+            int ip = (*s.strengths)[s.combo[1]];
+            showdown = (oop > ip) - (ip > oop);
+        }
+        return node.oopPayoff(showdown);
+    }
+
+    // The deal, or the next board card
+    State sampleChance(const State& s, std::mt19937& rng) const;
+
+    const GameTree& tree() const { return tree_; }
+
+private:
+    // First runout id of each tree level (see GameTree::nextRunout)
+    static constexpr int FIRST_RUNOUT[3] = {0, 1, 1 + core::NUM_CARDS};
+
+    GameTree tree_;
+    std::vector<core::Card> rootBoard_;
+    StrengthCache strengths_;
+    const StrengthCache::Table* rootStrengths_ = nullptr;
+
+    std::array<std::vector<int>, 2> combos_;   // Range combos per player
+    std::array<std::vector<double>, 2> weights_;
+    mutable std::array<std::discrete_distribution<int>, 2> dists_;
+
+    std::vector<size_t> nodeBase_;  // First info set of a decision node within its runout block
+    std::array<size_t, 3> levelInfoSets_ = {0, 0, 0};
+    std::array<size_t, 3> levelBase_ = {0, 0, 0};
+    size_t numInfoSets_ = 0;
+};
+
+} // namespace solver
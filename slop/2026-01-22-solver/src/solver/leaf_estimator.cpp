@@ -0,0 +1,349 @@
+#include "leaf_estimator.hpp"
+#include "mccfr.hpp"
+#include "solution_library.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+
+namespace solver {
+
+namespace {
+
+// Range combos with positive weight, and the reverse map
+void rangeCombos(const MCCFRSolver& solver, std::array<std::vector<int>, 2>& combos,
+                 std::array<std::vector<int>, 2>& indexOf) {
+    for (Position player : {Position::OOP, Position::IP}) {
+        int p = static_cast<int>(player);
+        const auto& weights = solver.comboWeights(player);
+        combos[p].clear();
+        indexOf[p].assign(core::NUM_COMBOS, -1);
+        for (int combo = 0; combo < static_cast<int>(weights.size()); ++combo) {
+            if (weights[combo] <= 0) continue;
+            indexOf[p][combo] = static_cast<int>(combos[p].size());
+            combos[p].push_back(combo);
+        }
+    }
+}
+
+uint64_t comboMask(int combo) {
+    core::Hand hand = core::Hand::fromComboIndex(combo);
+    return uint64_t{1} << hand.card1().value() | uint64_t{1} << hand.card2().value();
+}
+
+uint64_t boardMask(const core::Card* board, int boardSize) {
+    uint64_t mask = 0;
+    for (int i = 0; i < boardSize; ++i) {
+        mask |= uint64_t{1} << board[i].value();
+    }
+    return mask;
+}
+
+// Fold, passive (check/call) and aggressive actions
+int actionKind(ActionType type) {
+    switch (type) {
+        case ActionType::FOLD: return 0;
+        case ActionType::CHECK:
+        case ActionType::CALL: return 1;
+        default: return 2;
+    }
+}
+
+} // namespace
+
+void EquityEstimator::prepare(const MCCFRSolver& solver) {
+    rangeCombos(solver, combos_, indexOf_);
+    std::unique_lock lock(mutex_);
+    tables_.clear();
+}
+
+double EquityEstimator::value(const TreeNode& leaf, const core::Card* board, int boardSize,
+                              int oopCombo, int ipCombo) const {
+    return leaf.pot * equity(board, boardSize, oopCombo, ipCombo);
+}
+
+double EquityEstimator::equity(const core::Card* board, int boardSize, int oopCombo, int ipCombo) const {
+    int i = indexOf_[0].empty() ? -1 : indexOf_[0][oopCombo];
+    int j = indexOf_[1].empty() ? -1 : indexOf_[1][ipCombo];
+    if (i < 0 || j < 0) return 0.5;
+    return table(board, boardSize)[static_cast<size_t>(i) * combos_[1].size() + j];
+}
+
+const std::vector<float>& EquityEstimator::table(const core::Card* board, int boardSize) const {
+    uint64_t key = boardMask(board, boardSize);
+    {
+        std::shared_lock lock(mutex_);
+        auto it = tables_.find(key);
+        if (it != tables_.end()) return *it->second;
+    }
+
+    const auto& oop = combos_[0];
+    const auto& ip = combos_[1];
+    std::vector<uint64_t> oopMasks(oop.size());
+    std::vector<uint64_t> ipMasks(ip.size());
+    std::transform(oop.begin(), oop.end(), oopMasks.begin(), comboMask);
+    std::transform(ip.begin(), ip.end(), ipMasks.begin(), comboMask);
+
+    // Wins count 2 and ties 1 over every completion of the board
+    std::vector<double> points(oop.size() * ip.size(), 0.0);
+    core::Card full[5];
+    std::copy(board, board + boardSize, full);
+
+    auto showdown = [&](uint64_t dealt) {
+        const auto& strengths = strengths_.get(full, 5);
+        for (size_t i = 0; i < oop.size(); ++i) {
+            if (oopMasks[i] & dealt) continue;
+            int strength = strengths[oop[i]];
+            double* row = &points[i * ip.size()];
+            for (size_t j = 0; j < ip.size(); ++j) {
+                if (ipMasks[j] & (dealt | oopMasks[i])) continue;
+                int other = strengths[ip[j]];
+                row[j] += (strength > other) ? 2 : (strength == other) ? 1 : 0;
+            }
+        }
+    };
+
+    std::vector<int> remaining;
+    for (int card = 0; card < core::NUM_CARDS; ++card) {
+        if (!(key >> card & 1)) remaining.push_back(card);
+    }
+
+    // Completions that share no card with either hand
+    int free = static_cast<int>(remaining.size()) - 4;
+    double completions = 1;
+    if (boardSize == 3) {
+        completions = free * (free - 1) / 2.0;
+        for (size_t a = 0; a < remaining.size(); ++a) {
+            for (size_t b = a + 1; b < remaining.size(); ++b) {
+                full[3] = core::Card(remaining[a]);
+                full[4] = core::Card(remaining[b]);
+                showdown(uint64_t{1} << remaining[a] | uint64_t{1} << remaining[b]);
+            }
+        }
+    } else if (boardSize == 4) {
+        completions = free;
+        for (int card : remaining) {
+            full[4] = core::Card(card);
+            showdown(uint64_t{1} << card);
+        }
+    } else {
+        showdown(0);
+    }
+
+    auto table = std::make_unique<std::vector<float>>(points.size());
+    for (size_t k = 0; k < points.size(); ++k) {
+        (*table)[k] = static_cast<float>(points[k] / (2 * completions));
+    }
+
+    std::unique_lock lock(mutex_);
+    auto [it, inserted] = tables_.emplace(key, std::move(table));
+    return *it->second;
+}
+
+BlueprintRollouts::BlueprintRollouts(const MCCFRSolver& blueprint, int rollouts, bool multiValued)
+    : blueprint_(blueprint), rollouts_(std::max(1, rollouts)), multiValued_(multiValued) {}
+
+std::string BlueprintRollouts::signature() const {
+    const GameState& root = blueprint_.initialState();
+    std::string board;
+    for (const auto& card : root.board()) {
+        board += card.toString();
+    }
+    char text[160];
+    std::snprintf(text, sizeof(text), "rollouts %d %s %s %016llx %016llx %d", rollouts_,
+                  multiValued_ ? "multi" : "single", board.c_str(),
+                  static_cast<unsigned long long>(hashRanges(blueprint_.oopRange(), blueprint_.ipRange())),
+                  static_cast<unsigned long long>(hashBetTree(root.config())),
+                  blueprint_.currentIteration());
+    return text;
+}
+
+void BlueprintRollouts::prepare(const MCCFRSolver& solver) {
+    equity_.prepare(solver);
+    rangeCombos(solver, combos_, indexOf_);
+
+    const GameTree& tree = solver.gameTree();
+    const GameTree& bp = blueprint_.gameTree();
+    const GameState& root = solver.initialState();
+    const GameState& bpRoot = blueprint_.initialState();
+    rootBoardSize_ = static_cast<int>(root.board().size());
+
+    // The blueprint has to start where this solve starts and reach the river
+    bool sameRoot = !bp.empty() && root.board() == bpRoot.board() && root.pot() == bpRoot.pot() &&
+                    root.oopStack() == bpRoot.oopStack() && root.ipStack() == bpRoot.ipStack() &&
+                    root.actionHistory().size() == bpRoot.actionHistory().size() &&
+                    bp.depthLimit().lastStreet == Street::RIVER;
+
+    // Follow each cut's actions down the blueprint's tree
+    blueprintNode_.assign(tree.cutPoints().size(), -1);
+    for (size_t cut = 0; cut < tree.cutPoints().size() && sameRoot; ++cut) {
+        std::vector<int> path;
+        for (int index = tree.cutPoints()[cut]; index > 0; index = tree.node(index).parent) {
+            path.push_back(index);
+        }
+
+        int at = 0;
+        for (auto it = path.rbegin(); it != path.rend() && at >= 0; ++it) {
+            const TreeNode& node = bp.node(at);
+            if (node.isLeaf()) {
+                at = -1;
+            } else if (node.type == NodeType::CHANCE) {
+                at = node.firstChild;
+            } else {
+                const Action& action = tree.actionTo(*it);
+                int next = -1;
+                for (int a = 0; a < node.numActions; ++a) {
+                    const Action& candidate = bp.actionTo(node.firstChild + a);
+                    if (candidate.type == action.type && std::abs(candidate.amount - action.amount) < 1e-9) {
+                        next = node.firstChild + a;
+                        break;
+                    }
+                }
+                at = next;
+            }
+        }
+
+        // The cut closes a street, where the blueprint deals the next card
+        if (at >= 0 && bp.node(at).type == NodeType::CHANCE) {
+            blueprintNode_[cut] = at;
+        }
+    }
+
+    int numContinuations = this->numContinuations();
+    std::unique_lock lock(mutex_);
+    tables_.clear();
+    tables_.resize(tree.cutPoints().size() * numContinuations * numContinuations);
+}
+
+double BlueprintRollouts::value(const TreeNode& leaf, const core::Card* board, int boardSize,
+                                int oopCombo, int ipCombo) const {
+    int i = indexOf_[0].empty() ? -1 : indexOf_[0][oopCombo];
+    int j = indexOf_[1].empty() ? -1 : indexOf_[1][ipCombo];
+    if (i < 0 || j < 0 || blueprintNode_[leaf.cut] < 0) {
+        return equity_.value(leaf, board, boardSize, oopCombo, ipCombo);
+    }
+    return table(leaf, board, boardSize)[static_cast<size_t>(i) * combos_[1].size() + j];
+}
+
+const std::vector<float>& BlueprintRollouts::table(const TreeNode& leaf, const core::Card* board,
+                                                   int boardSize) const {
+    int numContinuations = this->numContinuations();
+    auto& tables = tables_[static_cast<size_t>(leaf.cut) * numContinuations * numContinuations +
+                           leaf.continuation];
+    uint64_t key = boardMask(board, boardSize);
+    {
+        std::shared_lock lock(mutex_);
+        auto it = tables.find(key);
+        if (it != tables.end()) return *it->second;
+    }
+
+    // Runout of the leaf board in the blueprint, which has the same root
+    int runout = 0;
+    for (int i = rootBoardSize_; i < boardSize; ++i) {
+        runout = GameTree::nextRunout(runout, board[i].value());
+    }
+    int bias[2] = {leaf.continuation / numContinuations, leaf.continuation % numContinuations};
+
+    const auto& oop = combos_[0];
+    const auto& ip = combos_[1];
+    auto table = std::make_unique<std::vector<float>>(oop.size() * ip.size(), 0.0f);
+    std::mt19937 rng(static_cast<uint32_t>(key ^ (key >> 32)) + leaf.cut * 31 + leaf.continuation);
+
+    core::Card cards[5];
+    for (size_t i = 0; i < oop.size(); ++i) {
+        uint64_t oopMask = comboMask(oop[i]);
+        if (oopMask & key) continue;
+        for (size_t j = 0; j < ip.size(); ++j) {
+            uint64_t ipMask = comboMask(ip[j]);
+            if (ipMask & (key | oopMask)) continue;
+
+            int combo[2] = {oop[i], ip[j]};
+            double sum = 0;
+            for (int r = 0; r < rollouts_; ++r) {
+                std::copy(board, board + boardSize, cards);
+                sum += rollout(blueprintNode_[leaf.cut], runout, cards, boardSize,
+                               key | oopMask | ipMask, combo, bias, rng);
+            }
+            (*table)[i * ip.size() + j] = static_cast<float>(sum / rollouts_);
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    auto [it, inserted] = tables.emplace(key, std::move(table));
+    return *it->second;
+}
+
+double BlueprintRollouts::rollout(int nodeIndex, int runout, core::Card* board, int boardSize,
+                                  uint64_t dead, const int* combo, const int* bias,
+                                  std::mt19937& rng) const {
+    const GameTree& tree = blueprint_.gameTree();
+
+    // Leaf payoffs count from before the root; the return counts from the cut
+    double committed = tree.oopCommitted(tree.node(nodeIndex));
+
+    std::uniform_int_distribution<int> pickCard(0, core::NUM_CARDS - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double strategy[MAX_ACTIONS];
+
+    while (true) {
+        const TreeNode& node = tree.node(nodeIndex);
+
+        if (node.isLeaf()) {
+            int showdown = 0;
+            if (node.showdown) {
+                const auto& strengths = blueprint_.strengthCache().get(board, boardSize);
+                int oopStrength = strengths[combo[0]];
+                int ipStrength = strengths[combo[1]];
+                showdown = (oopStrength > ipStrength) - (ipStrength > oopStrength);
+            }
+            return node.oopPayoff(showdown) + committed;
+        }
+
+        if (node.type == NodeType::CHANCE) {
+            int card;
+            do {
+                card = pickCard(rng);
+            } while (dead >> card & 1);
+            dead |= uint64_t{1} << card;
+            board[boardSize++] = core::Card(card);
+            runout = GameTree::nextRunout(runout, card);
+            nodeIndex = node.firstChild;
+            continue;
+        }
+
+        int player = static_cast<int>(node.player);
+        int slot = tree.slots(node.player, node.level).comboToSlot[combo[player]];
+        if (slot >= 0) {
+            tree.averageStrategy(node, runout, slot, strategy);
+        } else {
+            std::fill(strategy, strategy + node.numActions, 1.0 / node.numActions);
+        }
+
+        // Biased continuations favour one kind of action
+        if (bias[player] > 0) {
+            double total = 0;
+            for (int a = 0; a < node.numActions; ++a) {
+                if (actionKind(tree.actionTo(node.firstChild + a).type) == bias[player] - 1) {
+                    strategy[a] *= BIAS_FACTOR;
+                }
+                total += strategy[a];
+            }
+            for (int a = 0; a < node.numActions; ++a) {
+                strategy[a] /= total;
+            }
+        }
+
+        double r = unit(rng);
+        int sampled = node.numActions - 1;
+        for (int a = 0; a < node.numActions - 1; ++a) {
+            r -= strategy[a];
+            if (r < 0) {
+                sampled = a;
+                break;
+            }
+        }
+        nodeIndex = node.firstChild + sampled;
+    }
+}
+
+} // namespace solver
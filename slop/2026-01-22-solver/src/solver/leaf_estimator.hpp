@@ -0,0 +1,130 @@
+#pragma once
+
+#include "game_tree.hpp"
+#include "strength_cache.hpp"
+#include "core/card.hpp"
+#include "core/hand.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * Values the leaves of a depth-limited tree (see DepthLimit).
+ *
+ * A leaf's value is OOP's expected return from the point where the tree
+ * was cut: what it gets back from the pot and any later betting, in bb.
+ * The solver adds OOP's chips already in the pot, so with no more betting
+ * the return is simply pot x equity.
+ */
+class LeafEstimator {
+public:
+    virtual ~LeafEstimator() = default;
+
+    // Continuation strategies each player picks from at a cut (1: no choice)
+    virtual int numContinuations() const { return 1; }
+
+    // Called by MCCFRSolver::initialize once the cut tree is built
+    virtual void prepare(const MCCFRSolver& solver) = 0;
+
+    // OOP's expected return at an estimated leaf for one pair of combos
+    // (core::Hand::comboIndex()). The board is the leaf's: the root board
+    // plus the runout's cards. Must be safe to call from several threads.
+    virtual double value(const TreeNode& leaf, const core::Card* board, int boardSize,
+                         int oopCombo, int ipCombo) const = 0;
+
+    // Kind and parameters of the estimator. A checkpoint of a depth-limited
+    // solve records it and only resumes under an estimator with the same one.
+    virtual std::string signature() const = 0;
+};
+
+/**
+ * Equity times pot: both players check down from the cut. Equities are
+ * exact over all remaining cards, computed once per leaf board for every
+ * pair of range combos.
+ */
+class EquityEstimator : public LeafEstimator {
+public:
+    void prepare(const MCCFRSolver& solver) override;
+    double value(const TreeNode& leaf, const core::Card* board, int boardSize,
+                 int oopCombo, int ipCombo) const override;
+    std::string signature() const override { return "equity"; }
+
+    // OOP's share of the pot for a pair of combos on a board of 3 to 5 cards
+    double equity(const core::Card* board, int boardSize, int oopCombo, int ipCombo) const;
+
+private:
+    // Range combos per player; a board's table is numOop x numIp
+    std::array<std::vector<int>, 2> combos_;
+    std::array<std::vector<int>, 2> indexOf_;  // core combo index -> combo index, -1 if absent
+
+    StrengthCache strengths_;
+    mutable std::shared_mutex mutex_;
+    mutable std::unordered_map<uint64_t, std::unique_ptr<std::vector<float>>> tables_;
+
+    const std::vector<float>& table(const core::Card* board, int boardSize) const;
+};
+
+/**
+ * Rollouts of a blueprint: a full-depth solve of the same root (a coarser
+ * solve, or one from the SolutionLibrary) plays out the hand from each cut.
+ * Cards are dealt at random and both players sample actions from their
+ * blueprint average strategies.
+ *
+ * Multi-valued: each player instead picks one of four continuation
+ * strategies at the cut (the blueprint, and the blueprint biased towards
+ * folding, calling or raising), so the depth-limited solve has to hold up
+ * whichever way the rest of the hand is played.
+ *
+ * Values are averaged over `rollouts` playouts per combo pair, computed once
+ * per (cut, board, continuation). Cuts the blueprint does not contain are
+ * valued by equity.
+ */
+class BlueprintRollouts : public LeafEstimator {
+public:
+    static constexpr int NUM_BIASES = 4;
+    static constexpr double BIAS_FACTOR = 5.0;
+
+    // The blueprint must outlive the estimator
+    explicit BlueprintRollouts(const MCCFRSolver& blueprint, int rollouts = 16,
+                               bool multiValued = false);
+
+    int numContinuations() const override { return multiValued_ ? NUM_BIASES : 1; }
+    void prepare(const MCCFRSolver& solver) override;
+    double value(const TreeNode& leaf, const core::Card* board, int boardSize,
+                 int oopCombo, int ipCombo) const override;
+
+    // Rollouts, continuations, and the blueprint's setup and iteration
+    std::string signature() const override;
+
+private:
+    const MCCFRSolver& blueprint_;
+    int rollouts_;
+    bool multiValued_;
+
+    EquityEstimator equity_;
+    int rootBoardSize_ = 0;
+    std::vector<int> blueprintNode_;  // Cut point -> blueprint node, -1 if absent
+    std::array<std::vector<int>, 2> combos_;
+    std::array<std::vector<int>, 2> indexOf_;
+
+    // Per cut and continuation, by board mask
+    mutable std::shared_mutex mutex_;
+    mutable std::vector<std::unordered_map<uint64_t, std::unique_ptr<std::vector<float>>>> tables_;
+
+    const std::vector<float>& table(const TreeNode& leaf, const core::Card* board, int boardSize) const;
+
+    // OOP's return from one playout of the blueprint below a node
+    double rollout(int nodeIndex, int runout, core::Card* board, int boardSize,
+                   uint64_t dead, const int* combo, const int* bias, std::mt19937& rng) const;
+};
+
+} // namespace solver
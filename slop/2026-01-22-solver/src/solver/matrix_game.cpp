@@ -0,0 +1,234 @@
+#include "matrix_game.hpp"
+#include <algorithm>
+#include <utility>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SOLVER_MATRIX_AVX 1
+#endif
+
+namespace solver {
+
+namespace {
+
+constexpr size_t LANES = 8;  // Floats per AVX register; rows are padded to a multiple
+
+size_t padded(size_t n) {
+    return (n + LANES - 1) / LANES * LANES;
+}
+
+// Dot product of two padded rows
+float dot(const float* a, const float* b, size_t n) {
+#ifdef SOLVER_MATRIX_AVX
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 2 * LANES <= n; i += 2 * LANES) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + LANES), _mm256_loadu_ps(b + i + LANES), sum1);
+    }
+    for (; i < n; i += LANES) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+    __m256 sum = _mm256_add_ps(sum0, sum1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+#else
+    // Independent partial sums let the compiler keep several in flight
+    float sum[LANES] = {};
+    for (size_t i = 0; i < n; i += LANES) {
+        for (size_t k = 0; k < LANES; ++k) sum[k] += a[i + k] * b[i + k];
+    }
+    float total = 0;
+    for (size_t k = 0; k < LANES; ++k) total += sum[k];
+    return total;
+#endif
+}
+
+// regrets += instant (floored at zero if plus); out = max(regrets + prediction, 0)
+void accumulate(float* regrets, const float* instant, float* out, size_t n, bool plus, bool optimistic) {
+    size_t i = 0;
+#ifdef SOLVER_MATRIX_AVX
+    const __m256 zero = _mm256_setzero_ps();
+    for (; i + LANES <= n; i += LANES) {
+        __m256 r = _mm256_add_ps(_mm256_loadu_ps(regrets + i), _mm256_loadu_ps(instant + i));
+        if (plus) r = _mm256_max_ps(r, zero);
+        _mm256_storeu_ps(regrets + i, r);
+        __m256 played = optimistic ? _mm256_add_ps(r, _mm256_loadu_ps(instant + i)) : r;
+        _mm256_storeu_ps(out + i, _mm256_max_ps(played, zero));
+    }
+#endif
+    for (; i < n; ++i) {
+        float r = regrets[i] + instant[i];
+        if (plus) r = std::max(r, 0.0f);
+        regrets[i] = r;
+        out[i] = std::max(optimistic ? r + instant[i] : r, 0.0f);
+    }
+}
+
+} // namespace
+
+MatrixGame::MatrixGame(int rows, int cols, std::vector<float> payoff)
+    : MatrixGame(1, rows, 1, cols, std::move(payoff)) {}
+
+MatrixGame::MatrixGame(int rowGroups, int rowActions, int colGroups, int colActions, std::vector<float> payoff)
+    : rowGroups_(rowGroups),
+      rowActions_(rowActions),
+      colGroups_(colGroups),
+      colActions_(colActions),
+      payoff_(std::move(payoff)) {
+    payoff_.resize(static_cast<size_t>(rows()) * cols(), 0.0f);
+}
+
+MatrixGameSolver::MatrixGameSolver(const MatrixGame& game, MatrixSolverConfig config)
+    : game_(game), config_(config) {
+    size_t rows = game.rows();
+    size_t cols = game.cols();
+    rowStride_ = padded(cols);
+    colStride_ = padded(rows);
+    matrix_.assign(rows * rowStride_, 0.0f);
+    transpose_.assign(cols * colStride_, 0.0f);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            float a = game.payoff(static_cast<int>(r), static_cast<int>(c));
+            matrix_[r * rowStride_ + c] = a;
+            transpose_[c * colStride_ + r] = -a;
+        }
+    }
+
+    auto init = [](Side& side, int groups, int actions, size_t stride) {
+        side.groups = groups;
+        side.actions = actions;
+        side.size = static_cast<size_t>(groups) * actions;
+        side.strategy.assign(stride, 0.0f);
+        std::fill(side.strategy.begin(), side.strategy.begin() + side.size, 1.0f / actions);
+        side.regrets.assign(side.size, 0.0f);
+        side.lastRegrets.assign(side.size, 0.0f);
+        side.values.assign(side.size, 0.0f);
+        side.strategySum.assign(side.size, 0.0);
+    };
+    init(row_, game.rowGroups(), game.rowActions(), colStride_);
+    init(col_, game.colGroups(), game.colActions(), rowStride_);
+}
+
+void MatrixGameSolver::computeValues(const std::vector<float>& matrix, size_t stride,
+                                     const Side& other, Side& side) const {
+    for (size_t i = 0; i < side.size; ++i) {
+        side.values[i] = dot(&matrix[i * stride], other.strategy.data(), stride);
+    }
+}
+
+void MatrixGameSolver::update(Side& side, double weight) {
+    // Average first: the strategy is the one the values were computed against
+    for (size_t i = 0; i < side.size; ++i) {
+        side.strategySum[i] += weight * side.strategy[i];
+    }
+
+    // Instantaneous regret: each entry's value less its group's value
+    for (int g = 0; g < side.groups; ++g) {
+        size_t begin = static_cast<size_t>(g) * side.actions;
+        float groupValue = 0;
+        for (int a = 0; a < side.actions; ++a) {
+            groupValue += side.strategy[begin + a] * side.values[begin + a];
+        }
+        for (int a = 0; a < side.actions; ++a) {
+            side.lastRegrets[begin + a] = side.values[begin + a] - groupValue;
+        }
+    }
+
+    // The strategy buffer receives the positive part the next strategy is matched from
+    accumulate(side.regrets.data(), side.lastRegrets.data(), side.strategy.data(), side.size,
+               config_.cfrPlus, config_.optimistic);
+    matchRegrets(side);
+}
+
+void MatrixGameSolver::matchRegrets(Side& side) const {
+    for (int g = 0; g < side.groups; ++g) {
+        float* s = &side.strategy[static_cast<size_t>(g) * side.actions];
+        float total = 0;
+        for (int a = 0; a < side.actions; ++a) total += s[a];
+        float scale = total > 0 ? 1.0f / total : 0.0f;
+        for (int a = 0; a < side.actions; ++a) {
+            s[a] = total > 0 ? s[a] * scale : 1.0f / side.actions;
+        }
+    }
+}
+
+void MatrixGameSolver::iterate(int count) {
+    for (int i = 0; i < count; ++i) {
+        ++iterations_;
+        double weight = config_.cfrPlus ? iterations_ : 1.0;
+        if (config_.cfrPlus) {
+            // Alternating: the columns respond to the rows' new strategy
+            computeValues(matrix_, rowStride_, col_, row_);
+            update(row_, weight);
+            computeValues(transpose_, colStride_, row_, col_);
+            update(col_, weight);
+        } else {
+            computeValues(matrix_, rowStride_, col_, row_);
+            computeValues(transpose_, colStride_, row_, col_);
+            update(row_, weight);
+            update(col_, weight);
+        }
+    }
+}
+
+std::vector<double> MatrixGameSolver::average(const Side& side) const {
+    std::vector<double> out(side.size);
+    for (int g = 0; g < side.groups; ++g) {
+        size_t begin = static_cast<size_t>(g) * side.actions;
+        double total = 0;
+        for (int a = 0; a < side.actions; ++a) total += side.strategySum[begin + a];
+        for (int a = 0; a < side.actions; ++a) {
+            out[begin + a] = total > 0 ? side.strategySum[begin + a] / total : 1.0 / side.actions;
+        }
+    }
+    return out;
+}
+
+std::vector<double> MatrixGameSolver::rowStrategy() const {
+    return average(row_);
+}
+
+std::vector<double> MatrixGameSolver::colStrategy() const {
+    return average(col_);
+}
+
+double MatrixGameSolver::value() const {
+    std::vector<double> x = rowStrategy();
+    std::vector<double> y = colStrategy();
+    double v = 0;
+    for (size_t r = 0; r < row_.size; ++r) {
+        if (x[r] == 0) continue;
+        double rowValue = 0;
+        for (size_t c = 0; c < col_.size; ++c) rowValue += matrix_[r * rowStride_ + c] * y[c];
+        v += x[r] * rowValue;
+    }
+    return v;
+}
+
+double MatrixGameSolver::bestResponse(const std::vector<float>& matrix, size_t stride, const Side& side,
+                                      const std::vector<double>& other) const {
+    double total = 0;
+    for (int g = 0; g < side.groups; ++g) {
+        double best = 0;
+        for (int a = 0; a < side.actions; ++a) {
+            size_t entry = static_cast<size_t>(g) * side.actions + a;
+            double v = 0;
+            for (size_t k = 0; k < other.size(); ++k) v += matrix[entry * stride + k] * other[k];
+            if (a == 0 || v > best) best = v;
+        }
+        total += best;
+    }
+    return total;
+}
+
+double MatrixGameSolver::exploitability() const {
+    double rowBest = bestResponse(matrix_, rowStride_, row_, colStrategy());
+    double colBest = bestResponse(transpose_, colStride_, col_, rowStrategy());
+    return (rowBest + colBest) / 2;
+}
+
+} // namespace solver
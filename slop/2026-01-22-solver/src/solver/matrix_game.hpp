@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace solver {
+
+/**
+ * A two-player zero-sum game whose payoff is bilinear in the strategies:
+ * the row player gets x^T A y for a rows x cols matrix A, the column
+ * player the negation.
+ *
+ * Each player's entries form decision groups of equal size, and a
+ * strategy is a distribution over each group's entries. A plain matrix
+ * game (rock-paper-scissors, N x M) has one group per player. A preflop
+ * game has a group per hand class with an entry per action, and A carries
+ * each pair of classes' probability, so one matrix-vector product gives
+ * every class's action values.
+ */
+class MatrixGame {
+public:
+    MatrixGame() = default;
+    // Plain matrix game: one decision per player over rows and cols actions
+    MatrixGame(int rows, int cols, std::vector<float> payoff);
+    // rowGroups decisions of rowActions entries against colGroups of colActions
+    MatrixGame(int rowGroups, int rowActions, int colGroups, int colActions, std::vector<float> payoff);
+
+    int rows() const { return rowGroups_ * rowActions_; }
+    int cols() const { return colGroups_ * colActions_; }
+    int rowGroups() const { return rowGroups_; }
+    int rowActions() const { return rowActions_; }
+    int colGroups() const { return colGroups_; }
+    int colActions() const { return colActions_; }
+
+    float payoff(int row, int col) const { return payoff_[static_cast<size_t>(row) * cols() + col]; }
+    const std::vector<float>& payoffs() const { return payoff_; }
+
+private:
+    int rowGroups_ = 0;
+    int rowActions_ = 0;
+    int colGroups_ = 0;
+    int colActions_ = 0;
+    std::vector<float> payoff_;  // Row-major, row player's payoff
+};
+
+/**
+ * Configuration for MatrixGameSolver
+ */
+struct MatrixSolverConfig {
+    bool cfrPlus = true;     // Regrets floored at zero, alternating updates, linear averaging
+    bool optimistic = true;  // Play regret matching on the regrets plus the last instantaneous regret
+};
+
+/**
+ * Full-width regret matching on a MatrixGame.
+ *
+ * An iteration is two matrix-vector products (A y for the rows, A^T x for
+ * the columns, from a transposed copy so both read contiguous rows) and an
+ * elementwise regret update; both are AVX kernels where the compiler
+ * targets AVX2 and plain loops otherwise. Nothing is sampled, so a
+ * 338 x 338 preflop game takes tens of microseconds per iteration and is
+ * within 0.001 bb of equilibrium after about a hundred.
+ */
+class MatrixGameSolver {
+public:
+    explicit MatrixGameSolver(const MatrixGame& game, MatrixSolverConfig config = {});
+
+    void iterate(int count = 1);
+    int iterations() const { return iterations_; }
+
+    // Average strategies, each group summing to 1
+    std::vector<double> rowStrategy() const;
+    std::vector<double> colStrategy() const;
+
+    // Row player's payoff when both play the average strategies
+    double value() const;
+    // Mean of both players' best-response gains against the average
+    // strategies, in payoff units (0 at a Nash equilibrium)
+    double exploitability() const;
+
+    const MatrixGame& game() const { return game_; }
+
+private:
+    struct Side {
+        int groups = 0;
+        int actions = 0;
+        size_t size = 0;
+        std::vector<float> strategy;      // Current, padded with zeros
+        std::vector<float> regrets;
+        std::vector<float> lastRegrets;   // Optimistic: previous instantaneous regrets
+        std::vector<float> values;        // This iteration's action values
+        std::vector<double> strategySum;
+    };
+
+    const MatrixGame& game_;
+    MatrixSolverConfig config_;
+    size_t rowStride_ = 0;  // cols padded to the vector width
+    size_t colStride_ = 0;  // rows padded to the vector width
+    std::vector<float> matrix_;     // rows x rowStride_
+    std::vector<float> transpose_;  // cols x colStride_, negated: the column player's payoff
+    Side row_;
+    Side col_;
+    int iterations_ = 0;
+
+    // values = M * strategy of the other side
+    void computeValues(const std::vector<float>& matrix, size_t stride, const Side& other, Side& side) const;
+    void update(Side& side, double weight);
+    void matchRegrets(Side& side) const;
+    std::vector<double> average(const Side& side) const;
+    // Best response value of `side` against the other side's average strategy
+    double bestResponse(const std::vector<float>& matrix, size_t stride, const Side& side,
+                        const std::vector<double>& other) const;
+};
+
+} // namespace solver
@@ -1,9 +1,9 @@
 #include "mccfr.hpp"
-#include "ompeval/hand_evaluator.hpp"
+#include "solve_loop.hpp"
+#include "task_pool.hpp"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
-#include <chrono>
 
 namespace solver {
 
@@ -27,55 +27,153 @@ void MCCFRSolver::initialize(const GameState& state,
     iteration_ = 0;
     shouldStop_ = false;
     
-    // Clear previous info sets
-    gameTree_.clearInfoSets();
+    // Build the betting tree and its (zeroed) regret storage once
+    DepthLimit limit;
+    if (config_.lastStreet != Street::RIVER) {
+        if (!leafEstimator_) leafEstimator_ = std::make_shared<EquityEstimator>();
+        limit.lastStreet = config_.lastStreet;
+        limit.continuations = leafEstimator_->numContinuations();
+    }
+    gameTree_.build(state, oopRange, ipRange, config_.storageMode, limit, bucketMap_.get());
+    
+    // Work below each node, for the fork cutoff; children follow their
+    // parents in the tree, so one backward pass does
+    int rootCards = static_cast<int>(state.board().size());
+    work_.assign(gameTree_.numNodes(), 1.0);
+    for (int n = static_cast<int>(gameTree_.numNodes()) - 1; n >= 0; --n) {
+        const TreeNode& node = gameTree_.node(n);
+        if (node.type == NodeType::CHANCE) {
+            int cards = core::NUM_CARDS - rootCards - node.level;
+            work_[n] = 1 + cards * (work_[node.firstChild] + 1);
+        } else if (!node.isLeaf()) {
+            for (int a = 0; a < node.numActions; ++a) {
+                work_[n] += work_[node.firstChild + a];
+            }
+        }
+    }
+    
+    rootRunout_ = Runout{};
+    for (const auto& card : state.board()) {
+        rootRunout_.board[rootRunout_.boardSize++] = card;
+        rootRunout_.dead |= uint64_t{1} << card.value();
+    }
+    rootRunout_.strengths = &strengthCache_.get(rootRunout_.board, rootRunout_.boardSize);
+    
+    for (Position player : {Position::OOP, Position::IP}) {
+        const core::Range& range = (player == Position::OOP) ? oopRange : ipRange;
+        auto& weights = comboWeights_[static_cast<int>(player)];
+        weights.assign(core::NUM_COMBOS, 0.0);
+        for (const auto& [hand, weight] : range.getAvailableHands(state.board())) {
+            weights[hand.comboIndex()] = std::max(weight, 0.0);
+        }
+        buildCombos(player);
+    }
+    
+    gadgetValues_.clear();
+    gadgetRegrets_.clear();
+    
+    if (!gameTree_.cutPoints().empty()) {
+        leafEstimator_->prepare(*this);
+    }
+}
+
+void MCCFRSolver::initialize(const Subgame& subgame) {
+    initialize(subgame.root, subgame.oopRange, subgame.ipRange);
+    
+    comboWeights_ = subgame.reach;
+    buildCombos(Position::OOP);
+    buildCombos(Position::IP);
+    
+    gadgetPlayer_ = subgame.constrained;
+    gadgetValues_ = subgame.values;
+    gadgetRegrets_.assign(core::NUM_COMBOS * 2, 0.0);
+}
+
+bool MCCFRSolver::warmStart(const MCCFRSolver& previous) {
+    // Same root position and ranges; only the bet sizing may differ
+    const auto& root = initialState_;
+    const auto& oldRoot = previous.initialState_;
+    if (root.board() != oldRoot.board() || root.pot() != oldRoot.pot() ||
+        root.oopStack() != oldRoot.oopStack() || root.ipStack() != oldRoot.ipStack() ||
+        root.actionHistory().size() != oldRoot.actionHistory().size()) {
+        return false;
+    }
+    return gameTree_.warmStart(previous.gameTree_);
 }
 
-void MCCFRSolver::solve() {
-    for (int i = 0; i < config_.numIterations && !shouldStop_; ++i) {
-        runIteration();
+void MCCFRSolver::buildCombos(Position player) {
+    auto& combos = combos_[static_cast<int>(player)];
+    combos.clear();
+    
+    std::vector<double> weights;
+    const auto& comboWeights = comboWeights_[static_cast<int>(player)];
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        core::Hand hand = core::Hand::fromComboIndex(combo);
+        if (comboWeights[combo] <= 0 || gameTree_.slots(player, 0).slotOf(hand) < 0) continue;
         
-        if (progressCallback_ && 
-            (i % config_.progressCallbackFrequency == 0 || i == config_.numIterations - 1)) {
-            reportProgress();
+        RangeCombo entry{hand, {}, combo};
+        for (int level = 0; level < 3; ++level) {
+            entry.slot[level] = gameTree_.slots(player, level).slotOf(hand);
+        }
+        combos.push_back(entry);
+        weights.push_back(comboWeights[combo]);
+    }
+    
+    comboDists_[static_cast<int>(player)] =
+        std::discrete_distribution<int>(weights.begin(), weights.end());
+}
+
+const char* stopReasonToString(StopReason reason) {
+    switch (reason) {
+        case StopReason::ITERATIONS: return "iterations reached";
+        case StopReason::TIME_BUDGET: return "time budget spent";
+        case StopReason::TARGET: return "target exploitability reached";
+        case StopReason::STOPPED: return "stopped";
+        case StopReason::NO_DEAL: return "no valid deal";
+        default: return "unknown";
+    }
+}
+
+SolveResult MCCFRSolver::solve() {
+    // Checkpoints and progress reports come before the stopping rules, so
+    // a target check can reuse the report's measurement
+    SolveLoop loop(*this);
+    while (loop.step()) {
+        if (!checkpointPath_.empty() && loop.crossed(checkpointFrequency_)) {
+            saveCheckpoint(checkpointPath_);
         }
+        if (progressCallback_ && loop.crossed(config_.progressCallbackFrequency)) {
+            loop.measure();
+            reportProgress(loop.exploitability(), loop.measuredAt(), false);
+        }
+        if (loop.shouldStop()) break;
     }
     
+    // The final strategy is measured only when something already asked for
+    // a best response: on a flop one costs seconds
+    SolveResult result;
+    result.reason = loop.reason();
+    result.iterations = iteration_;
+    if (loop.measured() || progressCallback_) {
+        loop.measureNow();
+    }
+    result.measured = loop.measured();
+    result.exploitability = loop.exploitability();
+    result.seconds = loop.seconds();
     if (progressCallback_) {
-        SolveProgress progress;
-        progress.currentIteration = iteration_;
-        progress.totalIterations = config_.numIterations;
-        progress.exploitability = getExploitability();
-        progress.complete = true;
-        progress.status = "Complete";
-        progressCallback_(progress);
+        reportProgress(result.exploitability, loop.measuredAt(), true);
     }
+    return result;
 }
 
 void MCCFRSolver::runIteration() {
-    auto& rng = rngs_[0];  // Single-threaded
-    
-    // Get dead cards (board)
-    std::vector<core::Card> deadCards = initialState_.board();
-    
-    // Sample hands for both players
-    core::Hand oopHand = sampleHand(oopRange_, deadCards, rng);
-    
-    // Add OOP's hand to dead cards
-    std::vector<core::Card> deadForIP = deadCards;
-    deadForIP.push_back(oopHand.card1());
-    deadForIP.push_back(oopHand.card2());
+    if (gameTree_.empty()) return;
     
-    core::Hand ipHand = sampleHand(ipRange_, deadForIP, rng);
-    
-    if (!oopHand.isValid() || !ipHand.isValid()) {
+    if (config_.sampling == SamplingScheme::VANILLA && !isSubgame()) {
+        vanillaIteration();
+    } else if (!sampledIteration(iteration_, rngs_[0], nullptr)) {
         return;  // No valid hand combinations available
     }
-    
-    // Run CFR for both players
-    externalSample(initialState_, oopHand, ipHand, Position::OOP, 1.0, 1.0, rng);
-    externalSample(initialState_, oopHand, ipHand, Position::IP, 1.0, 1.0, rng);
-    
     ++iteration_;
     
     // Apply discounting periodically
@@ -84,90 +182,346 @@ void MCCFRSolver::runIteration() {
     }
 }
 
-double MCCFRSolver::externalSample(const GameState& state,
-                                    const core::Hand& oopHand,
-                                    const core::Hand& ipHand,
-                                    Position traversingPlayer,
-                                    double oopReach,
-                                    double ipReach,
-                                    std::mt19937& rng) {
-    // Terminal node: return payoff
-    if (state.isTerminal()) {
-        const auto& evaluator = ompeval::HandEvaluator::instance();
-        
-        // Check for fold
-        if (!state.hasShowdown()) {
-            // Someone folded - the other player wins the pot
-            Position folder = state.foldedPlayer();
-            double pot = state.pot();
-            double oopPayoff = 0;
-            
-            if (folder == Position::IP) {
-                // IP folded: OOP wins the pot
-                oopPayoff = pot - state.oopInvested();
-            } else {
-                // OOP folded: OOP loses their investment
-                oopPayoff = -state.oopInvested();
+int MCCFRSolver::stepSize() const {
+    if (config_.sampling == SamplingScheme::VANILLA && !isSubgame()) return 1;
+    return config_.numThreads > 0 ? config_.numThreads : TaskPool::shared().numThreads();
+}
+
+void MCCFRSolver::runIterations(int count) {
+    int step = stepSize();
+    if (step == 1) {
+        for (int i = 0; i < count; ++i) runIteration();
+        return;
+    }
+    if (gameTree_.empty()) return;
+    
+    // Each iteration of a step draws from its own generator, the extra
+    // ones seeded from the first so a seeded solve stays reproducible
+    while (static_cast<int>(rngs_.size()) < step) {
+        rngs_.emplace_back(rngs_[0]());
+    }
+    std::vector<Updates> updates(step);
+    std::vector<char> dealt(step);
+    
+    for (int done = 0; done < count;) {
+        int batch = std::min(step, count - done);
+        int first = iteration_;
+        {
+            TaskGroup group(TaskPool::shared());
+            for (int t = 0; t < batch; ++t) {
+                group.run([this, &updates, &dealt, first, t]() {
+                    dealt[t] = sampledIteration(first + t, rngs_[t], &updates[t]);
+                });
             }
-            
-            return (traversingPlayer == Position::OOP) ? oopPayoff : -oopPayoff;
+            group.wait();
         }
         
-        // Showdown: evaluate hands
-        std::vector<int> oopCards = {
-            oopHand.card1().value(), oopHand.card2().value()
-        };
-        std::vector<int> ipCards = {
-            ipHand.card1().value(), ipHand.card2().value()
-        };
-        
-        for (const auto& card : state.board()) {
-            oopCards.push_back(card.value());
-            ipCards.push_back(card.value());
+        // Applied as if the iterations had run one after another, except
+        // that each played the strategy the step started from
+        int applied = 0;
+        for (int t = 0; t < batch; ++t) {
+            if (!dealt[t]) continue;
+            applyUpdates(updates[t]);
+            updates[t].clear();
+            ++applied;
+            ++iteration_;
+            if (config_.useDiscounting && iteration_ % 100 == 0) {
+                applyDiscounting();
+            }
+        }
+        if (applied == 0) return;  // No valid hand combinations available
+        done += batch;
+    }
+}
+
+bool MCCFRSolver::sampledIteration(int iteration, std::mt19937& rng, Updates* updates) {
+    Deal deal;
+    if (!sampleDeal(deal, rng)) return false;
+    deal.updates = updates;
+    
+    Runout root = rootRunout_;
+    root.dead |= deal.dead;
+    
+    deal.prune = config_.sampling == SamplingScheme::EXTERNAL && config_.usePruning &&
+                 iteration >= config_.pruningWarmup &&
+                 (config_.fullTraversalInterval <= 0 || iteration % config_.fullTraversalInterval != 0);
+    
+    // Run CFR for both players
+    for (Position traverser : {Position::OOP, Position::IP}) {
+        if (isSubgame()) {
+            gadgetSample(deal, root, traverser, rng);
+        } else if (config_.sampling == SamplingScheme::OUTCOME) {
+            double tailReach = 1.0;
+            outcomeSample(0, deal, root, traverser, 1.0, 1.0, 1.0, tailReach, rng);
+        } else {
+            traverse(0, deal, root, traverser, 1.0, 1.0, rng);
+        }
+    }
+    return true;
+}
+
+double* MCCFRSolver::pendingAmounts(Updates& updates, const TreeNode& node, int runout, int slot) const {
+    int nodeIndex = static_cast<int>(&node - gameTree_.nodes().data());
+    auto [it, inserted] = updates.index.try_emplace(infoSetKey(nodeIndex, runout, slot),
+                                                    updates.infoSets.size());
+    if (inserted) {
+        updates.infoSets.push_back({&node, runout, slot, updates.amounts.size()});
+        updates.amounts.resize(updates.amounts.size() + 2 * node.numActions, 0.0);
+    }
+    return updates.amounts.data() + updates.infoSets[it->second].offset;
+}
+
+void MCCFRSolver::addRegrets(const Deal& deal, const TreeNode& node, int runout, int slot,
+                             const double* delta) {
+    if (!deal.updates) {
+        gameTree_.addRegrets(node, runout, slot, delta);
+        return;
+    }
+    double* regrets = pendingAmounts(*deal.updates, node, runout, slot);
+    for (int a = 0; a < node.numActions; ++a) {
+        regrets[a] += delta[a];
+    }
+}
+
+void MCCFRSolver::addStrategy(const Deal& deal, const TreeNode& node, int runout, int slot,
+                              const double* played) {
+    if (!deal.updates) {
+        gameTree_.addStrategy(node, runout, slot, played, iteration_);
+        return;
+    }
+    double* strategy = pendingAmounts(*deal.updates, node, runout, slot) + node.numActions;
+    for (int a = 0; a < node.numActions; ++a) {
+        strategy[a] += played[a];
+    }
+}
+
+void MCCFRSolver::applyUpdates(const Updates& updates, Updates* into) {
+    for (const auto& infoSet : updates.infoSets) {
+        const TreeNode& node = *infoSet.node;
+        const double* amounts = updates.amounts.data() + infoSet.offset;
+        if (into) {
+            double* to = pendingAmounts(*into, node, infoSet.runout, infoSet.slot);
+            for (int i = 0; i < 2 * node.numActions; ++i) {
+                to[i] += amounts[i];
+            }
+        } else {
+            gameTree_.addRegrets(node, infoSet.runout, infoSet.slot, amounts);
+            gameTree_.addStrategy(node, infoSet.runout, infoSet.slot, amounts + node.numActions, iteration_);
+        }
+    }
+    if (into) {
+        into->gadget.insert(into->gadget.end(), updates.gadget.begin(), updates.gadget.end());
+        return;
+    }
+    for (const auto& [combo, delta] : updates.gadget) {
+        double* regrets = &gadgetRegrets_[combo * 2];
+        regrets[0] = std::max(0.0, regrets[0] + delta[0]);
+        regrets[1] = std::max(0.0, regrets[1] + delta[1]);
+    }
+}
+
+bool MCCFRSolver::sampleDeal(Deal& deal, std::mt19937& rng) {
+    const auto& oopCombos = combos_[static_cast<int>(Position::OOP)];
+    const auto& ipCombos = combos_[static_cast<int>(Position::IP)];
+    if (oopCombos.empty() || ipCombos.empty()) return false;
+    
+    // Rejection sampling draws IP from its range conditioned on OOP's cards
+    const int maxAttempts = 1000;
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        const auto& oop = oopCombos[comboDists_[static_cast<int>(Position::OOP)](rng)];
+        const auto& ip = ipCombos[comboDists_[static_cast<int>(Position::IP)](rng)];
+        if (ip.hand.contains(oop.hand.card1()) || ip.hand.contains(oop.hand.card2())) {
+            continue;
         }
         
-        auto oopEval = evaluator.evaluate(oopCards);
-        auto ipEval = evaluator.evaluate(ipCards);
+        for (int level = 0; level < 3; ++level) {
+            deal.slot[level][static_cast<int>(Position::OOP)] = oop.slot[level];
+            deal.slot[level][static_cast<int>(Position::IP)] = ip.slot[level];
+        }
+        deal.combo[static_cast<int>(Position::OOP)] = oop.combo;
+        deal.combo[static_cast<int>(Position::IP)] = ip.combo;
+        deal.dead = uint64_t{1} << oop.hand.card1().value() | uint64_t{1} << oop.hand.card2().value() |
+                    uint64_t{1} << ip.hand.card1().value() | uint64_t{1} << ip.hand.card2().value();
+        deal.weight = 1.0;
         
-        // Calculate net payoff: winner gets pot minus their investment
-        // Pot = oopInvested + ipInvested
-        // If OOP wins: they get the pot, net = pot - oopInvested = ipInvested
-        // If IP wins: OOP loses their investment, net = -oopInvested
-        double oopPayoff = 0;
-        if (oopEval > ipEval) {
-            // OOP wins: gets pot minus their investment
-            oopPayoff = state.pot() - state.oopInvested();
-        } else if (ipEval > oopEval) {
-            // IP wins: OOP loses their investment
-            oopPayoff = -state.oopInvested();
+        // Public chance sampling: fix this iteration's turn and river up front
+        uint64_t used = rootRunout_.dead | deal.dead;
+        for (int& card : deal.publicCards) {
+            std::uniform_int_distribution<int> pick(0, core::NUM_CARDS - 1);
+            do {
+                card = pick(rng);
+            } while (used >> card & 1);
+            used |= uint64_t{1} << card;
         }
-        // Tie: split pot, each gets their investment back (net = 0)
+        return true;
+    }
+    return false;
+}
+
+double MCCFRSolver::gadgetSample(const Deal& deal,
+                                  const Runout& runout,
+                                  Position traversingPlayer,
+                                  std::mt19937& rng) {
+    // Per combo, the constrained player either terminates and takes its
+    // blueprint value, or follows into the subgame. Following can never be
+    // worth more than the blueprint allowed, so the re-solved strategy of
+    // the other player is no more exploitable than the blueprint's.
+    int combo = deal.combo[static_cast<int>(gadgetPlayer_)];
+    const double* regrets = &gadgetRegrets_[combo * 2];
+    double strategy[2];
+    GameTree::regretMatching(regrets, 2, strategy);
+    double terminate = gadgetValues_[combo];
+    
+    // The constrained player's reach into the subgame is its follow probability
+    double oopReach = (gadgetPlayer_ == Position::OOP) ? strategy[1] : 1.0;
+    double ipReach = (gadgetPlayer_ == Position::IP) ? strategy[1] : 1.0;
+    
+    if (traversingPlayer == gadgetPlayer_) {
+        double follow = externalSample(0, deal, runout, traversingPlayer, oopReach, ipReach, rng);
+        double value = strategy[0] * terminate + strategy[1] * follow;
         
-        return (traversingPlayer == Position::OOP) ? oopPayoff : -oopPayoff;
+        // Regret matching+ on the two gadget actions
+        if (deal.updates) {
+            deal.updates->gadget.push_back({combo, {terminate - value, follow - value}});
+        } else {
+            gadgetRegrets_[combo * 2] = std::max(0.0, regrets[0] + terminate - value);
+            gadgetRegrets_[combo * 2 + 1] = std::max(0.0, regrets[1] + follow - value);
+        }
+        return value;
     }
     
-    // Get available actions
-    auto actions = state.getAvailableActions();
-    if (actions.empty()) return 0;
+    // Other player: sample the constrained player's gadget action
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    if (unit(rng) < strategy[0]) {
+        return -terminate;
+    }
+    return externalSample(0, deal, runout, traversingPlayer, oopReach, ipReach, rng);
+}
+
+MCCFRSolver::Runout MCCFRSolver::dealCard(const Runout& runout, int card) const {
+    Runout next = runout;
+    next.id = GameTree::nextRunout(runout.id, card);
+    next.board[next.boardSize++] = core::Card(card);
+    next.dead |= uint64_t{1} << card;
+    next.strengths = &strengthCache_.get(next.board, next.boardSize);
+    return next;
+}
+
+double MCCFRSolver::sampleChance(const TreeNode& node,
+                                  const Deal& deal,
+                                  const Runout& runout,
+                                  Position traversingPlayer,
+                                  double oopReach,
+                                  double ipReach,
+                                  std::mt19937& rng) {
+    // VANILLA deals every card whatever the chance sampling
+    bool enumerate = config_.sampling == SamplingScheme::VANILLA && !isSubgame();
+    if (!enumerate && config_.chanceSampling == ChanceSampling::PUBLIC_SAMPLING) {
+        int card = deal.publicCards[runout.boardSize - rootRunout_.boardSize];
+        return traverse(node.firstChild, deal, dealCard(runout, card),
+                        traversingPlayer, oopReach, ipReach, rng);
+    }
+    
+    int cards[core::NUM_CARDS];
+    int numCards = 0;
+    for (int card = 0; card < core::NUM_CARDS; ++card) {
+        if (!(runout.dead >> card & 1)) cards[numCards++] = card;
+    }
+    
+    // Sampled runouts: a partial shuffle picks distinct cards
+    int numDealt = numCards;
+    if (!enumerate && config_.chanceSampling == ChanceSampling::SAMPLED_RUNOUTS) {
+        numDealt = std::clamp(config_.sampledRunouts, 1, numCards);
+        for (int i = 0; i < numDealt; ++i) {
+            std::uniform_int_distribution<int> pick(i, numCards - 1);
+            std::swap(cards[i], cards[pick(rng)]);
+        }
+    }
+    
+    // Each dealt card is equally likely, so the node value is their mean.
+    // Cards go in chunks of about PARALLEL_GRAIN work onto their own tasks
+    // when there are two or more; the tasks' updates wait in their own
+    // buffers, which no sibling reads, and are applied in card order.
+    double perCard = work_[node.firstChild] + 1;
+    int chunk = static_cast<int>(std::max(1.0, std::ceil(PARALLEL_GRAIN / perCard)));
+    int numChunks = (numDealt + chunk - 1) / chunk;
+    if (config_.numThreads == 1 || numChunks < 2) {
+        double value = 0;
+        for (int i = 0; i < numDealt; ++i) {
+            value += traverse(node.firstChild, deal, dealCard(runout, cards[i]),
+                              traversingPlayer, oopReach, ipReach, rng);
+        }
+        return value / numDealt;
+    }
+    
+    std::vector<double> values(numChunks, 0.0);
+    std::vector<Updates> updates(numChunks);
+    std::vector<std::mt19937> rngs;
+    for (int k = 0; k < numChunks; ++k) {
+        rngs.emplace_back(rng());
+    }
+    {
+        TaskGroup group(TaskPool::shared());
+        for (int k = 0; k < numChunks; ++k) {
+            group.run([&, k]() {
+                Deal local = deal;
+                local.updates = &updates[k];
+                for (int i = k * chunk; i < std::min(numDealt, (k + 1) * chunk); ++i) {
+                    values[k] += traverse(node.firstChild, local, dealCard(runout, cards[i]),
+                                          traversingPlayer, oopReach, ipReach, rngs[k]);
+                }
+            });
+        }
+        group.wait();
+    }
+    double value = 0;
+    for (int k = 0; k < numChunks; ++k) {
+        value += values[k];
+        applyUpdates(updates[k], deal.updates);
+    }
+    return value / numDealt;
+}
+
+double MCCFRSolver::externalSample(int nodeIndex,
+                                    const Deal& deal,
+                                    const Runout& runout,
+                                    Position traversingPlayer,
+                                    double oopReach,
+                                    double ipReach,
+                                    std::mt19937& rng) {
+    const TreeNode& node = gameTree_.node(nodeIndex);
     
-    Position currentPlayer = state.currentPlayer();
-    const core::Hand& currentHand = (currentPlayer == Position::OOP) ? oopHand : ipHand;
+    // Terminal node: return payoff
+    if (node.isLeaf()) {
+        return leafPayoff(node, deal, runout, traversingPlayer);
+    }
     
-    // Get info set
-    auto infoSet = getInfoSet(currentPlayer, currentHand, state);
-    if (infoSet->numActions() != static_cast<int>(actions.size())) {
-        infoSet->setNumActions(static_cast<int>(actions.size()));
+    if (node.type == NodeType::CHANCE) {
+        return sampleChance(node, deal, runout, traversingPlayer, oopReach, ipReach, rng);
     }
     
-    const auto& strategy = infoSet->getStrategy();
+    Position currentPlayer = node.player;
+    int slot = deal.slot[node.level][static_cast<int>(currentPlayer)];
+    int numActions = node.numActions;
+    
+    double regrets[MAX_ACTIONS];
+    double strategy[MAX_ACTIONS];
+    gameTree_.loadRegrets(node, runout.id, slot, regrets);
+    GameTree::regretMatching(regrets, numActions, strategy);
     
     if (currentPlayer == traversingPlayer) {
         // Traversing player: compute counterfactual values for all actions
-        std::vector<double> actionValues(actions.size());
+        double actionValues[MAX_ACTIONS];
+        bool explored[MAX_ACTIONS];
         double nodeValue = 0;
         
-        for (size_t a = 0; a < actions.size(); ++a) {
-            GameState nextState = state.afterAction(actions[a]);
+        for (int a = 0; a < numActions; ++a) {
+            // Skip hopeless actions. Only actions regret matching does not
+            // play are skipped, so the node value is unchanged; leaves are
+            // cheap and always evaluated.
+            explored[a] = !deal.prune || regrets[a] >= config_.pruningThreshold ||
+                          strategy[a] > 0 || gameTree_.node(node.firstChild + a).isLeaf();
+            if (!explored[a]) continue;
             
             double newOopReach = oopReach;
             double newIpReach = ipReach;
@@ -178,29 +532,41 @@ double MCCFRSolver::externalSample(const GameState& state,
                 newIpReach *= strategy[a];
             }
             
-            actionValues[a] = externalSample(nextState, oopHand, ipHand,
-                                              traversingPlayer, newOopReach, newIpReach, rng);
+            actionValues[a] = externalSample(node.firstChild + a, deal, runout,
+                                             traversingPlayer, newOopReach, newIpReach, rng);
             nodeValue += strategy[a] * actionValues[a];
         }
         
-        // Update regrets
-        double opponentReach = (currentPlayer == Position::OOP) ? ipReach : oopReach;
-        for (size_t a = 0; a < actions.size(); ++a) {
-            double regret = opponentReach * (actionValues[a] - nodeValue);
-            infoSet->addRegret(static_cast<int>(a), regret);
+        // Update regrets of the explored actions. The opponent's actions and
+        // the deal were sampled with their reach, so the sampled values are
+        // already counterfactual: weighting by the reach again would count it twice.
+        double delta[MAX_ACTIONS];
+        for (int a = 0; a < numActions; ++a) {
+            delta[a] = explored[a] ? actionValues[a] - nodeValue : 0.0;
         }
+        addRegrets(deal, node, runout.id, slot, delta);
         
-        // Update strategy using regret matching
-        infoSet->updateStrategy();
-        infoSet->accumulateStrategy({oopReach, ipReach});
+        // Accumulate the strategy played, weighted by own reach
+        double ownReach = (currentPlayer == Position::OOP) ? oopReach : ipReach;
+        double played[MAX_ACTIONS];
+        for (int a = 0; a < numActions; ++a) {
+            played[a] = ownReach * strategy[a];
+        }
+        addStrategy(deal, node, runout.id, slot, played);
         
         return nodeValue;
     } else {
         // Opponent: sample action according to strategy (external sampling)
-        std::discrete_distribution<int> dist(strategy.begin(), strategy.end());
-        int sampledAction = dist(rng);
-        
-        GameState nextState = state.afterAction(actions[sampledAction]);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double r = unit(rng);
+        int sampledAction = numActions - 1;
+        for (int a = 0; a < numActions - 1; ++a) {
+            r -= strategy[a];
+            if (r < 0) {
+                sampledAction = a;
+                break;
+            }
+        }
         
         double newOopReach = oopReach;
         double newIpReach = ipReach;
@@ -211,71 +577,250 @@ double MCCFRSolver::externalSample(const GameState& state,
             newIpReach *= strategy[sampledAction];
         }
         
-        return externalSample(nextState, oopHand, ipHand,
+        return externalSample(node.firstChild + sampledAction, deal, runout,
                               traversingPlayer, newOopReach, newIpReach, rng);
     }
 }
 
-std::shared_ptr<InfoSet> MCCFRSolver::getInfoSet(Position player,
-                                                   const core::Hand& hand,
-                                                   const GameState& state) {
-    std::string key = makeInfoSetKey(player, hand, state);
-    auto actions = state.getAvailableActions();
-    return gameTree_.getOrCreateInfoSet(player, key, static_cast<int>(actions.size()));
+double MCCFRSolver::leafPayoff(const TreeNode& node, const Deal& deal, const Runout& runout,
+                               Position traversingPlayer) const {
+    if (node.isEstimated()) {
+        // Depth limit: OOP's chips in the pot plus its estimated return
+        double oopPayoff = node.oopPayoff(0) +
+            leafEstimator_->value(node, runout.board, runout.boardSize,
+                                  deal.combo[static_cast<int>(Position::OOP)],
+                                  deal.combo[static_cast<int>(Position::IP)]);
+        return (traversingPlayer == Position::OOP) ? oopPayoff : -oopPayoff;
+    }
+    
+    int showdown = 0;
+    if (node.showdown) {
+        int oopStrength = (*runout.strengths)[deal.combo[static_cast<int>(Position::OOP)]];
+        int ipStrength = (*runout.strengths)[deal.combo[static_cast<int>(Position::IP)]];
+        showdown = (oopStrength > ipStrength) - (ipStrength > oopStrength);
+    }
+    double oopPayoff = node.oopPayoff(showdown);
+    return (traversingPlayer == Position::OOP) ? oopPayoff : -oopPayoff;
+}
+
+double MCCFRSolver::traverse(int nodeIndex,
+                              const Deal& deal,
+                              const Runout& runout,
+                              Position traversingPlayer,
+                              double oopReach,
+                              double ipReach,
+                              std::mt19937& rng) {
+    if (config_.sampling == SamplingScheme::EXTERNAL || isSubgame()) {
+        return externalSample(nodeIndex, deal, runout, traversingPlayer, oopReach, ipReach, rng);
+    }
+    return fullTraversal(nodeIndex, deal, runout, traversingPlayer, oopReach, ipReach, rng);
 }
 
-std::string MCCFRSolver::makeInfoSetKey(Position player,
-                                         const core::Hand& hand,
-                                         const GameState& state) const {
-    std::string key;
-    key.reserve(64);
+double MCCFRSolver::fullTraversal(int nodeIndex,
+                                   const Deal& deal,
+                                   const Runout& runout,
+                                   Position traversingPlayer,
+                                   double oopReach,
+                                   double ipReach,
+                                   std::mt19937& rng) {
+    const TreeNode& node = gameTree_.node(nodeIndex);
+    if (node.isLeaf()) {
+        return leafPayoff(node, deal, runout, traversingPlayer);
+    }
+    if (node.type == NodeType::CHANCE) {
+        return sampleChance(node, deal, runout, traversingPlayer, oopReach, ipReach, rng);
+    }
     
-    // Position
-    key += (player == Position::OOP) ? 'O' : 'I';
-    key += ':';
+    Position currentPlayer = node.player;
+    int slot = deal.slot[node.level][static_cast<int>(currentPlayer)];
+    int numActions = node.numActions;
+    
+    double regrets[MAX_ACTIONS];
+    double strategy[MAX_ACTIONS];
+    gameTree_.loadRegrets(node, runout.id, slot, regrets);
+    GameTree::regretMatching(regrets, numActions, strategy);
+    
+    // Both players' actions are walked; the opponent's are weighted by its strategy
+    double actionValues[MAX_ACTIONS];
+    double nodeValue = 0;
+    for (int a = 0; a < numActions; ++a) {
+        double newOopReach = (currentPlayer == Position::OOP) ? oopReach * strategy[a] : oopReach;
+        double newIpReach = (currentPlayer == Position::IP) ? ipReach * strategy[a] : ipReach;
+        actionValues[a] = fullTraversal(node.firstChild + a, deal, runout,
+                                        traversingPlayer, newOopReach, newIpReach, rng);
+        nodeValue += strategy[a] * actionValues[a];
+    }
+    if (currentPlayer != traversingPlayer) return nodeValue;
+    
+    // VANILLA deals carry pendingRegrets_ or a chunk's buffer, so their
+    // regrets wait until every deal is walked
+    double opponentReach = deal.weight * ((currentPlayer == Position::OOP) ? ipReach : oopReach);
+    double ownReach = deal.weight * ((currentPlayer == Position::OOP) ? oopReach : ipReach);
+    double delta[MAX_ACTIONS];
+    for (int a = 0; a < numActions; ++a) {
+        delta[a] = opponentReach * (actionValues[a] - nodeValue);
+    }
+    addRegrets(deal, node, runout.id, slot, delta);
     
-    // Hand (canonical name)
-    key += hand.canonicalName();
-    key += ':';
+    // Strategy sums do not feed back into this iteration's strategy
+    double played[MAX_ACTIONS];
+    for (int a = 0; a < numActions; ++a) {
+        played[a] = ownReach * strategy[a];
+    }
+    addStrategy(deal, node, runout.id, slot, played);
+    return nodeValue;
+}
+
+double MCCFRSolver::outcomeSample(int nodeIndex,
+                                   const Deal& deal,
+                                   const Runout& runout,
+                                   Position traversingPlayer,
+                                   double ownReach,
+                                   double oppReach,
+                                   double sampleReach,
+                                   double& tailReach,
+                                   std::mt19937& rng) {
+    const TreeNode& node = gameTree_.node(nodeIndex);
+    if (node.isLeaf()) {
+        tailReach = 1.0;
+        return leafPayoff(node, deal, runout, traversingPlayer) / sampleReach;
+    }
+    if (node.type == NodeType::CHANCE) {
+        // Cards are dealt with their own probability, which cancels out
+        int card = deal.publicCards[runout.boardSize - rootRunout_.boardSize];
+        return outcomeSample(node.firstChild, deal, dealCard(runout, card), traversingPlayer,
+                             ownReach, oppReach, sampleReach, tailReach, rng);
+    }
     
-    // Board cards
-    for (const auto& card : state.board()) {
-        key += card.toString();
+    Position currentPlayer = node.player;
+    int slot = deal.slot[node.level][static_cast<int>(currentPlayer)];
+    int numActions = node.numActions;
+    bool traversing = currentPlayer == traversingPlayer;
+    
+    double regrets[MAX_ACTIONS];
+    double strategy[MAX_ACTIONS];
+    gameTree_.loadRegrets(node, runout.id, slot, regrets);
+    GameTree::regretMatching(regrets, numActions, strategy);
+    
+    // The traverser explores so every action keeps being sampled
+    double sampling[MAX_ACTIONS] = {};
+    double epsilon = traversing ? config_.explorationEpsilon : 0.0;
+    for (int a = 0; a < numActions; ++a) {
+        sampling[a] = epsilon / numActions + (1.0 - epsilon) * strategy[a];
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double r = unit(rng);
+    int sampled = numActions - 1;
+    for (int a = 0; a < numActions - 1; ++a) {
+        r -= sampling[a];
+        if (r < 0) {
+            sampled = a;
+            break;
+        }
     }
-    key += ':';
     
-    // Action history
-    for (const auto& action : state.actionHistory()) {
-        key += std::to_string(static_cast<int>(action.type));
-        if (action.amount > 0) {
-            key += '_';
-            key += std::to_string(static_cast<int>(action.amount));
+    double value = outcomeSample(node.firstChild + sampled, deal, runout, traversingPlayer,
+                                 traversing ? ownReach * strategy[sampled] : ownReach,
+                                 traversing ? oppReach : oppReach * strategy[sampled],
+                                 sampleReach * sampling[sampled], tailReach, rng);
+    
+    if (traversing) {
+        // Sampled regret: the payoff reached through each action, less the
+        // payoff reached from the node, over the sampling probability
+        double weighted = value * oppReach;
+        double delta[MAX_ACTIONS];
+        for (int a = 0; a < numActions; ++a) {
+            delta[a] = (a == sampled) ? weighted * tailReach * (1.0 - strategy[sampled])
+                                      : -weighted * tailReach * strategy[sampled];
+        }
+        addRegrets(deal, node, runout.id, slot, delta);
+        
+        // Stochastically weighted averaging
+        double played[MAX_ACTIONS];
+        for (int a = 0; a < numActions; ++a) {
+            played[a] = ownReach / sampleReach * strategy[a];
         }
-        key += ',';
+        addStrategy(deal, node, runout.id, slot, played);
     }
     
-    return key;
+    tailReach *= strategy[sampled];
+    return value;
 }
 
-core::Hand MCCFRSolver::sampleHand(const core::Range& range,
-                                    const std::vector<core::Card>& deadCards,
-                                    std::mt19937& rng) {
-    auto hands = range.getAvailableHands(deadCards);
-    if (hands.empty()) {
-        return core::Hand();  // Invalid hand
+void MCCFRSolver::vanillaIteration() {
+    const auto& oopCombos = combos_[static_cast<int>(Position::OOP)];
+    const auto& ipCombos = combos_[static_cast<int>(Position::IP)];
+    const auto& oopWeights = comboWeights_[static_cast<int>(Position::OOP)];
+    const auto& ipWeights = comboWeights_[static_cast<int>(Position::IP)];
+    
+    // Deals are weighted relative to their mean, so one deal counts about
+    // as much as a sampled one
+    std::vector<Deal> deals;
+    double totalWeight = 0;
+    for (const auto& oop : oopCombos) {
+        for (const auto& ip : ipCombos) {
+            if (ip.hand.contains(oop.hand.card1()) || ip.hand.contains(oop.hand.card2())) continue;
+            
+            Deal deal{};
+            for (int level = 0; level < 3; ++level) {
+                deal.slot[level][static_cast<int>(Position::OOP)] = oop.slot[level];
+                deal.slot[level][static_cast<int>(Position::IP)] = ip.slot[level];
+            }
+            deal.combo[static_cast<int>(Position::OOP)] = oop.combo;
+            deal.combo[static_cast<int>(Position::IP)] = ip.combo;
+            deal.dead = uint64_t{1} << oop.hand.card1().value() | uint64_t{1} << oop.hand.card2().value() |
+                        uint64_t{1} << ip.hand.card1().value() | uint64_t{1} << ip.hand.card2().value();
+            deal.prune = false;
+            deal.weight = oopWeights[oop.combo] * ipWeights[ip.combo];
+            totalWeight += deal.weight;
+            deals.push_back(deal);
+        }
     }
-    
-    // Weight by range frequency
-    std::vector<double> weights;
-    weights.reserve(hands.size());
-    for (const auto& [hand, weight] : hands) {
-        weights.push_back(weight);
+    if (deals.empty() || totalWeight <= 0) return;
+    for (auto& deal : deals) {
+        deal.weight *= deals.size() / totalWeight;
     }
     
-    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
-    size_t idx = dist(rng);
+    // Unless numThreads is 1, the deals are walked in VANILLA_CHUNKS
+    // chunks on their own tasks, each with its own buffer and generator
+    int numChunks = config_.numThreads == 1 ? 1 : std::min<int>(VANILLA_CHUNKS, static_cast<int>(deals.size()));
+    std::vector<Updates> updates(numChunks > 1 ? numChunks : 0);
+    std::vector<std::mt19937> rngs;
+    for (int k = 0; k < numChunks; ++k) {
+        rngs.emplace_back(rngs_[0]());
+    }
     
-    return hands[idx].first;
+    for (Position traverser : {Position::OOP, Position::IP}) {
+        auto walk = [&](int k, Updates* into) {
+            size_t begin = deals.size() * k / numChunks;
+            size_t end = deals.size() * (k + 1) / numChunks;
+            for (size_t i = begin; i < end; ++i) {
+                Deal deal = deals[i];
+                deal.updates = into;
+                Runout root = rootRunout_;
+                root.dead |= deal.dead;
+                fullTraversal(0, deal, root, traverser, 1.0, 1.0, rngs[k]);
+            }
+        };
+        
+        if (numChunks == 1) {
+            walk(0, &pendingRegrets_);
+        } else {
+            {
+                TaskGroup group(TaskPool::shared());
+                for (int k = 0; k < numChunks; ++k) {
+                    group.run([&, k]() { walk(k, &updates[k]); });
+                }
+                group.wait();
+            }
+            for (auto& chunk : updates) {
+                applyUpdates(chunk, &pendingRegrets_);
+                chunk.clear();
+            }
+        }
+        applyUpdates(pendingRegrets_);
+        pendingRegrets_.clear();
+    }
 }
 
 void MCCFRSolver::applyDiscounting() {
@@ -287,22 +832,20 @@ void MCCFRSolver::applyDiscounting() {
                          (std::pow(t, config_.discountBeta) + 1);
     double stratDiscount = std::pow(t / (t + 1), config_.discountGamma);
     
-    for (auto& [key, infoSet] : gameTree_.getInfoSets()) {
-        // Discounting is applied internally to regrets
-        // This is a simplified version
-        infoSet->updateStrategy();
-    }
+    gameTree_.discount(posDiscount, negDiscount, stratDiscount);
 }
 
-void MCCFRSolver::reportProgress() {
+void MCCFRSolver::reportProgress(const ExploitabilityReport& report, int measuredAt, bool complete) {
     if (!progressCallback_) return;
     
     SolveProgress progress;
     progress.currentIteration = iteration_;
     progress.totalIterations = config_.numIterations;
-    progress.exploitability = getExploitability();
-    progress.complete = false;
-    progress.status = "Solving...";
+    progress.exploitability = report.bb;
+    progress.exploitabilityPctPot = report.percentPot;
+    progress.measuredIteration = measuredAt;
+    progress.complete = complete;
+    progress.status = complete ? "Complete" : "Solving...";
     
     progressCallback_(progress);
 }
@@ -311,24 +854,34 @@ void MCCFRSolver::reset() {
     iteration_ = 0;
     shouldStop_ = false;
     gameTree_.clearInfoSets();
+    std::fill(gadgetRegrets_.begin(), gadgetRegrets_.end(), 0.0);
+}
+
+std::vector<double> MCCFRSolver::getAverageStrategy(Position player,
+                                                     const core::Hand& hand,
+                                                     const GameState& state) const {
+    int runout = 0;
+    int nodeIndex = gameTree_.findNode(state, runout);
+    if (nodeIndex >= 0) {
+        const TreeNode& node = gameTree_.node(nodeIndex);
+        int slot = gameTree_.slots(player, node.level).slotOf(hand);
+        if (node.type == NodeType::PLAYER && node.player == player && slot >= 0) {
+            std::vector<double> strategy(node.numActions);
+            gameTree_.averageStrategy(node, runout, slot, strategy.data());
+            return strategy;
+        }
+    }
+    
+    // No info set found - return uniform strategy
+    auto actions = state.getAvailableActions();
+    if (actions.empty()) return {};
+    return std::vector<double>(actions.size(), 1.0 / actions.size());
 }
 
 NodeStrategy MCCFRSolver::getStrategy(Position player, const core::Hand& hand) const {
     NodeStrategy result;
     result.handType = hand.canonicalName();
-    
-    std::string key = makeInfoSetKey(player, hand, initialState_);
-    
-    auto& infoSets = gameTree_.getInfoSets();
-    auto it = infoSets.find(key);
-    
-    if (it != infoSets.end()) {
-        result.actionProbabilities = it->second->getAverageStrategy();
-    } else {
-        // No info set found - return uniform strategy
-        auto actions = initialState_.getAvailableActions();
-        result.actionProbabilities.resize(actions.size(), 1.0 / actions.size());
-    }
+    result.actionProbabilities = getAverageStrategy(player, hand, initialState_);
     
     // Get action names
     auto actions = initialState_.getAvailableActions();
@@ -399,15 +952,20 @@ std::vector<double> MCCFRSolver::getAggregatedStrategy(Position player) const {
     return aggregated;
 }
 
+ExploitabilityReport MCCFRSolver::computeExploitability() const {
+    return BestResponse(*this).compute();
+}
+
 double MCCFRSolver::getExploitability() const {
-    // Simplified exploitability estimate
-    // In practice, this would require a full best-response calculation
-    
-    if (iteration_ == 0) return 1.0;
-    
-    // Use a heuristic based on iteration count
-    // Real exploitability converges roughly as 1/sqrt(iterations)
-    return 100.0 / std::sqrt(static_cast<double>(iteration_));
+    return computeExploitability().bb;
+}
+
+bool MCCFRSolver::saveCheckpoint(const std::string& path) const {
+    return Checkpoint::save(*this, path);
+}
+
+bool MCCFRSolver::loadCheckpoint(const std::string& path) {
+    return Checkpoint::load(*this, path);
 }
 
 // Helper function implementation
@@ -429,7 +987,7 @@ StrategyResult getStrategyResult(const MCCFRSolver& solver, Position player) {
     
     // Fill grid
     const core::Range& range = player == Position::OOP ? 
-                               solver.gameTree().getInfoSets().empty() ? core::Range() : core::Range() :
+                               solver.gameTree().empty() ? core::Range() : core::Range() :
                                core::Range();
     
     // Initialize grid with empty strategies
@@ -1,31 +1,106 @@
 #pragma once
 
+#include "abstraction.hpp"
+#include "cfr_engine.hpp"
 #include "game_tree.hpp"
 #include "game_state.hpp"
+#include "best_response.hpp"
+#include "checkpoint.hpp"
+#include "leaf_estimator.hpp"
+#include "strength_cache.hpp"
+#include "subgame.hpp"
 #include "core/range.hpp"
 #include "core/hand.hpp"
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <thread>
+#include <unordered_map>
 
 namespace solver {
 
+/**
+ * How turn and river cards are dealt at chance nodes
+ */
+enum class ChanceSampling {
+    FULL_ENUMERATION,  // Every remaining card
+    PUBLIC_SAMPLING,   // One card per street, shared by both traversals of an iteration
+    SAMPLED_RUNOUTS    // sampledRunouts distinct cards at each chance node
+};
+
+/**
+ * Units of an exploitability target
+ */
+enum class ExploitabilityUnit {
+    PERCENT_POT,  // % of the starting pot (ExploitabilityReport::percentPot)
+    BB_PER_100    // Big blinds per 100 hands (ExploitabilityReport::bb * 100)
+};
+
+/**
+ * Why a solve ended
+ */
+enum class StopReason {
+    ITERATIONS,   // numIterations reached
+    TIME_BUDGET,  // maxSeconds elapsed
+    TARGET,       // Exploitability at or below targetExploitability
+    STOPPED,      // stop() was called
+    NO_DEAL       // No combos could be dealt: a range is empty or blocked by the board
+};
+
+const char* stopReasonToString(StopReason reason);
+
 /**
  * Configuration for MCCFR solver
  */
 struct MCCFRConfig {
     int numIterations = 10000;
-    int numThreads = 1;  // Single-threaded by default for reliability
-    bool useExternalSampling = true;  // External sampling is more stable
+    int numThreads = 1;  // Iterations run at once, each with its own RNG; 0: all cores
+    SamplingScheme sampling = SamplingScheme::EXTERNAL;  // Subgames always use EXTERNAL
+    double explorationEpsilon = 0.6;  // OUTCOME: share of uniform exploration at the traverser's nodes
+    ChanceSampling chanceSampling = ChanceSampling::PUBLIC_SAMPLING;
+    int sampledRunouts = 4;
+    StorageMode storageMode = StorageMode::DOUBLE;  // COMPACT for trees that do not fit in memory
+    
+    // Depth limit: streets after lastStreet are not built, and the leaves
+    // where the tree stops are valued by the solver's LeafEstimator
+    Street lastStreet = Street::RIVER;
+    
     bool useDiscounting = true;
     double discountAlpha = 1.5;
     double discountBeta = 0.0;
     double discountGamma = 2.0;
     
-    // Callback frequency (iterations between progress updates)
+    // Regret-based pruning: the traverser skips actions whose regret is below
+    // the threshold, except on every fullTraversalInterval-th iteration
+    bool usePruning = false;
+    double pruningThreshold = -1.0;   // Cumulative sampled regret, bb (summed over visits, not reach weighted)
+    int pruningWarmup = 1000;         // Iterations before pruning starts
+    int fullTraversalInterval = 20;
+    
+    // Stopping rules besides numIterations, 0 disabling each: stop once
+    // maxSeconds of solving have passed, or once the exploitability, measured
+    // every exploitabilityCheckInterval iterations (less often when the best
+    // response would take over a fifth of the time), is at or below
+    // targetExploitability. Neither stops a solve before minIterations.
+    double maxSeconds = 0;
+    double targetExploitability = 0;
+    ExploitabilityUnit targetUnit = ExploitabilityUnit::PERCENT_POT;
+    int minIterations = 0;
+    int exploitabilityCheckInterval = 1000;
+    
+    // Callback frequency (iterations between progress updates); reports
+    // share the target checks' throttle (see SolveLoop)
     int progressCallbackFrequency = 100;
+    
+    // A measurement meets targetExploitability (never when it is 0)
+    bool targetReached(const ExploitabilityReport& report) const {
+        double value = targetUnit == ExploitabilityUnit::BB_PER_100 ? report.bb * 100 : report.percentPot;
+        return targetExploitability > 0 && value <= targetExploitability;
+    }
 };
 
 /**
@@ -34,11 +109,25 @@ struct MCCFRConfig {
 struct SolveProgress {
     int currentIteration;
     int totalIterations;
-    double exploitability;  // Measure of how far from Nash equilibrium
+    double exploitability;  // Best-response exploitability in bb per hand
+    double exploitabilityPctPot;  // Same, as a percentage of the starting pot
+    int measuredIteration;  // Iteration they were measured at; earlier when measuring was throttled
     bool complete;
     std::string status;
 };
 
+/**
+ * What solve() reached: the solver then holds the average strategy of
+ * `iterations` iterations, whichever rule ended the solve
+ */
+struct SolveResult {
+    StopReason reason = StopReason::ITERATIONS;
+    int iterations = 0;
+    double seconds = 0;
+    bool measured = false;  // Only when the solve measured along the way or reports progress
+    ExploitabilityReport exploitability;  // Of the final average strategy
+};
+
 /**
  * Result of solving a game tree node
  */
@@ -51,8 +140,21 @@ struct NodeStrategy {
 /**
  * MCCFR (Monte Carlo Counterfactual Regret Minimization) Solver
  * 
- * Uses external sampling variant for efficiency and stability.
- * Single-threaded by default to ensure reliable results.
+ * Uses external sampling by default (see SamplingScheme for the others).
+ * The betting tree is built once at initialization; iterations walk it
+ * by node index and update regrets in the tree's flat arena.
+ *
+ * With numThreads above 1, solve() runs that many iterations at once on
+ * the shared TaskPool. They all read the regrets as the previous step
+ * left them, and their updates are applied afterwards in iteration order,
+ * so a solve is reproducible whatever the scheduling. VANILLA iterations
+ * run one at a time.
+ *
+ * Unless numThreads is 1, a traversal also forks: the cards of a chance
+ * node it walks in full (CHANCE and VANILLA, or enumerated and sampled
+ * runouts) go in chunks of about PARALLEL_GRAIN work onto the pool, and a
+ * VANILLA iteration walks its deals in VANILLA_CHUNKS chunks. Each task
+ * has its own generator and update buffer, merged in card or deal order.
  */
 class MCCFRSolver {
 public:
@@ -68,12 +170,40 @@ public:
                     const core::Range& oopRange,
                     const core::Range& ipRange);
     
-    // Run the solver
-    void solve();
+    // Estimator for the leaves of a depth-limited tree (MCCFRConfig::lastStreet);
+    // set before initialize(). EquityEstimator if none is set.
+    void setLeafEstimator(std::shared_ptr<LeafEstimator> estimator) { leafEstimator_ = std::move(estimator); }
+    const LeafEstimator* leafEstimator() const { return leafEstimator_.get(); }
+    
+    // Card abstraction for the root street (see AbstractionBuilder); set
+    // before initialize(). Combos share an info set per bucket instead of
+    // per canonical hand when the map covers the root board; streets below
+    // the root stay keyed by canonical hand.
+    void setBucketMap(std::shared_ptr<const BucketMap> buckets) { bucketMap_ = std::move(buckets); }
+    const BucketMap* bucketMap() const { return bucketMap_.get(); }
+    
+    // Re-solve the subgame below a blueprint solve: ranges are the blueprint's
+    // reach at the subgame root, and the constrained player enters through
+    // the resolve gadget (see Subgame)
+    void initialize(const Subgame& subgame);
+    
+    // Continue from a solve of the same spot with a different bet sizing:
+    // call after initialize(); unchanged parts of the tree keep their
+    // regrets and strategy sums (see GameTree::warmStart)
+    bool warmStart(const MCCFRSolver& previous);
+    
+    // Run the solver until a stopping rule of the config ends it
+    SolveResult solve();
     
     // Run a single iteration (for progressive solving)
     void runIteration();
     
+    // Run up to `count` iterations, at most stepSize() of them at once
+    void runIterations(int count);
+    
+    // Iterations run at once: numThreads (all cores if 0), 1 for VANILLA
+    int stepSize() const;
+    
     // Stop solving
     void stop() { shouldStop_ = true; }
     bool isStopped() const { return shouldStop_; }
@@ -85,67 +215,253 @@ public:
     // Get strategy for a specific hand at current node
     NodeStrategy getStrategy(Position player, const core::Hand& hand) const;
     
-    // Get strategy for all hands in range at current node
+    // Get strategy for all hands in range at current node (StrategyMatrix
+    // reads every combo of any node in one pass, for repeated refreshes)
     std::vector<NodeStrategy> getAllStrategies(Position player) const;
     
     // Get aggregated strategy (weighted by hand frequency in range)
     std::vector<double> getAggregatedStrategy(Position player) const;
     
+    // Average strategy for a hand at any state below the root (uniform if unvisited)
+    std::vector<double> getAverageStrategy(Position player,
+                                           const core::Hand& hand,
+                                           const GameState& state) const;
+    
     // Progress callback
     using ProgressCallback = std::function<void(const SolveProgress&)>;
     void setProgressCallback(ProgressCallback callback) { progressCallback_ = callback; }
     
-    // Get exploitability estimate (lower is better, 0 = Nash equilibrium)
+    // Exact best-response exploitability of the average strategy
+    // (lower is better, 0 = Nash equilibrium)
+    ExploitabilityReport computeExploitability() const;
+    
+    // Exploitability in bb per hand
     double getExploitability() const;
     
-    // Access game tree
+    // Save the complete solver state, or restore it (setup included) to
+    // resume a solve; see Checkpoint. Subgame solves are not saved.
+    bool saveCheckpoint(const std::string& path) const;
+    bool loadCheckpoint(const std::string& path);
+    
+    // Make solve() save a checkpoint every `frequency` iterations
+    void setCheckpointPath(const std::string& path, int frequency) {
+        checkpointPath_ = path;
+        checkpointFrequency_ = frequency;
+    }
+    
+    // Access game tree and solve setup
     const GameTree& gameTree() const { return gameTree_; }
+    const GameState& initialState() const { return initialState_; }
+    const core::Range& oopRange() const { return oopRange_; }
+    const core::Range& ipRange() const { return ipRange_; }
+    const StrengthCache& strengthCache() const { return strengthCache_; }
+    
+    // Weight of every combo (core::Hand::comboIndex()) in a player's range,
+    // zero for combos outside it or blocked by the board
+    const std::vector<double>& comboWeights(Position player) const {
+        return comboWeights_[static_cast<int>(player)];
+    }
+    
+    // Solving a subgame behind a resolve gadget
+    bool isSubgame() const { return !gadgetValues_.empty(); }
 
 private:
+    friend class Checkpoint;
+    
     MCCFRConfig config_;
     GameTree gameTree_;
     GameState initialState_;
     core::Range oopRange_;
     core::Range ipRange_;
+    std::array<std::vector<double>, 2> comboWeights_;
+    std::shared_ptr<LeafEstimator> leafEstimator_;
+    std::shared_ptr<const BucketMap> bucketMap_;
+    
+    // Resolve gadget of a subgame: the constrained player's terminate
+    // value per combo and its terminate/follow regrets (empty otherwise)
+    Position gadgetPlayer_ = Position::OOP;
+    std::vector<double> gadgetValues_;
+    std::vector<double> gadgetRegrets_;
     
     std::atomic<int> iteration_{0};
     std::atomic<bool> shouldStop_{false};
     
     ProgressCallback progressCallback_;
     
-    // Random number generators (one per thread for thread safety)
+    std::string checkpointPath_;
+    int checkpointFrequency_ = 0;
+    
+    // Random number generators, one per iteration of a step
     std::vector<std::mt19937> rngs_;
-    std::mutex rngMutex_;
     
-    // External sampling CFR traversal
-    double externalSample(const GameState& state,
-                          const core::Hand& oopHand,
-                          const core::Hand& ipHand,
+    // Showdown strengths per board, shared with the best response
+    StrengthCache strengthCache_;
+    
+    // A combo of a player's range, as sampled each iteration
+    struct RangeCombo {
+        core::Hand hand;
+        int slot[3];  // Info set slot per tree level
+        int combo;    // core::Hand::comboIndex()
+    };
+    std::array<std::vector<RangeCombo>, 2> combos_;
+    std::array<std::discrete_distribution<int>, 2> comboDists_;
+    
+    // Regret and strategy-sum additions of one traversal, set aside while
+    // other traversals read the tree and applied later in a fixed order
+    struct Updates {
+        struct InfoSet {
+            const TreeNode* node;
+            int runout;
+            int slot;
+            size_t offset;  // Its numActions regrets in amounts, then as many strategy sums
+        };
+        std::vector<InfoSet> infoSets;               // In order of first update
+        std::vector<double> amounts;
+        std::unordered_map<uint64_t, size_t> index;  // infoSetKey() -> infoSets entry
+        std::vector<std::pair<int, std::array<double, 2>>> gadget;  // Gadget regret deltas per combo
+        
+        void clear() {
+            infoSets.clear();
+            amounts.clear();
+            index.clear();
+            gadget.clear();
+        }
+    };
+    
+    // The sampled cards of one iteration
+    struct Deal {
+        int slot[3][2];      // Info set slot per tree level and player
+        int combo[2];        // Combo index per player
+        uint64_t dead;       // Both players' cards
+        int publicCards[2];  // Turn/river cards below the root (public chance sampling)
+        bool prune;          // Regret-based pruning applies this iteration
+        double weight;       // Chance weight of the deal: 1 when sampled, relative weight when enumerated
+        Updates* updates;    // Where the traversals' updates go; the tree itself if null
+    };
+    
+    // Board cards dealt below the root during a traversal
+    struct Runout {
+        int id;  // Storage index, see GameTree::nextRunout
+        int boardSize;
+        core::Card board[5];
+        uint64_t dead;  // Board and both players' cards
+        const StrengthCache::Table* strengths;
+    };
+    Runout rootRunout_{};
+    
+    // Runout with one more card dealt
+    Runout dealCard(const Runout& runout, int card) const;
+    
+    // Build the combo tables the sampler draws from
+    void buildCombos(Position player);
+    
+    // Sample a deal of non-conflicting hands; false if none exists
+    bool sampleDeal(Deal& deal, std::mt19937& rng);
+    
+    // Both traversals of one sampled iteration, numbered `iteration`;
+    // false if no deal exists
+    bool sampledIteration(int iteration, std::mt19937& rng, Updates* updates);
+    
+    // Key of an info set in Updates
+    static uint64_t infoSetKey(int nodeIndex, int runout, int slot) {
+        return static_cast<uint64_t>(nodeIndex) << 32 | static_cast<uint64_t>(runout) << 16 |
+               static_cast<uint64_t>(slot);
+    }
+    
+    // Regret and strategy-sum additions of a traversal, routed by deal.updates
+    void addRegrets(const Deal& deal, const TreeNode& node, int runout, int slot, const double* delta);
+    void addStrategy(const Deal& deal, const TreeNode& node, int runout, int slot, const double* played);
+    // An info set's regrets in `updates`, followed by its strategy sums;
+    // valid until the next info set is added
+    double* pendingAmounts(Updates& updates, const TreeNode& node, int runout, int slot) const;
+    
+    // Apply set-aside updates, in the order they were made, to another
+    // buffer or to the tree if `into` is null
+    void applyUpdates(const Updates& updates, Updates* into = nullptr);
+    
+    // Estimated nodes walked below each node, a chance node's children
+    // counted once per card (as BestResponse's estimate)
+    std::vector<double> work_;
+    
+    // Work of the smallest task a traversal forks, when numThreads is not 1
+    static constexpr double PARALLEL_GRAIN = 1024;
+    
+    // Deal chunks a VANILLA traversal forks: fixed, so the order updates
+    // are applied in does not depend on the thread count
+    static constexpr int VANILLA_CHUNKS = 16;
+    
+    // External sampling CFR traversal over the flat tree
+    double externalSample(int nodeIndex,
+                          const Deal& deal,
+                          const Runout& runout,
                           Position traversingPlayer,
                           double oopReach,
                           double ipReach,
                           std::mt19937& rng);
     
-    // Get or create info set for a hand at a state
-    std::shared_ptr<InfoSet> getInfoSet(Position player,
-                                         const core::Hand& hand,
-                                         const GameState& state);
+    // Full-width traversal (CHANCE, VANILLA): every action of both players
+    double fullTraversal(int nodeIndex,
+                         const Deal& deal,
+                         const Runout& runout,
+                         Position traversingPlayer,
+                         double oopReach,
+                         double ipReach,
+                         std::mt19937& rng);
     
-    // Generate info set key
-    std::string makeInfoSetKey(Position player,
-                               const core::Hand& hand,
-                               const GameState& state) const;
+    // Outcome sampling: one action per node, traverser's sampled with
+    // exploration. Returns the sampled payoff divided by its sample
+    // probability; tailReach is the strategies' reach from the node down.
+    double outcomeSample(int nodeIndex,
+                         const Deal& deal,
+                         const Runout& runout,
+                         Position traversingPlayer,
+                         double ownReach,
+                         double oppReach,
+                         double sampleReach,
+                         double& tailReach,
+                         std::mt19937& rng);
     
-    // Sample a hand from a range (accounting for dead cards)
-    core::Hand sampleHand(const core::Range& range,
-                          const std::vector<core::Card>& deadCards,
-                          std::mt19937& rng);
+    // The traversal of the configured scheme below a chance node
+    double traverse(int nodeIndex,
+                    const Deal& deal,
+                    const Runout& runout,
+                    Position traversingPlayer,
+                    double oopReach,
+                    double ipReach,
+                    std::mt19937& rng);
+    
+    // One VANILLA iteration: both traversals over every compatible deal
+    void vanillaIteration();
+    
+    // Traverser's payoff at a leaf
+    double leafPayoff(const TreeNode& node, const Deal& deal, const Runout& runout,
+                      Position traversingPlayer) const;
+    
+    // VANILLA updates of the running traversal: each deal chunk's are
+    // merged in here in chunk order, and applied once every deal is walked
+    // so the whole iteration plays one strategy
+    Updates pendingRegrets_;
+    
+    // Traversal of a subgame through the resolve gadget above its root
+    double gadgetSample(const Deal& deal,
+                        const Runout& runout,
+                        Position traversingPlayer,
+                        std::mt19937& rng);
+    
+    // Value of a chance node under the configured chance sampling
+    double sampleChance(const TreeNode& node,
+                        const Deal& deal,
+                        const Runout& runout,
+                        Position traversingPlayer,
+                        double oopReach,
+                        double ipReach,
+                        std::mt19937& rng);
     
     // Apply discounting to regrets and strategies
     void applyDiscounting();
     
     // Update progress
-    void reportProgress();
+    void reportProgress(const ExploitabilityReport& report, int measuredAt, bool complete);
 };
 
 /**
@@ -0,0 +1,314 @@
+#include "preflop_games.hpp"
+#include "solution_library.hpp"
+#include "ompeval/hand_evaluator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace solver {
+
+namespace {
+
+constexpr char EQUITY_MAGIC[8] = {'T', 'F', 'P', 'E', 'Q', '0', '0', '2'};
+constexpr int N = PreflopEquityTable::NUM_CLASSES;
+
+struct EquityHeader {
+    char magic[8];
+    int32_t classes;
+};
+
+// Combos of every class, by comboIndex
+const std::vector<std::vector<core::Hand>>& classHands() {
+    static const std::vector<std::vector<core::Hand>> hands = [] {
+        std::vector<std::vector<core::Hand>> out(N);
+        for (int c = 0; c < N; ++c) out[c] = PreflopEquityTable::typeOf(c).getHands();
+        return out;
+    }();
+    return hands;
+}
+
+bool disjoint(const core::Hand& a, const core::Hand& b) {
+    return !a.contains(b.card1()) && !a.contains(b.card2());
+}
+
+// Suit-canonical 5-card boards, each the smallest card mask among its 24
+// relabellings, and the number of boards it stands for. Class results do
+// not change when suits are relabelled, so a board's orbit counts the same.
+void canonicalBoards(std::vector<std::array<int, 5>>& boards, std::vector<int>& orbits) {
+    int cards[5];
+    for (cards[0] = 0; cards[0] < core::NUM_CARDS; ++cards[0])
+    for (cards[1] = cards[0] + 1; cards[1] < core::NUM_CARDS; ++cards[1])
+    for (cards[2] = cards[1] + 1; cards[2] < core::NUM_CARDS; ++cards[2])
+    for (cards[3] = cards[2] + 1; cards[3] < core::NUM_CARDS; ++cards[3])
+    for (cards[4] = cards[3] + 1; cards[4] < core::NUM_CARDS; ++cards[4]) {
+        uint64_t mask = 0;
+        for (int card : cards) mask |= uint64_t{1} << card;
+
+        bool canonical = true;
+        int fixed = 0;  // Relabellings that map the board onto itself
+        for (const SuitPermutation& perm : SUIT_PERMUTATIONS) {
+            uint64_t image = 0;
+            for (int card : cards) image |= uint64_t{1} << perm.apply(core::Card(card)).value();
+            if (image < mask) {
+                canonical = false;
+                break;
+            }
+            fixed += image == mask;
+        }
+        if (!canonical) continue;
+        boards.push_back({cards[0], cards[1], cards[2], cards[3], cards[4]});
+        orbits.push_back(static_cast<int>(SUIT_PERMUTATIONS.size()) / fixed);
+    }
+}
+
+/**
+ * Showdowns of every combo pair on a board, summed per class pair: the
+ * river sweep of EquityEngine with per-class rather than per-combo counts.
+ * The live combos are sorted by strength; each is credited, per class,
+ * with the combos passed so far minus those holding one of its cards.
+ */
+class BoardSweep {
+public:
+    BoardSweep()
+        : lower_(N), cardLower_(core::NUM_CARDS * N), tied_(N), cardTied_(core::NUM_CARDS * N),
+          wins_(N * N), ties_(N * N) {
+        for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+            comboClass_[combo] = PreflopEquityTable::classOf(core::Hand::fromComboIndex(combo));
+        }
+        entries_.reserve(core::NUM_COMBOS);
+    }
+
+    // Add weight x the board's results: wins[a * N + b] counts the disjoint
+    // combo pairs where class a's hand is stronger, ties[a * N + b] the splits
+    void add(const std::array<int, 5>& board, int64_t weight,
+             std::vector<int64_t>& wins, std::vector<int64_t>& ties) {
+        const auto& evaluator = ompeval::HandEvaluator::instance();
+        uint64_t boardMask = 0;
+        int hand[7];
+        int suitCount[core::NUM_SUITS] = {};
+        for (int i = 0; i < 5; ++i) {
+            hand[i + 2] = board[i];
+            boardMask |= uint64_t{1} << board[i];
+            ++suitCount[core::Card(board[i]).suitIndex()];
+        }
+        // Only a suit with three board cards can make a flush; a hand that
+        // does not make one is ranked by its two ranks alone, evaluated once
+        int flushSuit = 0;
+        for (int suit = 1; suit < core::NUM_SUITS; ++suit) {
+            if (suitCount[suit] > suitCount[flushSuit]) flushSuit = suit;
+        }
+        std::array<int, core::NUM_RANKS * core::NUM_RANKS> byRanks;
+        byRanks.fill(-1);
+
+        entries_.clear();
+        for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+            core::Hand h = core::Hand::fromComboIndex(combo);
+            hand[0] = h.card1().value();
+            hand[1] = h.card2().value();
+            if ((boardMask >> hand[0] & 1) || (boardMask >> hand[1] & 1)) continue;
+            int strength;
+            int suited = (h.card1().suitIndex() == flushSuit) + (h.card2().suitIndex() == flushSuit);
+            if (suitCount[flushSuit] + suited >= 5) {
+                strength = evaluator.evaluate(hand, 7).value;
+            } else {
+                int& known = byRanks[h.card1().rankIndex() * core::NUM_RANKS + h.card2().rankIndex()];
+                if (known < 0) known = evaluator.evaluate(hand, 7).value;
+                strength = known;
+            }
+            entries_.push_back({strength, comboClass_[combo], hand[0], hand[1]});
+        }
+        std::sort(entries_.begin(), entries_.end(),
+                  [](const Entry& a, const Entry& b) { return a.strength < b.strength; });
+
+        std::fill(lower_.begin(), lower_.end(), 0);
+        std::fill(cardLower_.begin(), cardLower_.end(), 0);
+        for (size_t begin = 0; begin < entries_.size();) {
+            size_t end = begin;
+            while (end < entries_.size() && entries_[end].strength == entries_[begin].strength) ++end;
+
+            for (size_t i = begin; i < end; ++i) {
+                const Entry& e = entries_[i];
+                int32_t* won = &wins_[e.handClass * N];
+                const int32_t* lower1 = &cardLower_[e.card1 * N];
+                const int32_t* lower2 = &cardLower_[e.card2 * N];
+                for (int c = 0; c < N; ++c) won[c] += lower_[c] - lower1[c] - lower2[c];
+            }
+
+            // A lone hand ties nobody; in a group the hand itself is counted
+            // once in the total and once per card, so one is added back
+            if (end - begin > 1) {
+                for (size_t i = begin; i < end; ++i) pass(entries_[i], tied_, cardTied_, 1);
+                for (size_t i = begin; i < end; ++i) {
+                    const Entry& e = entries_[i];
+                    int32_t* split = &ties_[e.handClass * N];
+                    const int32_t* tied1 = &cardTied_[e.card1 * N];
+                    const int32_t* tied2 = &cardTied_[e.card2 * N];
+                    for (int c = 0; c < N; ++c) split[c] += tied_[c] - tied1[c] - tied2[c];
+                    ++split[e.handClass];
+                }
+                for (size_t i = begin; i < end; ++i) pass(entries_[i], tied_, cardTied_, -1);
+            }
+
+            for (size_t i = begin; i < end; ++i) pass(entries_[i], lower_, cardLower_, 1);
+            begin = end;
+        }
+
+        for (int i = 0; i < N * N; ++i) {
+            wins[i] += weight * wins_[i];
+            ties[i] += weight * ties_[i];
+        }
+        std::fill(wins_.begin(), wins_.end(), 0);
+        std::fill(ties_.begin(), ties_.end(), 0);
+    }
+
+private:
+    struct Entry {
+        int strength;
+        int handClass;
+        int card1;
+        int card2;
+    };
+
+    std::array<int, core::NUM_COMBOS> comboClass_;
+    std::vector<Entry> entries_;
+    std::vector<int32_t> lower_, cardLower_;  // Per class: weaker combos, and those holding each card
+    std::vector<int32_t> tied_, cardTied_;    // The same within the current group of equal strength
+    std::vector<int32_t> wins_, ties_;        // This board's results per class pair
+
+    static void pass(const Entry& e, std::vector<int32_t>& total, std::vector<int32_t>& perCard, int count) {
+        total[e.handClass] += count;
+        perCard[e.card1 * N + e.handClass] += count;
+        perCard[e.card2 * N + e.handClass] += count;
+    }
+};
+
+} // namespace
+
+PreflopEquityTable::PreflopEquityTable() : equity_(N * N, 0.5f), pairs_(N * N, 0) {
+    const auto& hands = classHands();
+    for (int a = 0; a < N; ++a) {
+        for (int b = 0; b < N; ++b) {
+            int count = 0;
+            for (const auto& ha : hands[a]) {
+                for (const auto& hb : hands[b]) count += disjoint(ha, hb);
+            }
+            pairs_[a * N + b] = static_cast<uint16_t>(count);
+            totalPairs_ += count;
+        }
+    }
+}
+
+PreflopEquityTable PreflopEquityTable::build(int numThreads) {
+    PreflopEquityTable table;
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<std::array<int, 5>> boards;
+    std::vector<int> orbits;
+    canonicalBoards(boards, orbits);
+
+    // Boards are handed out one at a time; the counts are integers, so
+    // the result does not depend on how they were split
+    std::vector<std::vector<int64_t>> wins(numThreads, std::vector<int64_t>(N * N, 0));
+    std::vector<std::vector<int64_t>> ties(numThreads, std::vector<int64_t>(N * N, 0));
+    std::atomic<size_t> next{0};
+    auto worker = [&](int t) {
+        BoardSweep sweep;
+        for (size_t board = next++; board < boards.size(); board = next++) {
+            sweep.add(boards[board], orbits[board], wins[t], ties[t]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 1; t < numThreads; ++t) {
+        for (int i = 0; i < N * N; ++i) {
+            wins[0][i] += wins[t][i];
+            ties[0][i] += ties[t][i];
+        }
+    }
+
+    for (int a = 0; a < N; ++a) {
+        for (int b = 0; b < N; ++b) {
+            int64_t won = wins[0][a * N + b], lost = wins[0][b * N + a], split = ties[0][a * N + b];
+            if (won + lost + split > 0) {
+                table.equity_[a * N + b] = static_cast<float>((won + 0.5 * split) / (won + lost + split));
+            }
+        }
+    }
+    return table;
+}
+
+int PreflopEquityTable::classOf(const core::HandType& type) {
+    auto [row, col] = type.gridPosition();
+    return row * 13 + col;
+}
+
+int PreflopEquityTable::classOf(const core::Hand& hand) {
+    return classOf(core::HandType(hand.card1().rank(), hand.card2().rank(), hand.isSuited()));
+}
+
+core::HandType PreflopEquityTable::typeOf(int handClass) {
+    int row = handClass / 13, col = handClass % 13;
+    auto rank = [](int index) { return static_cast<core::Rank>(12 - index); };
+    if (row == col) return core::HandType(rank(row), rank(row), false);
+    // Suited hands sit below the diagonal, offsuit above
+    return row > col ? core::HandType(rank(col), rank(row), true) : core::HandType(rank(row), rank(col), false);
+}
+
+bool PreflopEquityTable::save(const std::string& path) const {
+    EquityHeader header{};
+    std::memcpy(header.magic, EQUITY_MAGIC, sizeof(header.magic));
+    header.classes = N;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(equity_.data()), equity_.size() * sizeof(float));
+    return static_cast<bool>(out);
+}
+
+std::unique_ptr<PreflopEquityTable> PreflopEquityTable::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    EquityHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, EQUITY_MAGIC, sizeof(header.magic)) != 0 || header.classes != N) {
+        return nullptr;
+    }
+
+    // Card-removal counts are recomputed rather than stored
+    auto table = std::make_unique<PreflopEquityTable>();
+    if (!in.read(reinterpret_cast<char*>(table->equity_.data()), table->equity_.size() * sizeof(float))) {
+        return nullptr;
+    }
+    return table;
+}
+
+MatrixGame allInGame(const PreflopEquityTable& table, const AllInSpot& spot) {
+    // Entry (jammer class a, action) x (caller class b, action), row-major
+    constexpr int FOLD = 0, ALL_IN = 1;
+    std::vector<float> payoff(static_cast<size_t>(N) * 2 * N * 2, 0.0f);
+    double pot = 2 * spot.stack + spot.dead;
+    for (int a = 0; a < N; ++a) {
+        for (int b = 0; b < N; ++b) {
+            double p = table.probability(a, b);
+            if (p == 0) continue;
+            double showdown = table.equity(a, b) * pot - spot.stack;
+            auto at = [&](int jammer, int caller) -> float& {
+                return payoff[(static_cast<size_t>(a) * 2 + jammer) * (N * 2) + b * 2 + caller];
+            };
+            at(FOLD, FOLD) = at(FOLD, ALL_IN) = static_cast<float>(-p * spot.jammerPosted);
+            at(ALL_IN, FOLD) = static_cast<float>(p * (spot.callerPosted + spot.dead));
+            at(ALL_IN, ALL_IN) = static_cast<float>(p * showdown);
+        }
+    }
+    return MatrixGame(N, 2, N, 2, std::move(payoff));
+}
+
+} // namespace solver
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "matrix_game.hpp"
+#include "core/hand.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace solver {
+
+/**
+ * All-in equity of each of the 169 preflop hand classes against each
+ * other, and how many combo pairs of two classes can be dealt together.
+ *
+ * Classes are numbered by their 13x13 grid position (row * 13 + col from
+ * HandType::gridPosition(), so AA is 0 and 22 is 168). Equities are exact:
+ * every suit-canonical board is dealt once, weighted by the boards it
+ * stands for, and all live combos are swept in strength order with
+ * per-class counts (see EquityEngine), so each compatible combo pair of
+ * each class pair is compared on every board.
+ */
+class PreflopEquityTable {
+public:
+    static constexpr int NUM_CLASSES = 169;
+
+    // Every equity 0.5, card-removal counts filled in
+    PreflopEquityTable();
+
+    // Exact equities over all boards (0 threads: hardware concurrency)
+    static PreflopEquityTable build(int numThreads = 0);
+
+    static int classOf(const core::HandType& type);
+    static int classOf(const core::Hand& hand);
+    static core::HandType typeOf(int handClass);
+
+    // Equity of class a against class b
+    double equity(int a, int b) const { return equity_[a * NUM_CLASSES + b]; }
+    // Combo pairs of a and b that share no card
+    int pairs(int a, int b) const { return pairs_[a * NUM_CLASSES + b]; }
+    // Probability that two dealt hands are of classes a and b
+    double probability(int a, int b) const { return pairs(a, b) / static_cast<double>(totalPairs_); }
+
+    bool save(const std::string& path) const;
+    static std::unique_ptr<PreflopEquityTable> load(const std::string& path);
+
+private:
+    std::vector<float> equity_;
+    std::vector<uint16_t> pairs_;
+    int64_t totalPairs_ = 0;
+};
+
+/**
+ * A jam-or-fold decision against a call-or-fold one, in big blinds: the
+ * jammer folds what it has posted or puts in its whole stack, and the
+ * caller folds what it has posted or calls for a showdown.
+ */
+struct AllInSpot {
+    double stack = 10.0;        // Effective stack, including what is posted
+    double jammerPosted = 0.5;
+    double callerPosted = 1.0;
+    double dead = 0.0;          // Chips in the pot from neither player (folded blinds, other antes)
+
+    // Push/fold between the blinds: the small blind jams, the big blind
+    // calls. Each posts an ante on top of its blind; at a table of more
+    // than two the others have folded and their antes are dead
+    static AllInSpot pushFold(double stack, double ante = 0.0, int players = 2) {
+        return {stack, 0.5 + ante, 1.0 + ante, std::max(0, players - 2) * ante};
+    }
+    // Heads-up 3-bet-or-fold: the big blind jams over an open to `open`
+    static AllInSpot threeBetOrFold(double stack, double open = 2.5) {
+        return {stack, 1.0, open, 0.0};
+    }
+};
+
+/**
+ * The 169 x 169 game of a spot: the jammer's rows are (class, fold/jam),
+ * the caller's columns (class, fold/call), and each entry is the jammer's
+ * payoff weighted by the probability of the two classes.
+ */
+MatrixGame allInGame(const PreflopEquityTable& table, const AllInSpot& spot);
+
+} // namespace solver
@@ -0,0 +1,116 @@
+#include "push_fold.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+namespace solver {
+
+namespace {
+
+constexpr int CHECK_INTERVAL = 25;  // Iterations between exploitability checks
+
+core::Range rangeOf(const std::array<float, PreflopEquityTable::NUM_CLASSES>& frequencies) {
+    core::Range range;
+    for (int c = 0; c < PreflopEquityTable::NUM_CLASSES; ++c) {
+        double weight = 100.0 * frequencies[c];
+        if (weight >= 0.5) range.addHandType(PreflopEquityTable::typeOf(c), weight);
+    }
+    return range;
+}
+
+std::string stackName(double stack) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%gbb", stack);
+    return name;
+}
+
+} // namespace
+
+core::Range PushFoldChart::pushRange() const {
+    return rangeOf(push);
+}
+
+core::Range PushFoldChart::callRange() const {
+    return rangeOf(call);
+}
+
+PushFoldSolver::PushFoldSolver(const PreflopEquityTable& table, PushFoldConfig config)
+    : table_(table), config_(std::move(config)) {
+    if (config_.stacks.empty()) {
+        for (int stack = 1; stack <= 25; ++stack) config_.stacks.push_back(stack);
+    }
+}
+
+PushFoldChart PushFoldSolver::solve(double stack) const {
+    MatrixGame game = allInGame(table_, AllInSpot::pushFold(stack, config_.ante, config_.players));
+    MatrixGameSolver solver(game);
+
+    PushFoldChart chart;
+    chart.stack = stack;
+    do {
+        solver.iterate(CHECK_INTERVAL);
+        chart.exploitability = solver.exploitability();
+    } while (chart.exploitability > config_.targetExploitability && solver.iterations() < config_.maxIterations);
+
+    // Entry 1 of each class is the aggressive action: jam, or call
+    std::vector<double> push = solver.rowStrategy();
+    std::vector<double> call = solver.colStrategy();
+    for (int c = 0; c < PreflopEquityTable::NUM_CLASSES; ++c) {
+        chart.push[c] = static_cast<float>(push[c * 2 + 1]);
+        chart.call[c] = static_cast<float>(call[c * 2 + 1]);
+    }
+    chart.value = solver.value();
+    chart.iterations = solver.iterations();
+    return chart;
+}
+
+std::vector<PushFoldChart> PushFoldSolver::solve(ProgressCallback progress) const {
+    std::vector<PushFoldChart> charts(config_.stacks.size());
+    int numThreads = config_.numThreads;
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    numThreads = std::min<int>(numThreads, static_cast<int>(charts.size()));
+
+    // One depth per worker at a time; each writes only its own chart
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < charts.size(); i = next++) {
+            charts[i] = solve(config_.stacks[i]);
+            if (progress) progress(charts[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return charts;
+}
+
+bool PushFoldSolver::saveRanges(const std::vector<PushFoldChart>& charts, const std::string& directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) return false;
+
+    auto write = [&](const std::string& name, const core::Range& range) {
+        std::ofstream out(std::filesystem::path(directory) / name, std::ios::trunc);
+        out << range.toCompactString() << "\n";
+        return static_cast<bool>(out);
+    };
+    for (const auto& chart : charts) {
+        if (!write("push_" + stackName(chart.stack) + ".txt", chart.pushRange()) ||
+            !write("call_" + stackName(chart.stack) + ".txt", chart.callRange())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace solver
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "preflop_games.hpp"
+#include "core/range.hpp"
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace solver {
+
+struct PushFoldConfig {
+    std::vector<double> stacks;    // Effective stacks in big blinds; empty: 1 to 25
+    double ante = 0.0;             // Per player, in big blinds
+    int players = 2;               // Above 2: small blind against big blind after the others fold, their antes dead
+    double targetExploitability = 0.0001;  // bb; a depth stops once below it
+    int maxIterations = 5000;
+    int numThreads = 0;            // 0: hardware concurrency
+};
+
+/**
+ * Equilibrium of one stack depth: push and call frequencies per hand class
+ * (PreflopEquityTable numbering), and the small blind's value in bb.
+ */
+struct PushFoldChart {
+    double stack = 0.0;
+    std::array<float, PreflopEquityTable::NUM_CLASSES> push = {};
+    std::array<float, PreflopEquityTable::NUM_CLASSES> call = {};
+    double value = 0.0;
+    double exploitability = 0.0;
+    int iterations = 0;
+
+    core::Range pushRange() const;
+    core::Range callRange() const;
+};
+
+/**
+ * Push/fold charts across stack depths.
+ *
+ * Each depth is an allInGame() solved by MatrixGameSolver until it is
+ * within the target exploitability; depths are independent and are handed
+ * out one per thread. The equity table is shared read-only, so a sweep of
+ * 25 depths costs a few hundred iterations of a 338 x 338 game each.
+ */
+class PushFoldSolver {
+public:
+    using ProgressCallback = std::function<void(const PushFoldChart& chart)>;
+
+    PushFoldSolver(const PreflopEquityTable& table, PushFoldConfig config);
+
+    // Charts in the order of the configured stacks; the callback runs on
+    // the worker that finished the depth
+    std::vector<PushFoldChart> solve(ProgressCallback progress = nullptr) const;
+    PushFoldChart solve(double stack) const;
+
+    // Writes push_<stack>bb.txt and call_<stack>bb.txt per chart, each one
+    // line of range notation that core::Range::fromString() reads back
+    static bool saveRanges(const std::vector<PushFoldChart>& charts, const std::string& directory);
+
+private:
+    const PreflopEquityTable& table_;
+    PushFoldConfig config_;
+};
+
+} // namespace solver
@@ -0,0 +1,376 @@
+#include "solution_file.hpp"
+#include "mccfr.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace solver {
+
+static_assert(std::is_trivially_copyable_v<SolutionHeader>);
+static_assert(std::is_trivially_copyable_v<SolutionNode>);
+
+namespace {
+
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t{7};
+}
+
+// Quantize one info set's probabilities to 8 or 16 bits
+template <typename T>
+void quantize(const double* probs, int numActions, T* out) {
+    constexpr double scale = static_cast<double>(std::numeric_limits<T>::max());
+    for (int a = 0; a < numActions; ++a) {
+        out[a] = static_cast<T>(std::lround(std::clamp(probs[a], 0.0, 1.0) * scale));
+    }
+}
+
+// Dequantize one info set, renormalizing away the rounding
+template <typename T>
+void dequantize(const T* in, int numActions, float* out) {
+    float total = 0;
+    for (int a = 0; a < numActions; ++a) {
+        out[a] = in[a];
+        total += out[a];
+    }
+    for (int a = 0; a < numActions; ++a) {
+        out[a] = (total > 0) ? out[a] / total : 1.0f / numActions;
+    }
+}
+
+// Every table and node of a mapped file lies inside it and points at valid
+// entries, so queries need no bounds checks of their own
+bool wellFormed(const char* data, uint64_t size) {
+    const auto* header = reinterpret_cast<const SolutionHeader*>(data);
+    uint64_t runoutTableEnd = header->runoutTableOffset + GameTree::MAX_RUNOUTS * sizeof(int32_t);
+    uint64_t slotMapEnd = header->slotMapOffset + 3 * 2 * core::NUM_COMBOS * sizeof(int16_t);
+    uint64_t nodesEnd = header->nodesOffset + static_cast<uint64_t>(header->numNodes) * sizeof(SolutionNode);
+    if (std::memcmp(header->magic, SOLUTION_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SOLUTION_VERSION ||
+        (header->bits != 8 && header->bits != 16) ||
+        header->fileSize != size ||
+        header->runoutTableOffset > size || runoutTableEnd > size ||
+        header->slotMapOffset > size || slotMapEnd > size ||
+        header->nodesOffset > size || header->numNodes == 0 || nodesEnd > size ||
+        header->rootBoardSize > 5) {
+        return false;
+    }
+    for (int level = 0; level < 3; ++level) {
+        if (header->levelRunouts[level] > GameTree::MAX_RUNOUTS) return false;
+        for (int player = 0; player < 2; ++player) {
+            if (header->numSlots[level][player] > core::NUM_COMBOS) return false;
+        }
+    }
+
+    const auto* runoutIndex = reinterpret_cast<const int32_t*>(data + header->runoutTableOffset);
+    for (int runout = 0; runout < GameTree::MAX_RUNOUTS; ++runout) {
+        int32_t index = runoutIndex[runout];
+        if (index < -1 || (index >= 0 && static_cast<uint32_t>(index) >=
+                                             header->levelRunouts[GameTree::runoutLevel(runout)])) {
+            return false;
+        }
+    }
+
+    const auto* slotMap = reinterpret_cast<const int16_t*>(data + header->slotMapOffset);
+    for (int level = 0; level < 3; ++level) {
+        for (int player = 0; player < 2; ++player) {
+            const int16_t* slots = slotMap + (level * 2 + player) * core::NUM_COMBOS;
+            for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+                int16_t slot = slots[combo];
+                if (slot < -1 || (slot >= 0 && static_cast<uint32_t>(slot) >= header->numSlots[level][player])) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Parents come before their children, so walking the tree always ends
+    int64_t numNodes = header->numNodes;
+    const auto* nodes = reinterpret_cast<const SolutionNode*>(data + header->nodesOffset);
+    for (int64_t i = 0; i < numNodes; ++i) {
+        const SolutionNode& node = nodes[i];
+        if (node.type > static_cast<uint8_t>(NodeType::TERMINAL) || node.player > 1 || node.level > 2 ||
+            node.numActions > MAX_ACTIONS || node.parent < -1 || node.parent >= i) {
+            return false;
+        }
+        if (node.numActions > 0 && (node.firstChild <= i || node.firstChild + node.numActions > numNodes)) {
+            return false;
+        }
+        if (node.type != static_cast<uint8_t>(NodeType::PLAYER)) continue;
+
+        uint64_t bytes = static_cast<uint64_t>(header->levelRunouts[node.level]) *
+                         header->numSlots[node.level][node.player] * node.numActions * (header->bits / 8);
+        if (node.numActions == 0 || node.dataOffset > size || bytes > size - node.dataOffset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool SolutionFile::write(const MCCFRSolver& solver, const std::string& path, int bits) {
+    if (bits != 8 && bits != 16) return false;
+
+    const GameTree& tree = solver.gameTree();
+    const GameState& root = solver.initialState();
+    size_t bytesPer = bits / 8;
+
+    SolutionHeader header{};
+    std::memcpy(header.magic, SOLUTION_MAGIC, sizeof(header.magic));
+    header.version = SOLUTION_VERSION;
+    header.bits = static_cast<uint32_t>(bits);
+    header.numNodes = static_cast<uint32_t>(tree.numNodes());
+    header.rootHistoryLength = static_cast<uint32_t>(root.actionHistory().size());
+    for (const auto& card : root.board()) {
+        header.rootBoard[header.rootBoardSize++] = static_cast<uint8_t>(card.value());
+    }
+    header.rootPot = root.pot();
+
+    // Runouts the solve reached, numbered densely per level
+    std::vector<int32_t> runoutIndex(GameTree::MAX_RUNOUTS, -1);
+    std::vector<std::vector<int>> levelRunouts(3);
+    for (int runout = 0; runout < GameTree::MAX_RUNOUTS; ++runout) {
+        if (!tree.runoutStorage(runout)) continue;
+        int level = GameTree::runoutLevel(runout);
+        runoutIndex[runout] = static_cast<int32_t>(levelRunouts[level].size());
+        levelRunouts[level].push_back(runout);
+    }
+    for (int level = 0; level < 3; ++level) {
+        header.levelRunouts[level] = static_cast<uint32_t>(levelRunouts[level].size());
+    }
+
+    std::vector<int16_t> slotMap(3 * 2 * core::NUM_COMBOS, -1);
+    for (int level = 0; level < 3; ++level) {
+        for (int player = 0; player < 2; ++player) {
+            const HandSlots& slots = tree.slots(static_cast<Position>(player), level);
+            header.numSlots[level][player] = static_cast<uint32_t>(slots.size());
+            for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+                slotMap[(level * 2 + player) * core::NUM_COMBOS + combo] = static_cast<int16_t>(slots.comboToSlot[combo]);
+            }
+        }
+    }
+
+    header.runoutTableOffset = align8(sizeof(SolutionHeader));
+    header.slotMapOffset = align8(header.runoutTableOffset + runoutIndex.size() * sizeof(int32_t));
+    header.nodesOffset = align8(header.slotMapOffset + slotMap.size() * sizeof(int16_t));
+
+    // Directory, with each PLAYER node's data placed after the previous one's
+    std::vector<SolutionNode> nodes(tree.numNodes());
+    uint64_t offset = align8(header.nodesOffset + nodes.size() * sizeof(SolutionNode));
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const TreeNode& node = tree.node(static_cast<int>(i));
+        SolutionNode& out = nodes[i];
+        out.type = static_cast<uint8_t>(node.type);
+        out.player = static_cast<uint8_t>(node.player);
+        out.numActions = static_cast<uint8_t>(node.numActions);
+        out.level = static_cast<uint8_t>(node.level);
+        out.parent = node.parent;
+        out.firstChild = node.firstChild;
+        out.actionType = static_cast<uint8_t>(tree.actionTo(static_cast<int>(i)).type);
+        out.actionAmount = tree.actionTo(static_cast<int>(i)).amount;
+        out.pot = node.pot;
+
+        if (node.type != NodeType::PLAYER) continue;
+        out.dataOffset = offset;
+        offset += static_cast<uint64_t>(levelRunouts[node.level].size()) *
+                  header.numSlots[node.level][static_cast<int>(node.player)] * node.numActions * bytesPer;
+        offset = align8(offset);
+    }
+    header.fileSize = offset;
+
+    std::string tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) return false;
+
+    bool ok = true;
+    auto put = [&](const void* data, size_t size, uint64_t at) {
+        if (!ok) return;
+        ok = std::fseek(file, static_cast<long>(at), SEEK_SET) == 0 &&
+             std::fwrite(data, 1, size, file) == size;
+    };
+
+    put(&header, sizeof(header), 0);
+    put(runoutIndex.data(), runoutIndex.size() * sizeof(int32_t), header.runoutTableOffset);
+    put(slotMap.data(), slotMap.size() * sizeof(int16_t), header.slotMapOffset);
+    put(nodes.data(), nodes.size() * sizeof(SolutionNode), header.nodesOffset);
+
+    // Strategy blocks, one node at a time
+    std::vector<char> block;
+    double probs[MAX_ACTIONS];
+    for (size_t i = 0; i < nodes.size() && ok; ++i) {
+        const TreeNode& node = tree.node(static_cast<int>(i));
+        if (node.type != NodeType::PLAYER) continue;
+
+        int numSlots = static_cast<int>(header.numSlots[node.level][static_cast<int>(node.player)]);
+        size_t rowBytes = node.numActions * bytesPer;
+        block.assign(levelRunouts[node.level].size() * numSlots * rowBytes, 0);
+
+        char* row = block.data();
+        for (int runout : levelRunouts[node.level]) {
+            for (int slot = 0; slot < numSlots; ++slot, row += rowBytes) {
+                tree.averageStrategy(node, runout, slot, probs);
+                if (bits == 8) {
+                    quantize(probs, node.numActions, reinterpret_cast<uint8_t*>(row));
+                } else {
+                    quantize(probs, node.numActions, reinterpret_cast<uint16_t*>(row));
+                }
+            }
+        }
+        put(block.data(), block.size(), nodes[i].dataOffset);
+    }
+
+    // Pad to the recorded size
+    if (ok && header.fileSize > 0) {
+        char zero = 0;
+        put(&zero, 1, header.fileSize - 1);
+    }
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<SolutionFile> SolutionFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SolutionHeader))) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<SolutionFile> file(new SolutionFile());
+    file->size_ = static_cast<size_t>(info.st_size);
+    file->mapped_ = ::mmap(nullptr, file->size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (file->mapped_ == MAP_FAILED) {
+        file->mapped_ = nullptr;
+        return nullptr;
+    }
+
+    file->data_ = static_cast<const char*>(file->mapped_);
+    if (!wellFormed(file->data_, file->size_)) return nullptr;
+
+    const auto* header = reinterpret_cast<const SolutionHeader*>(file->data_);
+    file->header_ = header;
+    file->runoutIndex_ = reinterpret_cast<const int32_t*>(file->data_ + header->runoutTableOffset);
+    file->slotMap_ = reinterpret_cast<const int16_t*>(file->data_ + header->slotMapOffset);
+    file->nodes_ = reinterpret_cast<const SolutionNode*>(file->data_ + header->nodesOffset);
+    return file;
+}
+
+SolutionFile::~SolutionFile() {
+    if (mapped_) ::munmap(mapped_, size_);
+}
+
+Action SolutionFile::actionTo(int index) const {
+    const SolutionNode& node = nodes_[index];
+    double potFraction = 0;
+    if (node.parent >= 0 && nodes_[node.parent].pot > 0) {
+        potFraction = node.actionAmount / nodes_[node.parent].pot;
+    }
+    return {static_cast<ActionType>(node.actionType), node.actionAmount, potFraction};
+}
+
+int SolutionFile::findNode(const std::vector<Action>& actions,
+                           const std::vector<core::Card>& dealt, int& runout) const {
+    runout = 0;
+    int index = 0;
+    size_t next = 0;
+
+    // Step through a chance node using the next dealt card
+    auto deal = [&]() {
+        if (next >= dealt.size()) return false;
+        runout = GameTree::nextRunout(runout, dealt[next++].value());
+        index = nodes_[index].firstChild;
+        return true;
+    };
+
+    for (const auto& action : actions) {
+        while (nodes_[index].type == static_cast<uint8_t>(NodeType::CHANCE)) {
+            if (!deal()) return -1;
+        }
+
+        const SolutionNode& node = nodes_[index];
+        int child = -1;
+        for (int a = 0; a < node.numActions; ++a) {
+            const SolutionNode& candidate = nodes_[node.firstChild + a];
+            if (candidate.actionType == static_cast<uint8_t>(action.type) &&
+                std::abs(candidate.actionAmount - action.amount) < 1e-9) {
+                child = node.firstChild + a;
+                break;
+            }
+        }
+        if (child < 0) return -1;
+        index = child;
+    }
+
+    // Cards dealt after the last action
+    while (nodes_[index].type == static_cast<uint8_t>(NodeType::CHANCE) && next < dealt.size()) {
+        deal();
+    }
+    return (next == dealt.size()) ? index : -1;
+}
+
+int SolutionFile::findNode(const GameState& state, int& runout) const {
+    runout = 0;
+    const auto& board = state.board();
+    const auto& history = state.actionHistory();
+    if (board.size() < header_->rootBoardSize || history.size() < header_->rootHistoryLength) {
+        return -1;
+    }
+    for (int i = 0; i < header_->rootBoardSize; ++i) {
+        if (board[i].value() != header_->rootBoard[i]) return -1;
+    }
+
+    std::vector<Action> actions(history.begin() + header_->rootHistoryLength, history.end());
+    std::vector<core::Card> dealt(board.begin() + header_->rootBoardSize, board.end());
+    return findNode(actions, dealt, runout);
+}
+
+bool SolutionFile::strategy(int nodeIndex, int runout, float* out) const {
+    if (nodeIndex < 0 || nodeIndex >= numNodes() || runout < 0 || runout >= GameTree::MAX_RUNOUTS) {
+        return false;
+    }
+    const SolutionNode& node = nodes_[nodeIndex];
+    if (node.type != static_cast<uint8_t>(NodeType::PLAYER) ||
+        GameTree::runoutLevel(runout) != node.level || runoutIndex_[runout] < 0) {
+        return false;
+    }
+
+    int numActions = node.numActions;
+    int numSlots = static_cast<int>(header_->numSlots[node.level][node.player]);
+    size_t rowBytes = numActions * (header_->bits / 8);
+    const char* block = data_ + node.dataOffset +
+                        static_cast<size_t>(runoutIndex_[runout]) * numSlots * rowBytes;
+
+    // Each combo's info set is dequantized straight into its row
+    const int16_t* slots = slotMap_ + (node.level * 2 + node.player) * core::NUM_COMBOS;
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        float* dst = out + combo * numActions;
+        if (slots[combo] < 0) {
+            std::fill(dst, dst + numActions, 0.0f);
+            continue;
+        }
+        const char* row = block + slots[combo] * rowBytes;
+        if (header_->bits == 8) {
+            dequantize(reinterpret_cast<const uint8_t*>(row), numActions, dst);
+        } else {
+            dequantize(reinterpret_cast<const uint16_t*>(row), numActions, dst);
+        }
+    }
+    return true;
+}
+
+} // namespace solver
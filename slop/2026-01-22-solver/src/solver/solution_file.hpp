@@ -0,0 +1,115 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "core/card.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * Header of a solution file.
+ *
+ * Layout, native-endian, every section 8-byte aligned:
+ *   SolutionHeader
+ *   int32[MAX_RUNOUTS]   runout id -> index among its level's stored runouts, -1 if absent
+ *   int16[3][2][1326]    combo -> info set slot per level and player, -1 if not in range
+ *   SolutionNode[numNodes]
+ *   strategy data: per PLAYER node, one block per stored runout of its level,
+ *                  numSlots x numActions quantized probabilities
+ *
+ * The file is used in place through mmap; nothing is parsed on load.
+ */
+struct SolutionHeader {
+    char magic[8];                 // SOLUTION_MAGIC
+    uint32_t version;
+    uint32_t bits;                 // 8 or 16 per probability
+    uint32_t numNodes;
+    uint32_t rootHistoryLength;    // Actions before the solved root
+    uint8_t rootBoard[5];
+    uint8_t rootBoardSize;
+    uint8_t reserved[2];
+    uint32_t numSlots[3][2];       // Info set slots per level and player
+    uint32_t levelRunouts[3];      // Stored runouts per level
+    uint32_t reserved2;
+    double rootPot;
+    uint64_t runoutTableOffset;
+    uint64_t slotMapOffset;
+    uint64_t nodesOffset;
+    uint64_t fileSize;
+};
+
+/**
+ * Directory entry of one betting node. Children are contiguous, as in
+ * GameTree; dataOffset locates a PLAYER node's first strategy block.
+ */
+struct SolutionNode {
+    uint8_t type;         // NodeType
+    uint8_t player;       // Position
+    uint8_t numActions;
+    uint8_t level;        // Board cards dealt below the root
+    int32_t parent;
+    int32_t firstChild;
+    uint8_t actionType;   // ActionType of the action leading here
+    uint8_t reserved[3];
+    double actionAmount;
+    double pot;
+    uint64_t dataOffset;
+};
+
+inline constexpr char SOLUTION_MAGIC[8] = {'T', 'F', 'S', 'O', 'L', 'N', '0', '1'};
+inline constexpr uint32_t SOLUTION_VERSION = 2;
+
+/**
+ * A finished solution, memory-mapped for random-access strategy queries.
+ */
+class SolutionFile {
+public:
+    ~SolutionFile();
+    SolutionFile(const SolutionFile&) = delete;
+    SolutionFile& operator=(const SolutionFile&) = delete;
+
+    // Write a solver's average strategy with 8- or 16-bit probabilities
+    static bool write(const MCCFRSolver& solver, const std::string& path, int bits = 8);
+
+    // Map a solution file; nullptr if it is missing or malformed
+    static std::unique_ptr<SolutionFile> open(const std::string& path);
+
+    const SolutionHeader& header() const { return *header_; }
+    int numNodes() const { return static_cast<int>(header_->numNodes); }
+    const SolutionNode& node(int index) const { return nodes_[index]; }
+
+    // Action leading into a node from its parent
+    Action actionTo(int index) const;
+
+    // Node reached by actions and dealt cards below the root, -1 if none.
+    // Sets the runout the dealt cards correspond to.
+    int findNode(const std::vector<Action>& actions,
+                 const std::vector<core::Card>& dealt, int& runout) const;
+
+    // Same, for a state that continues from the solved root
+    int findNode(const GameState& state, int& runout) const;
+
+    // Strategy of every combo at a PLAYER node: core::NUM_COMBOS rows of
+    // numActions probabilities, zero for combos outside the player's range.
+    // False if the node or runout was not stored.
+    bool strategy(int nodeIndex, int runout, float* out) const;
+
+private:
+    SolutionFile() = default;
+
+    void* mapped_ = nullptr;
+    size_t size_ = 0;
+    const char* data_ = nullptr;
+    const SolutionHeader* header_ = nullptr;
+    const int32_t* runoutIndex_ = nullptr;
+    const int16_t* slotMap_ = nullptr;
+    const SolutionNode* nodes_ = nullptr;
+};
+
+} // namespace solver
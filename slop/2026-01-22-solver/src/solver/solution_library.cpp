@@ -0,0 +1,354 @@
+#include "solution_library.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace solver {
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'T', 'F', 'L', 'I', 'B', '0', '0', '1'};
+
+// Largest index table a file may claim (96 MB), far above any real library
+constexpr uint64_t MAX_INDEX_CAPACITY = uint64_t{1} << 22;
+
+struct IndexHeader {
+    char magic[8];
+    uint64_t capacity;
+    uint64_t count;
+};
+
+// FNV-1a, fed field by field
+class Hasher {
+public:
+    void bytes(const void* data, size_t size) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash_ = (hash_ ^ p[i]) * 1099511628211ull;
+        }
+    }
+    void number(double value) { bytes(&value, sizeof(value)); }
+    void numbers(const std::vector<double>& values) {
+        uint64_t size = values.size();
+        bytes(&size, sizeof(size));
+        for (double value : values) number(value);
+    }
+    void string(const std::string& s) { bytes(s.data(), s.size() + 1); }
+
+    uint64_t value() const { return hash_; }
+
+private:
+    uint64_t hash_ = 14695981039346656037ull;
+};
+
+int flopKey(const std::array<core::Card, 3>& flop) {
+    return (flop[0].value() * core::NUM_CARDS + flop[1].value()) * core::NUM_CARDS + flop[2].value();
+}
+
+// Canonical flops in key order and the index of every canonical key
+struct FlopTables {
+    std::vector<std::array<core::Card, 3>> flops;
+    std::vector<int16_t> indexByKey;
+};
+
+const FlopTables& flopTables() {
+    static const FlopTables tables = [] {
+        FlopTables t;
+        t.indexByKey.assign(core::NUM_CARDS * core::NUM_CARDS * core::NUM_CARDS, -1);
+
+        std::vector<int> keys;
+        for (int a = 0; a < core::NUM_CARDS; ++a) {
+            for (int b = a + 1; b < core::NUM_CARDS; ++b) {
+                for (int c = b + 1; c < core::NUM_CARDS; ++c) {
+                    core::Card flop[3] = {core::Card(a), core::Card(b), core::Card(c)};
+                    SuitPermutation perm;
+                    keys.push_back(flopKey(CanonicalFlop::canonicalize(flop, perm)));
+                }
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        for (int key : keys) {
+            t.indexByKey[key] = static_cast<int16_t>(t.flops.size());
+            t.flops.push_back({core::Card(key / (core::NUM_CARDS * core::NUM_CARDS)),
+                               core::Card(key / core::NUM_CARDS % core::NUM_CARDS),
+                               core::Card(key % core::NUM_CARDS)});
+        }
+        return t;
+    }();
+    return tables;
+}
+
+} // namespace
+
+SuitPermutation SuitPermutation::inverse() const {
+    SuitPermutation out;
+    for (int s = 0; s < core::NUM_SUITS; ++s) {
+        out.suit[suit[s]] = static_cast<uint8_t>(s);
+    }
+    return out;
+}
+
+std::array<core::Card, 3> CanonicalFlop::canonicalize(const core::Card* flop, SuitPermutation& toCanonical) {
+    // The canonical form is the smallest sorted image over all 24 relabellings
+    std::array<core::Card, 3> best;
+    int bestKey = -1;
+    for (const SuitPermutation& perm : SUIT_PERMUTATIONS) {
+        std::array<core::Card, 3> mapped = {perm.apply(flop[0]), perm.apply(flop[1]), perm.apply(flop[2])};
+        std::sort(mapped.begin(), mapped.end());
+        int key = flopKey(mapped);
+        if (bestKey < 0 || key < bestKey) {
+            bestKey = key;
+            best = mapped;
+            toCanonical = perm;
+        }
+    }
+    return best;
+}
+
+int CanonicalFlop::index(const core::Card* flop) {
+    for (int i = 0; i < 3; ++i) {
+        if (!flop[i].isValid()) return -1;
+    }
+    if (flop[0] == flop[1] || flop[0] == flop[2] || flop[1] == flop[2]) return -1;
+
+    SuitPermutation perm;
+    return flopTables().indexByKey[flopKey(canonicalize(flop, perm))];
+}
+
+const std::array<core::Card, 3>& CanonicalFlop::flop(int index) {
+    return flopTables().flops[index];
+}
+
+uint64_t hashRanges(const core::Range& oopRange, const core::Range& ipRange) {
+    Hasher hasher;
+    for (const core::Range* range : {&oopRange, &ipRange}) {
+        for (const auto& [type, weight] : range->getHandTypes()) {
+            if (weight <= 0) continue;
+            hasher.string(type.toString());
+            hasher.number(weight);
+        }
+        hasher.string("|");
+    }
+    return hasher.value();
+}
+
+uint64_t hashBetTree(const BetSizingConfig& config) {
+    Hasher hasher;
+    hasher.numbers(config.oopFlopBets);
+    hasher.numbers(config.oopTurnBets);
+    hasher.numbers(config.oopRiverBets);
+    hasher.numbers(config.ipFlopBets);
+    hasher.numbers(config.ipTurnBets);
+    hasher.numbers(config.ipRiverBets);
+    hasher.number(config.raiseMultiplier);
+    hasher.number(config.allInThreshold);
+    hasher.number(config.stackSize);
+    hasher.number(config.initialPot);
+    return hasher.value();
+}
+
+int LibraryHit::findNode(const std::vector<Action>& actions,
+                         const std::vector<core::Card>& dealt, int& runout) const {
+    runout = 0;
+    if (!solution) return -1;
+
+    std::vector<core::Card> mapped;
+    for (const auto& card : dealt) {
+        mapped.push_back(toCanonical.apply(card));
+    }
+    return solution->findNode(actions, mapped, runout);
+}
+
+bool LibraryHit::strategy(int nodeIndex, int runout, float* out) const {
+    if (!solution || nodeIndex < 0 || nodeIndex >= solution->numNodes()) return false;
+
+    int numActions = solution->node(nodeIndex).numActions;
+    std::vector<float> canonical(static_cast<size_t>(core::NUM_COMBOS) * numActions);
+    if (!solution->strategy(nodeIndex, runout, canonical.data())) return false;
+
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        int source = toCanonical.apply(core::Hand::fromComboIndex(combo)).comboIndex();
+        std::copy_n(&canonical[static_cast<size_t>(source) * numActions], numActions,
+                    out + static_cast<size_t>(combo) * numActions);
+    }
+    return true;
+}
+
+SolutionLibrary::SolutionLibrary(const std::string& directory) : directory_(directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    loadIndex();
+}
+
+std::string SolutionLibrary::indexPath() const {
+    return (std::filesystem::path(directory_) / "index.bin").string();
+}
+
+std::string SolutionLibrary::solutionPath(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%04d_%016llx_%016llx.tfs", flopIndex,
+                  static_cast<unsigned long long>(rangeHash), static_cast<unsigned long long>(treeHash));
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+void SolutionLibrary::loadIndex() {
+    table_.assign(64, Entry{0, 0, EMPTY, 0});
+    count_ = 0;
+
+    // A damaged index is ignored and the library starts empty. The table
+    // must be at most half full, as insert() keeps it, so probes always end.
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(indexPath(), error);
+    std::ifstream in(indexPath(), std::ios::binary);
+    IndexHeader header{};
+    if (error || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.capacity == 0 || header.capacity > MAX_INDEX_CAPACITY ||
+        (header.capacity & (header.capacity - 1)) != 0 || header.count * 2 > header.capacity ||
+        fileSize != sizeof(header) + header.capacity * sizeof(Entry)) {
+        return;
+    }
+
+    std::vector<Entry> table(header.capacity);
+    if (!in.read(reinterpret_cast<char*>(table.data()), table.size() * sizeof(Entry))) return;
+    size_t used = 0;
+    for (const auto& entry : table) {
+        if (entry.flop == EMPTY) continue;
+        if (entry.flop >= static_cast<uint32_t>(CanonicalFlop::COUNT)) return;
+        ++used;
+    }
+    if (used != header.count) return;
+    table_ = std::move(table);
+    count_ = header.count;
+}
+
+bool SolutionLibrary::saveIndex() const {
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.capacity = table_.size();
+    header.count = count_;
+
+    // Written beside the index and renamed over it, so readers never see half a table
+    std::string tmpPath = indexPath() + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table_.data()), table_.size() * sizeof(Entry));
+        if (!out) return false;
+    }
+    return std::rename(tmpPath.c_str(), indexPath().c_str()) == 0;
+}
+
+size_t SolutionLibrary::probe(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const {
+    // Linear probing from a mix of the three key parts; stops at the key or an empty slot
+    uint64_t hash = (rangeHash ^ (treeHash * 0x9e3779b97f4a7c15ull)) + static_cast<uint64_t>(flopIndex);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+
+    size_t mask = table_.size() - 1;
+    size_t slot = hash & mask;
+    while (table_[slot].flop != EMPTY &&
+           !(table_[slot].flop == static_cast<uint32_t>(flopIndex) &&
+             table_[slot].rangeHash == rangeHash && table_[slot].treeHash == treeHash)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void SolutionLibrary::insert(const Entry& entry) {
+    // Keep the table at most half full
+    if ((count_ + 1) * 2 > table_.size()) {
+        std::vector<Entry> old = std::move(table_);
+        table_.assign(old.size() * 2, Entry{0, 0, EMPTY, 0});
+        for (const auto& e : old) {
+            if (e.flop != EMPTY) table_[probe(e.flop, e.rangeHash, e.treeHash)] = e;
+        }
+    }
+
+    size_t slot = probe(entry.flop, entry.rangeHash, entry.treeHash);
+    if (table_[slot].flop == EMPTY) ++count_;
+    table_[slot] = entry;
+}
+
+bool SolutionLibrary::contains(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table_[probe(flopIndex, rangeHash, treeHash)].flop != EMPTY;
+}
+
+LibraryHit SolutionLibrary::lookup(const std::vector<core::Card>& flop,
+                                   const core::Range& oopRange, const core::Range& ipRange,
+                                   const BetSizingConfig& config) const {
+    LibraryHit hit;
+    if (flop.size() < 3) return hit;
+
+    CanonicalFlop::canonicalize(flop.data(), hit.toCanonical);
+    int flopIndex = CanonicalFlop::index(flop.data());
+    uint64_t rangeHash = hashRanges(oopRange, ipRange);
+    uint64_t treeHash = hashBetTree(config);
+    if (flopIndex < 0 || !contains(flopIndex, rangeHash, treeHash)) return hit;
+
+    hit.solution = SolutionFile::open(solutionPath(flopIndex, rangeHash, treeHash));
+    return hit;
+}
+
+void SolutionLibrary::precompute(const std::vector<int>& flopIndices,
+                                 const core::Range& oopRange, const core::Range& ipRange,
+                                 const BetSizingConfig& betConfig, const MCCFRConfig& solverConfig,
+                                 int numThreads, SolvedCallback onSolved) {
+    uint64_t rangeHash = hashRanges(oopRange, ipRange);
+    uint64_t treeHash = hashBetTree(betConfig);
+
+    std::vector<int> pending;
+    for (int i = 0; i < CanonicalFlop::COUNT; ++i) {
+        bool chosen = flopIndices.empty() ||
+                      std::find(flopIndices.begin(), flopIndices.end(), i) != flopIndices.end();
+        if (chosen && !contains(i, rangeHash, treeHash)) pending.push_back(i);
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<int> done{0};
+    int total = static_cast<int>(pending.size());
+
+    // Each worker runs whole solves; flops are handed out one at a time
+    auto worker = [&]() {
+        for (size_t i = next++; i < pending.size(); i = next++) {
+            int flopIndex = pending[i];
+            const auto& flop = CanonicalFlop::flop(flopIndex);
+
+            GameState state(betConfig);
+            state.setBoard({flop.begin(), flop.end()});
+
+            MCCFRSolver solver(solverConfig);
+            solver.initialize(state, oopRange, ipRange);
+            solver.solve();
+
+            if (!SolutionFile::write(solver, solutionPath(flopIndex, rangeHash, treeHash))) continue;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                insert(Entry{rangeHash, treeHash, static_cast<uint32_t>(flopIndex), 0});
+                saveIndex();
+            }
+            int finished = ++done;
+            if (onSolved) onSolved(flopIndex, finished, total);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < std::max(1, numThreads); ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace solver
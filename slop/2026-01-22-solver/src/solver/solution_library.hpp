@@ -0,0 +1,141 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "mccfr.hpp"
+#include "solution_file.hpp"
+#include "core/card.hpp"
+#include "core/hand.hpp"
+#include "core/range.hpp"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace solver {
+
+/**
+ * A relabelling of the four suits. Hold'em is symmetric under suit
+ * permutations, so one solve covers every flop that maps to the same
+ * canonical flop.
+ */
+struct SuitPermutation {
+    std::array<uint8_t, core::NUM_SUITS> suit = {0, 1, 2, 3};  // Suit index -> suit index
+
+    core::Card apply(const core::Card& card) const {
+        return core::Card(suit[card.suitIndex()] * core::NUM_RANKS + card.rankIndex());
+    }
+    core::Hand apply(const core::Hand& hand) const { return {apply(hand.card1()), apply(hand.card2())}; }
+    SuitPermutation inverse() const;
+};
+
+// All 24 suit permutations in lexicographic order, the identity first
+inline constexpr std::array<SuitPermutation, 24> SUIT_PERMUTATIONS = {
+    SuitPermutation{{0, 1, 2, 3}}, SuitPermutation{{0, 1, 3, 2}}, SuitPermutation{{0, 2, 1, 3}},
+    SuitPermutation{{0, 2, 3, 1}}, SuitPermutation{{0, 3, 1, 2}}, SuitPermutation{{0, 3, 2, 1}},
+    SuitPermutation{{1, 0, 2, 3}}, SuitPermutation{{1, 0, 3, 2}}, SuitPermutation{{1, 2, 0, 3}},
+    SuitPermutation{{1, 2, 3, 0}}, SuitPermutation{{1, 3, 0, 2}}, SuitPermutation{{1, 3, 2, 0}},
+    SuitPermutation{{2, 0, 1, 3}}, SuitPermutation{{2, 0, 3, 1}}, SuitPermutation{{2, 1, 0, 3}},
+    SuitPermutation{{2, 1, 3, 0}}, SuitPermutation{{2, 3, 0, 1}}, SuitPermutation{{2, 3, 1, 0}},
+    SuitPermutation{{3, 0, 1, 2}}, SuitPermutation{{3, 0, 2, 1}}, SuitPermutation{{3, 1, 0, 2}},
+    SuitPermutation{{3, 1, 2, 0}}, SuitPermutation{{3, 2, 0, 1}}, SuitPermutation{{3, 2, 1, 0}},
+};
+
+/**
+ * Canonical flops under suit isomorphism.
+ */
+class CanonicalFlop {
+public:
+    static constexpr int COUNT = 1755;
+
+    // Canonical form of a flop (sorted by card value) and the permutation
+    // that maps the flop's suits onto it
+    static std::array<core::Card, 3> canonicalize(const core::Card* flop, SuitPermutation& toCanonical);
+
+    // Index in [0, COUNT) of any flop, -1 if the cards are not a valid flop
+    static int index(const core::Card* flop);
+
+    // Canonical flop with a given index
+    static const std::array<core::Card, 3>& flop(int index);
+};
+
+// Hashes that key the library, stable across runs and platforms
+uint64_t hashRanges(const core::Range& oopRange, const core::Range& ipRange);
+uint64_t hashBetTree(const BetSizingConfig& config);
+
+/**
+ * A library solution for a real flop: the canonical solve and the suit
+ * mapping between the two.
+ */
+struct LibraryHit {
+    std::unique_ptr<SolutionFile> solution;
+    SuitPermutation toCanonical;
+
+    // Node reached by actions and (real) cards dealt below the flop
+    int findNode(const std::vector<Action>& actions,
+                 const std::vector<core::Card>& dealt, int& runout) const;
+
+    // SolutionFile::strategy with rows in real-suit combo order
+    bool strategy(int nodeIndex, int runout, float* out) const;
+};
+
+/**
+ * Persistent store of flop solutions keyed by (canonical flop, range pair
+ * hash, bet tree hash).
+ *
+ * The directory holds one SolutionFile per key and "index.bin", an
+ * open-addressing hash table of keys read in one go and probed in O(1).
+ * precompute() solves a set of canonical flops on worker threads and
+ * records each solution as soon as it is written.
+ */
+class SolutionLibrary {
+public:
+    // Index file entry; an empty slot has flop == EMPTY
+    struct Entry {
+        uint64_t rangeHash;
+        uint64_t treeHash;
+        uint32_t flop;
+        uint32_t reserved;
+    };
+    static constexpr uint32_t EMPTY = 0xffffffff;
+
+    // Open (or start) the library in a directory
+    explicit SolutionLibrary(const std::string& directory);
+
+    // Solution for a flop, mapped through its suit permutation; the
+    // solution is nullptr when the spot is not in the library
+    LibraryHit lookup(const std::vector<core::Card>& flop,
+                      const core::Range& oopRange, const core::Range& ipRange,
+                      const BetSizingConfig& config) const;
+
+    bool contains(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const;
+    size_t size() const { return count_; }
+
+    // Solve canonical flops (all of them if flopIndices is empty) that are not
+    // in the library yet. Runs numThreads solves at once; onSolved reports
+    // each finished flop index, from the worker thread that solved it.
+    using SolvedCallback = std::function<void(int flopIndex, int done, int total)>;
+    void precompute(const std::vector<int>& flopIndices,
+                    const core::Range& oopRange, const core::Range& ipRange,
+                    const BetSizingConfig& betConfig, const MCCFRConfig& solverConfig,
+                    int numThreads, SolvedCallback onSolved = nullptr);
+
+    // File name of a key's solution within the library directory
+    std::string solutionPath(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const;
+
+private:
+    std::string directory_;
+    std::vector<Entry> table_;  // Power-of-two capacity
+    size_t count_ = 0;
+    mutable std::mutex mutex_;
+
+    std::string indexPath() const;
+    void loadIndex();
+    bool saveIndex() const;
+    void insert(const Entry& entry);
+    size_t probe(int flopIndex, uint64_t rangeHash, uint64_t treeHash) const;
+};
+
+} // namespace solver
@@ -0,0 +1,68 @@
+#include "solve_loop.hpp"
+#include <algorithm>
+
+namespace solver {
+
+SolveLoop::SolveLoop(MCCFRSolver& solver, Clock::duration minMeasurePeriod)
+    : solver_(solver),
+      minMeasurePeriod_(minMeasurePeriod),
+      start_(Clock::now()),
+      measuredEnd_(start_),
+      stepStart_(solver.currentIteration()) {}
+
+bool SolveLoop::step() {
+    // A resumed solve continues from its checkpointed iteration
+    const MCCFRConfig& config = solver_.config();
+    stepStart_ = solver_.currentIteration();
+    if (stepStart_ >= config.numIterations) return false;
+    if (solver_.isStopped()) {
+        reason_ = StopReason::STOPPED;
+        return false;
+    }
+    solver_.runIterations(std::min(solver_.stepSize(), config.numIterations - stepStart_));
+    if (solver_.currentIteration() == stepStart_) {
+        reason_ = StopReason::NO_DEAL;
+        return false;
+    }
+    return true;
+}
+
+bool SolveLoop::shouldStop() {
+    const MCCFRConfig& config = solver_.config();
+    int iteration = solver_.currentIteration();
+    if (iteration < config.minIterations) return false;
+
+    if (config.targetExploitability > 0) {
+        if (crossed(config.exploitabilityCheckInterval)) measure();
+        if (measuredAt_ == iteration && config.targetReached(exploitability_)) {
+            reason_ = StopReason::TARGET;
+            return true;
+        }
+    }
+    if (config.maxSeconds > 0 && seconds() >= config.maxSeconds) {
+        reason_ = StopReason::TIME_BUDGET;
+        return true;
+    }
+    return false;
+}
+
+const ExploitabilityReport& SolveLoop::measure() {
+    if (Clock::now() - measuredEnd_ < std::max(minMeasurePeriod_, 4 * measureCost_)) {
+        return exploitability_;
+    }
+    return measureNow();
+}
+
+const ExploitabilityReport& SolveLoop::measureNow() {
+    int iteration = solver_.currentIteration();
+    if (measuredAt_ != iteration) {
+        auto from = Clock::now();
+        exploitability_ = solver_.computeExploitability();
+        measuredAt_ = iteration;
+        measuredEnd_ = Clock::now();
+        measureCost_ = measuredEnd_ - from;
+    }
+    return exploitability_;
+}
+
+} // namespace solver
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mccfr.hpp"
+#include "best_response.hpp"
+#include <chrono>
+
+namespace solver {
+
+/**
+ * The stopping rules of a solver's MCCFRConfig, shared by
+ * MCCFRSolver::solve() and BackgroundSolver.
+ *
+ * step() runs the next stepSize() iterations until numIterations or
+ * stop(); shouldStop() then applies the time budget and the exploitability
+ * target, which is checked every exploitabilityCheckInterval iterations
+ * and against any other measurement taken at that iteration.
+ *
+ * Measurements are throttled: a best response costs far more than an
+ * iteration, so one is taken only once four times the last one's cost
+ * (and minMeasurePeriod, if longer) has passed. A measurement asked for
+ * sooner returns the last one, stamped with the iteration it was taken at.
+ */
+class SolveLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SolveLoop(MCCFRSolver& solver, Clock::duration minMeasurePeriod = Clock::duration::zero());
+
+    // Run the next step; false once numIterations is reached, the solver
+    // was stopped or no combos can be dealt (see reason())
+    bool step();
+
+    // The last step passed a multiple of `interval` (never if it is 0)
+    bool crossed(int interval) const {
+        return interval > 0 && solver_.currentIteration() / interval != stepStart_ / interval;
+    }
+
+    // Time budget or target reached; reason() says which
+    bool shouldStop();
+
+    // Latest exploitability, measured now unless throttled
+    const ExploitabilityReport& measure();
+
+    // Exploitability of the current strategy, measured now if it is not
+    const ExploitabilityReport& measureNow();
+
+    StopReason reason() const { return reason_; }
+    bool measured() const { return measuredAt_ >= 0; }
+    int measuredAt() const { return measuredAt_; }  // Iteration of the latest measurement, -1 if none
+    const ExploitabilityReport& exploitability() const { return exploitability_; }
+    double seconds() const { return std::chrono::duration<double>(Clock::now() - start_).count(); }
+
+private:
+    MCCFRSolver& solver_;
+    Clock::duration minMeasurePeriod_;
+    Clock::time_point start_;
+    Clock::time_point measuredEnd_;
+    Clock::duration measureCost_{0};
+    int measuredAt_ = -1;
+    int stepStart_ = 0;
+    StopReason reason_ = StopReason::ITERATIONS;
+    ExploitabilityReport exploitability_;
+};
+
+} // namespace solver
@@ -0,0 +1,234 @@
+#include "spot.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace solver {
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool parseNumber(const std::string& text, double& out) {
+    char* end = nullptr;
+    out = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size();
+}
+
+bool parseInt(const std::string& text, int& out) {
+    double value;
+    if (!parseNumber(text, value) || value != static_cast<int>(value)) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool parseBool(const std::string& text, bool& out) {
+    std::string value = lower(text);
+    if (value == "true" || value == "yes" || value == "on" || value == "1") {
+        out = true;
+    } else if (value == "false" || value == "no" || value == "off" || value == "0") {
+        out = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// "33,75,150" (an empty list means the player only checks or calls), at
+// most MAX_BET_SIZES of them
+bool parseSizes(const std::string& text, std::vector<double>& out) {
+    out.clear();
+    std::stringstream stream(text);
+    for (std::string item; std::getline(stream, item, ',');) {
+        item = trim(item);
+        double size;
+        if (item.empty()) continue;
+        if (!parseNumber(item, size) || size <= 0) return false;
+        out.push_back(size);
+    }
+    return out.size() <= static_cast<size_t>(MAX_BET_SIZES);
+}
+
+// "Ks7d2c", "Ks 7d 2c" or "Ks,7d,2c"
+bool parseBoard(const std::string& text, std::vector<core::Card>& out) {
+    std::string compact;
+    for (char c : text) {
+        if (c != ' ' && c != ',') compact += c;
+    }
+    out.clear();
+    if (compact.size() % 2 != 0) return false;
+    for (size_t i = 0; i < compact.size(); i += 2) {
+        auto card = core::Card::fromString(compact.substr(i, 2));
+        if (!card || std::find(out.begin(), out.end(), *card) != out.end()) return false;
+        out.push_back(*card);
+    }
+    return out.size() >= 3 && out.size() <= 5;
+}
+
+template <typename Enum, size_t N>
+bool parseName(const std::string& text, const std::pair<const char*, Enum> (&names)[N], Enum& out) {
+    std::string value = lower(text);
+    for (const auto& [name, e] : names) {
+        if (value == name) {
+            out = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::pair<const char*, SamplingScheme> SAMPLING_NAMES[] = {
+    {"external", SamplingScheme::EXTERNAL},
+    {"outcome", SamplingScheme::OUTCOME},
+    {"chance", SamplingScheme::CHANCE},
+    {"vanilla", SamplingScheme::VANILLA},
+};
+
+const std::pair<const char*, ChanceSampling> CHANCE_NAMES[] = {
+    {"full", ChanceSampling::FULL_ENUMERATION},
+    {"public", ChanceSampling::PUBLIC_SAMPLING},
+    {"sampled", ChanceSampling::SAMPLED_RUNOUTS},
+};
+
+const std::pair<const char*, Street> STREET_NAMES[] = {
+    {"flop", Street::FLOP},
+    {"turn", Street::TURN},
+    {"river", Street::RIVER},
+};
+
+const std::pair<const char*, ExploitabilityUnit> UNIT_NAMES[] = {
+    {"pot", ExploitabilityUnit::PERCENT_POT},
+    {"bb100", ExploitabilityUnit::BB_PER_100},
+};
+
+const std::pair<const char*, StorageMode> STORAGE_NAMES[] = {
+    {"double", StorageMode::DOUBLE},
+    {"compact", StorageMode::COMPACT},
+};
+
+// Apply one key; false if the key is unknown or its value does not parse
+bool apply(const std::string& key, const std::string& value, Spot& spot) {
+    BetSizingConfig& bets = spot.betConfig;
+    MCCFRConfig& solver = spot.solverConfig;
+
+    if (key == "board") return parseBoard(value, spot.board);
+    if (key == "oop_range") {
+        spot.oopRange = core::Range::fromString(value);
+        return spot.oopRange.totalCombos() > 0;
+    }
+    if (key == "ip_range") {
+        spot.ipRange = core::Range::fromString(value);
+        return spot.ipRange.totalCombos() > 0;
+    }
+    if (key == "pot") return parseNumber(value, bets.initialPot) && bets.initialPot > 0;
+    if (key == "stack") return parseNumber(value, bets.stackSize) && bets.stackSize > 0;
+    if (key == "oop_flop_bets") return parseSizes(value, bets.oopFlopBets);
+    if (key == "oop_turn_bets") return parseSizes(value, bets.oopTurnBets);
+    if (key == "oop_river_bets") return parseSizes(value, bets.oopRiverBets);
+    if (key == "ip_flop_bets") return parseSizes(value, bets.ipFlopBets);
+    if (key == "ip_turn_bets") return parseSizes(value, bets.ipTurnBets);
+    if (key == "ip_river_bets") return parseSizes(value, bets.ipRiverBets);
+    if (key == "raise_multiplier") return parseNumber(value, bets.raiseMultiplier) && bets.raiseMultiplier > 1;
+    if (key == "all_in_threshold") return parseNumber(value, bets.allInThreshold) && bets.allInThreshold >= 0;
+
+    if (key == "iterations") return parseInt(value, solver.numIterations) && solver.numIterations > 0;
+    if (key == "seconds") return parseNumber(value, solver.maxSeconds) && solver.maxSeconds >= 0;
+    if (key == "min_iterations") return parseInt(value, solver.minIterations) && solver.minIterations >= 0;
+    if (key == "target_exploitability") {
+        return parseNumber(value, solver.targetExploitability) && solver.targetExploitability >= 0;
+    }
+    if (key == "target_unit") return parseName(value, UNIT_NAMES, solver.targetUnit);
+    if (key == "check_interval") {
+        return parseInt(value, solver.exploitabilityCheckInterval) && solver.exploitabilityCheckInterval > 0;
+    }
+    if (key == "sampling") return parseName(value, SAMPLING_NAMES, solver.sampling);
+    if (key == "chance_sampling") return parseName(value, CHANCE_NAMES, solver.chanceSampling);
+    if (key == "threads") return parseInt(value, solver.numThreads) && solver.numThreads >= 0;
+    if (key == "sampled_runouts") return parseInt(value, solver.sampledRunouts) && solver.sampledRunouts > 0;
+    if (key == "last_street") return parseName(value, STREET_NAMES, solver.lastStreet);
+    if (key == "storage") return parseName(value, STORAGE_NAMES, solver.storageMode);
+    if (key == "discounting") return parseBool(value, solver.useDiscounting);
+    if (key == "pruning") return parseBool(value, solver.usePruning);
+
+    if (key == "output") {
+        spot.outputPath = value;
+        return !value.empty();
+    }
+    if (key == "bits") return parseInt(value, spot.bits) && (spot.bits == 8 || spot.bits == 16);
+    return false;
+}
+
+} // namespace
+
+GameState Spot::initialState() const {
+    GameState state(betConfig);
+    state.setBoard(board);
+    return state;
+}
+
+bool Spot::parse(const std::string& text, Spot& spot, std::string& error) {
+    spot = Spot();
+    std::stringstream stream(text);
+    int lineNumber = 0;
+    for (std::string line; std::getline(stream, line);) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = "line " + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+        std::string key = lower(trim(line.substr(0, equals)));
+        std::string value = trim(line.substr(equals + 1));
+        if (!apply(key, value, spot)) {
+            error = "line " + std::to_string(lineNumber) + ": bad " + key + " '" + value + "'";
+            return false;
+        }
+    }
+
+    if (spot.board.empty()) {
+        error = "no board";
+        return false;
+    }
+    if (spot.oopRange.totalCombos() == 0 || spot.ipRange.totalCombos() == 0) {
+        error = "both oop_range and ip_range are required";
+        return false;
+    }
+    if (spot.betConfig.stackSize <= spot.betConfig.initialPot / 2) {
+        error = "stack must be larger than half the pot";
+        return false;
+    }
+    return true;
+}
+
+bool Spot::load(const std::string& path, Spot& spot, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot read " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    if (!parse(text.str(), spot, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace solver
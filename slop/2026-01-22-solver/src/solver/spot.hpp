@@ -0,0 +1,51 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "mccfr.hpp"
+#include "core/card.hpp"
+#include "core/range.hpp"
+#include <string>
+#include <vector>
+
+namespace solver {
+
+/**
+ * A solve job without the GUI: the postflop spot, its bet tree, the solver
+ * configuration with its stopping rules, and where the solution goes.
+ *
+ * Spot files are "key = value" lines; '#' starts a comment and unknown
+ * keys are errors. Every key but board and the two ranges is optional
+ * (written one per line; listed several to a row here):
+ *
+ *   board = Ks7d2c
+ *   oop_range = 77+, ATs+, KQs, AJo+, KQo
+ *   ip_range = 66-TT, ATs-AQs, KQs, AQo
+ *   pot = 7                  stack = 100
+ *   oop_flop_bets = 33,75    ip_river_bets = 80,120   (and the other streets; up to MAX_BET_SIZES each)
+ *   raise_multiplier = 2.5   all_in_threshold = 125
+ *   iterations = 5000        seconds = 60             min_iterations = 1000
+ *   target_exploitability = 0.5                       target_unit = pot (or bb100)
+ *   check_interval = 500     sampling = external      chance_sampling = public
+ *   sampled_runouts = 4      last_street = river      storage = double
+ *   discounting = true       pruning = false          threads = 4 (0: all cores)
+ *   output = ks7d2c.tfs      bits = 8
+ */
+struct Spot {
+    std::vector<core::Card> board;
+    core::Range oopRange;
+    core::Range ipRange;
+    BetSizingConfig betConfig;
+    MCCFRConfig solverConfig;
+
+    std::string outputPath;  // SolutionFile; relative to the working directory
+    int bits = 8;
+
+    // Root of the solve: the board dealt, no actions taken
+    GameState initialState() const;
+
+    // Parse spot file text; false with a message naming the line otherwise
+    static bool parse(const std::string& text, Spot& spot, std::string& error);
+    static bool load(const std::string& path, Spot& spot, std::string& error);
+};
+
+} // namespace solver
@@ -0,0 +1,158 @@
+#include "strategy_matrix.hpp"
+#include "mccfr.hpp"
+#include <algorithm>
+
+namespace solver {
+
+namespace {
+
+// Runout id of the cards a runout had dealt by a shallower level
+int runoutAtLevel(int runout, int level) {
+    if (level >= GameTree::runoutLevel(runout)) return runout;
+    if (level == 0) return 0;
+    int first = (runout - 1 - core::NUM_CARDS) / core::NUM_CARDS;
+    return 1 + first;
+}
+
+} // namespace
+
+bool StrategyMatrix::bind(const MCCFRSolver& solver, Position player, const GameState& state) {
+    solver_ = nullptr;
+    const GameTree& tree = solver.gameTree();
+    if (tree.empty()) return false;
+
+    int runout = 0;
+    int nodeIndex = tree.findNode(state, runout);
+    if (nodeIndex < 0) return false;
+    const TreeNode& node = tree.node(nodeIndex);
+    if (node.type != NodeType::PLAYER || node.player != player) return false;
+
+    player_ = player;
+    node_ = nodeIndex;
+    runout_ = runout;
+    numActions_ = node.numActions;
+
+    // The player's own decisions from the root down to the node
+    path_.clear();
+    for (int child = nodeIndex, parent = node.parent; parent >= 0; child = parent, parent = tree.node(parent).parent) {
+        const TreeNode& above = tree.node(parent);
+        if (above.type == NodeType::PLAYER && above.player == player) {
+            path_.push_back({parent, above.level, runoutAtLevel(runout, above.level), child - above.firstChild});
+        }
+    }
+
+    uint64_t boardMask = 0;
+    for (const auto& card : state.board()) {
+        boardMask |= uint64_t{1} << card.value();
+    }
+    const auto& weights = solver.comboWeights(player);
+    live_.clear();
+    for (int c = 0; c < core::NUM_COMBOS; ++c) {
+        core::Hand hand = core::Hand::fromComboIndex(c);
+        uint64_t cards = uint64_t{1} << hand.card1().value() | uint64_t{1} << hand.card2().value();
+        if (weights[c] <= 0 || tree.slots(player, 0).comboToSlot[c] < 0 || (cards & boardMask)) continue;
+        auto [row, col] = core::HandType(hand.card1().rank(), hand.card2().rank(), hand.isSuited()).gridPosition();
+        Live live{static_cast<int16_t>(c), {}, static_cast<int16_t>(row * GRID_SIZE + col), static_cast<float>(weights[c])};
+        for (int level = 0; level < 3; ++level) {
+            live.slot[level] = static_cast<int16_t>(tree.slots(player, level).comboToSlot[c]);
+        }
+        live_.push_back(live);
+    }
+
+    int maxSlots = 0;
+    for (int level = 0; level < 3; ++level) {
+        maxSlots = std::max(maxSlots, tree.slots(player, level).size());
+    }
+    slotStrategy_.assign(static_cast<size_t>(tree.slots(player, node.level).size()) * numActions_, 0.0f);
+    pathStrategy_.assign(static_cast<size_t>(maxSlots) * MAX_ACTIONS, 0.0f);
+    liveReach_.assign(live_.size(), 1.0f);
+    combos_.assign(static_cast<size_t>(core::NUM_COMBOS) * numActions_, 0.0f);
+    comboWeights_.assign(core::NUM_COMBOS, 0.0f);
+    cells_.assign(static_cast<size_t>(NUM_CELLS) * numActions_, 0.0f);
+    cellWeights_.assign(NUM_CELLS, 0.0f);
+    aggregate_.assign(numActions_, 0.0);
+
+    solver_ = &solver;
+    update();
+    return true;
+}
+
+void StrategyMatrix::readNode(int nodeIndex, int runout, float* out) const {
+    const GameTree& tree = solver_->gameTree();
+    const TreeNode& node = tree.node(nodeIndex);
+    const int numActions = node.numActions;
+    const int numSlots = tree.slots(node.player, node.level).size();
+    const size_t size = static_cast<size_t>(numSlots) * numActions;
+    const RunoutStorage* storage = tree.runoutStorage(runout);
+
+    // One pass over the node's block: the info sets of its slots are consecutive
+    if (!storage) {
+        std::fill(out, out + size, 1.0f / numActions);
+        return;
+    }
+    if (tree.storageMode() == StorageMode::COMPACT) {
+        const uint16_t* sums = storage->compactStrategySum.data() + node.offset;
+        for (size_t i = 0; i < size; ++i) out[i] = sums[i];
+    } else {
+        const double* sums = storage->strategySum.data() + node.offset;
+        for (size_t i = 0; i < size; ++i) out[i] = static_cast<float>(sums[i]);
+    }
+
+    for (int slot = 0; slot < numSlots; ++slot) {
+        float* row = out + static_cast<size_t>(slot) * numActions;
+        float total = 0;
+        for (int a = 0; a < numActions; ++a) total += row[a];
+        float scale = total > 0 ? 1.0f / total : 0.0f;
+        for (int a = 0; a < numActions; ++a) {
+            row[a] = total > 0 ? row[a] * scale : 1.0f / numActions;
+        }
+    }
+}
+
+void StrategyMatrix::update() {
+    if (!solver_) return;
+    const int numActions = numActions_;
+
+    readNode(node_, runout_, slotStrategy_.data());
+    std::fill(liveReach_.begin(), liveReach_.end(), 1.0f);
+    for (const auto& step : path_) {
+        int stepActions = solver_->gameTree().node(step.node).numActions;
+        readNode(step.node, step.runout, pathStrategy_.data());
+        for (size_t i = 0; i < live_.size(); ++i) {
+            liveReach_[i] *= pathStrategy_[static_cast<size_t>(live_[i].slot[step.level]) * stepActions + step.action];
+        }
+    }
+    const int level = solver_->gameTree().node(node_).level;
+
+    std::fill(cells_.begin(), cells_.end(), 0.0f);
+    std::fill(cellWeights_.begin(), cellWeights_.end(), 0.0f);
+    std::fill(aggregate_.begin(), aggregate_.end(), 0.0);
+    double totalWeight = 0;
+    for (size_t i = 0; i < live_.size(); ++i) {
+        const Live& live = live_[i];
+        const float* row = &slotStrategy_[static_cast<size_t>(live.slot[level]) * numActions];
+        float weight = live.rangeWeight * liveReach_[i];
+        std::copy(row, row + numActions, &combos_[static_cast<size_t>(live.combo) * numActions]);
+        comboWeights_[live.combo] = weight;
+
+        float* cell = &cells_[static_cast<size_t>(live.cell) * numActions];
+        for (int a = 0; a < numActions; ++a) {
+            cell[a] += weight * row[a];
+            aggregate_[a] += weight * row[a];
+        }
+        cellWeights_[live.cell] += weight;
+        totalWeight += weight;
+    }
+
+    for (int c = 0; c < NUM_CELLS; ++c) {
+        if (cellWeights_[c] <= 0) continue;
+        float scale = 1.0f / cellWeights_[c];
+        float* cell = &cells_[static_cast<size_t>(c) * numActions];
+        for (int a = 0; a < numActions; ++a) cell[a] *= scale;
+    }
+    if (totalWeight > 0) {
+        for (auto& p : aggregate_) p /= totalWeight;
+    }
+}
+
+} // namespace solver
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "core/hand.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * Average strategy of every combo at one decision node of a solve, with
+ * range-weighted averages per 13x13 grid cell and over the whole range.
+ *
+ * bind() resolves what stays fixed while the solver trains: the node, the
+ * runout, each live combo's info set slot and grid cell, and the acting
+ * player's earlier decisions on the path. update() then re-reads only the
+ * strategy sums. A node's info sets are one contiguous block, so a refresh
+ * is a normalization pass over that block, one row copy per combo and a
+ * weighted sum per cell, with no lookups and no allocations: a few
+ * microseconds, cheap enough to run after every batch of iterations.
+ *
+ * Weights are the range weight times the player's own reach: the average
+ * probability of every action it took on the way from the solve's root.
+ */
+class StrategyMatrix {
+public:
+    static constexpr int GRID_SIZE = 13;
+    static constexpr int NUM_CELLS = GRID_SIZE * GRID_SIZE;
+
+    // Bind to the player's decision at a state at or below the solver's
+    // root and read it; false (and invalid) if the player does not act there
+    bool bind(const MCCFRSolver& solver, Position player, const GameState& state);
+
+    // Re-read the strategy sums of the bound node; the solver must not be
+    // iterating meanwhile
+    void update();
+
+    bool valid() const { return solver_ != nullptr; }
+    Position player() const { return player_; }
+    int numActions() const { return numActions_; }
+
+    // NUM_COMBOS x numActions by core::Hand::comboIndex(); zero rows for
+    // combos out of the range or blocked by the board
+    const std::vector<float>& combos() const { return combos_; }
+    const float* combo(int comboIndex) const { return &combos_[static_cast<size_t>(comboIndex) * numActions_]; }
+    float comboWeight(int comboIndex) const { return comboWeights_[comboIndex]; }
+
+    // NUM_CELLS x numActions by grid position (row * 13 + col, as
+    // core::HandType::gridPosition()); a cell's weight is its combos' total
+    const float* cell(int row, int col) const {
+        return &cells_[static_cast<size_t>(row * GRID_SIZE + col) * numActions_];
+    }
+    float cellWeight(int row, int col) const { return cellWeights_[row * GRID_SIZE + col]; }
+
+    // Whole range
+    const std::vector<double>& aggregate() const { return aggregate_; }
+
+private:
+    // A live combo: range weight > 0 and no card on the board
+    struct Live {
+        int16_t combo;
+        int16_t slot[3];  // Info set slot per tree level
+        int16_t cell;
+        float rangeWeight;
+    };
+
+    // One of the player's decisions above the node
+    struct PathStep {
+        int node;
+        int level;
+        int runout;
+        int action;
+    };
+
+    const MCCFRSolver* solver_ = nullptr;
+    Position player_ = Position::OOP;
+    int node_ = -1;
+    int runout_ = 0;
+    int numActions_ = 0;
+    std::vector<Live> live_;
+    std::vector<PathStep> path_;
+
+    std::vector<float> slotStrategy_;  // numSlots x numActions, normalized
+    std::vector<float> pathStrategy_;  // Scratch for the decisions on the path
+    std::vector<float> liveReach_;     // Own reach per live combo
+    std::vector<float> combos_;
+    std::vector<float> comboWeights_;
+    std::vector<float> cells_;
+    std::vector<float> cellWeights_;
+    std::vector<double> aggregate_;
+
+    // Normalized average strategy of every slot at a node into out (numSlots x numActions)
+    void readNode(int nodeIndex, int runout, float* out) const;
+};
+
+} // namespace solver
@@ -0,0 +1,60 @@
+#include "strength_cache.hpp"
+#include "ompeval/hand_evaluator.hpp"
+#include <mutex>
+
+namespace solver {
+
+const StrengthCache::Table& StrengthCache::get(const core::Card* board, int size) const {
+    uint64_t key = 0;
+    for (int i = 0; i < size; ++i) {
+        key |= uint64_t{1} << board[i].value();
+    }
+
+    {
+        std::shared_lock lock(mutex_);
+        auto it = tables_.find(key);
+        if (it != tables_.end()) return *it->second;
+    }
+
+    // Evaluate outside the lock; if another thread got there first, keep its table
+    auto table = compute(board, size);
+    std::unique_lock lock(mutex_);
+    auto [it, inserted] = tables_.emplace(key, std::move(table));
+    return *it->second;
+}
+
+std::unique_ptr<StrengthCache::Table> StrengthCache::compute(const core::Card* board, int size) {
+    const auto& evaluator = ompeval::HandEvaluator::instance();
+    auto table = std::make_unique<Table>();
+
+    uint64_t boardMask = 0;
+    int cards[7];
+    for (int i = 0; i < size; ++i) {
+        cards[i + 2] = board[i].value();
+        boardMask |= uint64_t{1} << board[i].value();
+    }
+
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        core::Hand hand = core::Hand::fromComboIndex(combo);
+        cards[0] = hand.card1().value();
+        cards[1] = hand.card2().value();
+        if ((boardMask >> cards[0] & 1) || (boardMask >> cards[1] & 1)) {
+            (*table)[combo] = 0;
+            continue;
+        }
+        (*table)[combo] = evaluator.evaluate(cards, size + 2).value;
+    }
+    return table;
+}
+
+size_t StrengthCache::size() const {
+    std::shared_lock lock(mutex_);
+    return tables_.size();
+}
+
+void StrengthCache::clear() {
+    std::unique_lock lock(mutex_);
+    tables_.clear();
+}
+
+} // namespace solver
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/card.hpp"
+#include "core/hand.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace solver {
+
+/**
+ * Showdown strength of every combo, computed once per board.
+ *
+ * Tables are keyed by the board's card mask and built on first use, so a
+ * solve only pays for the turn and river runouts it actually reaches. A
+ * showdown is then two loads from the table and a compare. Safe to share
+ * between threads.
+ */
+class StrengthCache {
+public:
+    // Strength per core::Hand::comboIndex(); higher is better.
+    // Combos that share a card with the board are 0.
+    using Table = std::array<int, core::NUM_COMBOS>;
+
+    // Table for a board, computing it on first use
+    const Table& get(const core::Card* board, int size) const;
+    const Table& get(const std::vector<core::Card>& board) const {
+        return get(board.data(), static_cast<int>(board.size()));
+    }
+
+    // Number of boards cached so far
+    size_t size() const;
+    void clear();
+
+private:
+    mutable std::shared_mutex mutex_;
+    mutable std::unordered_map<uint64_t, std::unique_ptr<Table>> tables_;
+
+    static std::unique_ptr<Table> compute(const core::Card* board, int size);
+};
+
+} // namespace solver
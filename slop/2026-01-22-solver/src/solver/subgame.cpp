@@ -0,0 +1,76 @@
+#include "subgame.hpp"
+#include "best_response.hpp"
+#include "mccfr.hpp"
+
+namespace solver {
+
+bool Subgame::extract(const MCCFRSolver& blueprint, const GameState& state, Subgame& out) {
+    const GameTree& tree = blueprint.gameTree();
+    int runout = 0;
+    int nodeIndex = tree.findNode(state, runout);
+    if (nodeIndex <= 0 || tree.node(nodeIndex).type != NodeType::PLAYER) return false;
+
+    // Runout of each tree level on the way down
+    const auto& board = state.board();
+    size_t rootBoardSize = blueprint.initialState().board().size();
+    int levelRunout[3] = {0, 0, 0};
+    for (size_t i = rootBoardSize; i < board.size() && i - rootBoardSize < 2; ++i) {
+        int level = static_cast<int>(i - rootBoardSize);
+        levelRunout[level + 1] = GameTree::nextRunout(levelRunout[level], board[i].value());
+    }
+
+    uint64_t boardMask = 0;
+    for (const auto& card : board) {
+        boardMask |= uint64_t{1} << card.value();
+    }
+
+    // Blueprint weights without the combos the new cards block
+    for (Position player : {Position::OOP, Position::IP}) {
+        auto& reach = out.reach[static_cast<int>(player)];
+        reach = blueprint.comboWeights(player);
+        for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+            core::Hand hand = core::Hand::fromComboIndex(combo);
+            if (boardMask >> hand.card1().value() & 1 || boardMask >> hand.card2().value() & 1) {
+                reach[combo] = 0;
+            }
+        }
+    }
+
+    // Times the average-strategy probability of each action on the path
+    double strategy[MAX_ACTIONS];
+    for (int child = nodeIndex; tree.node(child).parent >= 0; child = tree.node(child).parent) {
+        const TreeNode& parent = tree.node(tree.node(child).parent);
+        if (parent.type != NodeType::PLAYER) continue;
+
+        int action = child - parent.firstChild;
+        const HandSlots& slots = tree.slots(parent.player, parent.level);
+        auto& reach = out.reach[static_cast<int>(parent.player)];
+        for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+            if (reach[combo] <= 0) continue;
+            int slot = slots.comboToSlot[combo];
+            tree.averageStrategy(parent, levelRunout[parent.level], slot, strategy);
+            reach[combo] *= strategy[action];
+        }
+    }
+
+    bool reachable[2] = {false, false};
+    for (int player = 0; player < 2; ++player) {
+        for (double weight : out.reach[player]) {
+            reachable[player] |= weight > 0;
+        }
+    }
+    if (!reachable[0] || !reachable[1]) return false;
+
+    out.root = state;
+    out.oopRange = blueprint.oopRange();
+    out.ipRange = blueprint.ipRange();
+
+    Position acting = tree.node(nodeIndex).player;
+    out.constrained = (acting == Position::OOP) ? Position::IP : Position::OOP;
+    const auto& actingReach = out.reach[static_cast<int>(acting)];
+    out.values = BestResponse(blueprint).counterfactualValues(out.constrained, nodeIndex, runout,
+                                                              board, actingReach);
+    return true;
+}
+
+} // namespace solver
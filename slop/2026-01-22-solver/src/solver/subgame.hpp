@@ -0,0 +1,39 @@
+#pragma once
+
+#include "game_state.hpp"
+#include "core/range.hpp"
+#include <array>
+#include <vector>
+
+namespace solver {
+
+class MCCFRSolver;
+
+/**
+ * A subgame cut from a blueprint solve, to be re-solved on its own.
+ *
+ * The root is a decision point below the blueprint's root, typically the
+ * first decision of the next street. Both players enter with their
+ * blueprint reach: range weight times the probability of every action
+ * they took on the way. The player not acting at the root is constrained
+ * by a resolve gadget. Per combo it may terminate, taking its
+ * best-response value against the blueprint, or follow into the subgame.
+ * A re-solve can therefore never hand that player more than the blueprint
+ * conceded, which keeps it consistent with the earlier solution while
+ * only the (much smaller) remaining tree is solved.
+ */
+struct Subgame {
+    GameState root;
+    core::Range oopRange;  // Blueprint ranges, which lay out the info set slots
+    core::Range ipRange;
+    std::array<std::vector<double>, 2> reach;  // Per player and core::Hand::comboIndex()
+    Position constrained = Position::IP;
+    std::vector<double> values;  // Constrained player's terminate value per combo, bb per hand
+
+    // Cut the subgame at a state that continues the blueprint's root; false
+    // unless the state is a decision point strictly below the root that
+    // both players reach
+    static bool extract(const MCCFRSolver& blueprint, const GameState& state, Subgame& out);
+};
+
+} // namespace solver
@@ -0,0 +1,108 @@
+#include "task_pool.hpp"
+#include <algorithm>
+
+namespace solver {
+
+namespace {
+
+// The pool and queue of the calling thread when it is a worker
+thread_local TaskPool* currentPool = nullptr;
+thread_local int currentQueue = -1;
+
+} // namespace
+
+TaskPool::TaskPool(int numThreads) {
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int q = 0; q < numThreads; ++q) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (int t = 0; t + 1 < numThreads; ++t) {
+        workers_.emplace_back(&TaskPool::workerLoop, this, t);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+TaskPool& TaskPool::shared() {
+    static TaskPool pool;
+    return pool;
+}
+
+void TaskPool::push(Task task) {
+    int q = currentPool == this ? currentQueue : static_cast<int>(queues_.size()) - 1;
+    {
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        queues_[q]->tasks.push_back(std::move(task));
+    }
+    // Counted under the sleep mutex so a worker about to sleep sees it
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++queued_;
+    }
+    wake_.notify_one();
+}
+
+bool TaskPool::runOne() {
+    Task task;
+    int own = currentPool == this ? currentQueue : -1;
+    if (own >= 0) {
+        std::lock_guard<std::mutex> lock(queues_[own]->mutex);
+        if (!queues_[own]->tasks.empty()) {
+            task = std::move(queues_[own]->tasks.back());
+            queues_[own]->tasks.pop_back();
+        }
+    }
+
+    // Steal the oldest task, starting past our own queue so thieves spread out
+    int numQueues = static_cast<int>(queues_.size());
+    for (int k = 1; !task && k <= numQueues; ++k) {
+        int q = (std::max(own, 0) + k) % numQueues;
+        if (q == own) continue;
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        if (!queues_[q]->tasks.empty()) {
+            task = std::move(queues_[q]->tasks.front());
+            queues_[q]->tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    --queued_;
+    task();
+    return true;
+}
+
+void TaskPool::workerLoop(int index) {
+    currentPool = this;
+    currentQueue = index;
+    for (;;) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_) return;
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.push([this, task = std::move(task)]() {
+        task();
+        pending_.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending_.load(std::memory_order_acquire) > 0) {
+        if (!pool_.runOne()) std::this_thread::yield();
+    }
+}
+
+} // namespace solver
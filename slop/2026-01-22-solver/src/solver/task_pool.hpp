@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace solver {
+
+/**
+ * Work-stealing thread pool for fork-join parallelism inside a single
+ * traversal (see TaskGroup).
+ *
+ * Every worker owns a deque: the tasks it forks go on the back and it runs
+ * its own back first, depth first, while idle workers steal from the
+ * front, where the oldest and so largest subtrees wait. Threads outside
+ * the pool fork onto a shared queue. A thread waiting for a group runs
+ * queued tasks instead of blocking, so forks nest to any depth and every
+ * thread stays busy while there is work.
+ */
+class TaskPool {
+public:
+    // numThreads includes the thread that forks and waits; 0: all cores
+    explicit TaskPool(int numThreads = 0);
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    int numThreads() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // Process-wide pool over all cores
+    static TaskPool& shared();
+
+private:
+    friend class TaskGroup;
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;  // One per worker, then the shared queue
+    std::vector<std::thread> workers_;
+    std::atomic<int> queued_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+
+    void push(Task task);
+
+    // Run one queued task: the calling worker's newest, else the oldest
+    // of the shared queue or another worker's; false if there is none
+    bool runOne();
+
+    void workerLoop(int index);
+};
+
+/**
+ * Tasks forked together and waited for together. The tasks may fork
+ * groups of their own; wait() (and the destructor) returns once every task
+ * of this group has finished, running queued tasks meanwhile.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPool& pool) : pool_(pool) {}
+    ~TaskGroup() { wait(); }
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    TaskPool& pool_;
+    std::atomic<int> pending_{0};
+};
+
+} // namespace solver
@@ -0,0 +1,93 @@
+#include "toy_games.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace solver {
+
+LimitBetting::LimitBetting(std::vector<double> betSizes) : betSizes_(std::move(betSizes)) {
+    nodes_.reserve(64 * betSizes_.size());
+    build(0, 0, 0, false, false, 1.0, 1.0);
+}
+
+int LimitBetting::build(int round, int player, int raises, bool facing, bool checked, double c0, double c1) {
+    int index = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    nodes_[index].player = static_cast<int8_t>(player);
+    nodes_[index].decision = static_cast<int16_t>(decisions_++);
+    nodes_[index].committed[0] = c0;
+    nodes_[index].committed[1] = c1;
+
+    double betSize = betSizes_[round];
+    int other = 1 - player;
+    auto add = [&](int child) {
+        Node& node = nodes_[index];
+        node.children[node.numActions++] = static_cast<int16_t>(child);
+    };
+
+    // The round closes after a call, or after a check behind: the next
+    // round is dealt, or after the last round it is a showdown
+    auto close = [&](double n0, double n1) {
+        int child = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[child].committed[0] = n0;
+        nodes_[child].committed[1] = n1;
+        if (round + 1 < static_cast<int>(betSizes_.size())) {
+            nodes_[child].kind = DEAL;
+            int next = build(round + 1, 0, 0, false, false, n0, n1);
+            nodes_[child].children[0] = static_cast<int16_t>(next);
+        } else {
+            nodes_[child].kind = SHOWDOWN;
+        }
+        return child;
+    };
+
+    if (facing) {
+        int fold = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[fold].kind = FOLD;
+        nodes_[fold].player = static_cast<int8_t>(player);
+        nodes_[fold].committed[0] = c0;
+        nodes_[fold].committed[1] = c1;
+        add(fold);
+
+        double matched = std::max(c0, c1);
+        add(close(matched, matched));
+        if (raises < 2) {
+            double raised = matched + betSize;
+            add(build(round, other, raises + 1, true, false,
+                      player == 0 ? raised : c0, player == 1 ? raised : c1));
+        }
+        return index;
+    }
+
+    add(checked ? close(c0, c1) : build(round, other, raises, false, true, c0, c1));
+    add(build(round, other, raises + 1, true, false,
+              player == 0 ? c0 + betSize : c0, player == 1 ? c1 + betSize : c1));
+    return index;
+}
+
+LeducGame::State LeducGame::applyChance(const State& s, int outcome) const {
+    State out = s;
+    if (s.node < 0) {
+        // Ordered pair of distinct cards out of six
+        out.cards[0] = static_cast<int8_t>(outcome / 5);
+        int second = outcome % 5;
+        out.cards[1] = static_cast<int8_t>(second >= out.cards[0] ? second + 1 : second);
+        out.node = 0;
+        return out;
+    }
+
+    // The outcome-th card not held by either player
+    int seen = 0;
+    for (int card = 0; card < 6; ++card) {
+        if (card == s.cards[0] || card == s.cards[1]) continue;
+        if (seen++ == outcome) {
+            out.board = static_cast<int8_t>(card);
+            break;
+        }
+    }
+    out.node = betting_.node(s.node).children[0];
+    return out;
+}
+
+} // namespace solver
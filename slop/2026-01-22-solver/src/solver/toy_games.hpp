@@ -0,0 +1,305 @@
+#pragma once
+
+#include "cfr_engine.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace solver {
+
+/**
+ * Kuhn poker: a three-card deck (J, Q, K), one card each, an ante of 1 and
+ * a single bet of 1. Player 0's equilibrium value is -1/18.
+ *
+ * Info sets are numbered card * 4 + history as in mccfr/kuhn.c, with
+ * histories root, check, bet and check-bet; action 0 is check or fold and
+ * action 1 is bet or call.
+ */
+class KuhnGame {
+public:
+    static constexpr int MAX_ACTIONS = 2;
+    static constexpr double GAME_VALUE = -1.0 / 18.0;
+
+    struct State {
+        int8_t cards[2] = {-1, -1};
+        int8_t history = -1;  // -1 before the deal; terminals are 4 and up
+    };
+
+    size_t numInfoSets() const { return 12; }
+    State initial() const { return {}; }
+
+    bool isChance(const State& s) const { return s.history < 0; }
+    bool isTerminal(const State& s) const { return s.history >= CHECK_CHECK; }
+    int player(const State& s) const { return s.history == CHECK_BET ? 0 : s.history == ROOT ? 0 : 1; }
+    int numActions(const State&) const { return 2; }
+    size_t infoSet(const State& s) const { return s.cards[player(s)] * 4 + s.history; }
+
+    State apply(const State& s, int action) const {
+        static constexpr int8_t next[4][2] = {
+            {CHECK, BET},             // Root
+            {CHECK_CHECK, CHECK_BET}, // Check
+            {BET_FOLD, BET_CALL},     // Bet
+            {CHECK_BET_FOLD, CHECK_BET_CALL}  // Check-bet
+        };
+        State out = s;
+        out.history = next[s.history][action];
+        return out;
+    }
+
+    double utility(const State& s) const {
+        double showdown = s.cards[0] > s.cards[1] ? 1.0 : -1.0;
+        switch (s.history) {
+            case CHECK_CHECK: return showdown;
+            case BET_FOLD: return 1.0;
+            case BET_CALL: return 2.0 * showdown;
+            case CHECK_BET_FOLD: return -1.0;
+            default: return 2.0 * showdown;  // Check-bet-call
+        }
+    }
+
+    // The deal: six equally likely ordered pairs of distinct cards
+    int numChanceOutcomes(const State&) const { return 6; }
+    double chanceProbability(const State&, int) const { return 1.0 / 6.0; }
+    State applyChance(const State& s, int outcome) const {
+        State out = s;
+        out.cards[0] = static_cast<int8_t>(outcome / 2);
+        out.cards[1] = static_cast<int8_t>((out.cards[0] + 1 + outcome % 2) % 3);
+        out.history = ROOT;
+        return out;
+    }
+    State sampleChance(const State& s, std::mt19937& rng) const {
+        return applyChance(s, std::uniform_int_distribution<int>(0, 5)(rng));
+    }
+
+private:
+    enum : int8_t {
+        ROOT, CHECK, BET, CHECK_BET,
+        CHECK_CHECK, BET_FOLD, BET_CALL, CHECK_BET_FOLD, CHECK_BET_CALL
+    };
+};
+
+/**
+ * Rock-paper-scissors as a Game, as in mccfr/rps-ex.c: player 1 moves
+ * without seeing player 0's choice, so each player has one info set. The
+ * payoffs to player 0 default to +-1; the game's value is 0 for any
+ * antisymmetric matrix.
+ */
+class RpsGame {
+public:
+    static constexpr int MAX_ACTIONS = 3;  // Rock, paper, scissors
+
+    struct State {
+        int8_t moves[2] = {-1, -1};
+        bool dealt = false;
+    };
+
+    RpsGame() : RpsGame({{{0, -1, 1}, {1, 0, -1}, {-1, 1, 0}}}) {}
+    explicit RpsGame(const std::array<std::array<double, 3>, 3>& payoffs) : payoffs_(payoffs) {}
+
+    size_t numInfoSets() const { return 2; }
+    State initial() const { return {}; }
+
+    bool isChance(const State& s) const { return !s.dealt; }
+    bool isTerminal(const State& s) const { return s.moves[1] >= 0; }
+    int player(const State& s) const { return s.moves[0] < 0 ? 0 : 1; }
+    int numActions(const State&) const { return 3; }
+    size_t infoSet(const State& s) const { return player(s); }
+
+    State apply(const State& s, int action) const {
+        State out = s;
+        out.moves[player(s)] = static_cast<int8_t>(action);
+        return out;
+    }
+
+    double utility(const State& s) const { return payoffs_[s.moves[0]][s.moves[1]]; }
+
+    // Nothing is dealt: a single chance outcome starts the game
+    int numChanceOutcomes(const State&) const { return 1; }
+    double chanceProbability(const State&, int) const { return 1.0; }
+    State applyChance(const State& s, int) const {
+        State out = s;
+        out.dealt = true;
+        return out;
+    }
+    State sampleChance(const State& s, std::mt19937&) const { return applyChance(s, 0); }
+
+private:
+    std::array<std::array<double, 3>, 3> payoffs_;
+};
+
+/**
+ * The limit betting of the toy poker games: an ante of 1 each, then rounds
+ * of check, bet, fold, call and raise with a fixed bet size per round and
+ * at most a bet and a raise. It does not depend on the cards, so it is
+ * built once into a flat node array.
+ */
+class LimitBetting {
+public:
+    static constexpr int MAX_ACTIONS = 3;  // Fold, check/call, bet/raise (in that order when legal)
+
+    enum Kind : int8_t { DECISION, DEAL, FOLD, SHOWDOWN };
+
+    struct Node {
+        Kind kind = DECISION;
+        int8_t player = 0;       // To act; the folder at FOLD nodes
+        int8_t numActions = 0;
+        int16_t decision = -1;   // Index among decision nodes
+        int16_t children[MAX_ACTIONS] = {-1, -1, -1};  // DEAL: children[0] starts the next round
+        double committed[2] = {1, 1};
+    };
+
+    explicit LimitBetting(std::vector<double> betSizes);
+
+    const Node& node(int index) const { return nodes_[index]; }
+    int numDecisions() const { return decisions_; }
+
+    // Player 0's payoff at a terminal node; showdown is +1, 0 or -1 for a
+    // player 0 win, split or loss
+    double payoff(int index, int showdown) const {
+        const Node& node = nodes_[index];
+        if (node.kind == FOLD) {
+            // The folder loses what it put in
+            return node.player == 0 ? -node.committed[0] : node.committed[1];
+        }
+        return showdown > 0 ? node.committed[1] : showdown < 0 ? -node.committed[0] : 0.0;
+    }
+
+private:
+    std::vector<double> betSizes_;
+    std::vector<Node> nodes_;
+    int decisions_ = 0;
+
+    int build(int round, int player, int raises, bool facing, bool checked, double c0, double c1);
+};
+
+/**
+ * Leduc hold'em: a six-card deck (two each of J, Q, K), one private card
+ * each, an ante of 1, then two betting rounds around one public card. Bets
+ * are 2 in the first round and 4 in the second, with at most a bet and a
+ * raise per round. A private card that pairs the public card wins,
+ * otherwise the higher card; equal cards split. Player 0's equilibrium
+ * value is about -0.0856.
+ *
+ * An info set is (decision node, private rank, public rank).
+ */
+class LeducGame {
+public:
+    static constexpr int MAX_ACTIONS = LimitBetting::MAX_ACTIONS;
+    static constexpr double GAME_VALUE = -0.085606;
+
+    struct State {
+        int16_t node = -1;    // Betting node, -1 before the deal
+        int8_t cards[2] = {-1, -1};  // Private cards, 0..5 (rank = card / 2)
+        int8_t board = -1;    // Public card
+    };
+
+    LeducGame() : betting_({2.0, 4.0}) {}
+
+    size_t numInfoSets() const { return betting_.numDecisions() * 12; }
+    State initial() const { return {}; }
+
+    bool isChance(const State& s) const {
+        return s.node < 0 || betting_.node(s.node).kind == LimitBetting::DEAL;
+    }
+    bool isTerminal(const State& s) const {
+        return s.node >= 0 && (betting_.node(s.node).kind == LimitBetting::FOLD ||
+                               betting_.node(s.node).kind == LimitBetting::SHOWDOWN);
+    }
+    int player(const State& s) const { return betting_.node(s.node).player; }
+    int numActions(const State& s) const { return betting_.node(s.node).numActions; }
+    size_t infoSet(const State& s) const {
+        const LimitBetting::Node& node = betting_.node(s.node);
+        return static_cast<size_t>(node.decision) * 12 + (s.cards[node.player] / 2) * 4 +
+               (s.board < 0 ? 0 : s.board / 2 + 1);
+    }
+
+    State apply(const State& s, int action) const {
+        State out = s;
+        out.node = betting_.node(s.node).children[action];
+        return out;
+    }
+
+    double utility(const State& s) const {
+        int rank0 = s.cards[0] / 2, rank1 = s.cards[1] / 2, board = s.board / 2;
+        int strength0 = (rank0 == board) ? 10 + rank0 : rank0;
+        int strength1 = (rank1 == board) ? 10 + rank1 : rank1;
+        return betting_.payoff(s.node, (strength0 > strength1) - (strength0 < strength1));
+    }
+
+    // Before the deal: 30 ordered pairs of private cards; at the second
+    // round: the 4 cards left
+    int numChanceOutcomes(const State& s) const { return s.node < 0 ? 30 : 4; }
+    double chanceProbability(const State& s, int) const { return s.node < 0 ? 1.0 / 30 : 0.25; }
+    State applyChance(const State& s, int outcome) const;
+    State sampleChance(const State& s, std::mt19937& rng) const {
+        return applyChance(s, std::uniform_int_distribution<int>(0, numChanceOutcomes(s) - 1)(rng));
+    }
+
+private:
+    LimitBetting betting_;
+};
+
+/**
+ * A small river: each player holds one of NUM_CARDS cards of distinct
+ * strength, the board is out, and one limit betting round of 2 into a pot
+ * of 2 decides it. It has the shape of a hold'em river spot (polarized
+ * bets, bluff-catching calls, raises for value) at a size where exact
+ * exploitability is instant.
+ *
+ * An info set is (decision node, card).
+ */
+class ToyRiverGame {
+public:
+    static constexpr int MAX_ACTIONS = LimitBetting::MAX_ACTIONS;
+    static constexpr int NUM_CARDS = 10;
+
+    struct State {
+        int16_t node = -1;    // Betting node, -1 before the deal
+        int8_t cards[2] = {-1, -1};  // Strengths, 0..NUM_CARDS - 1
+    };
+
+    ToyRiverGame() : betting_({2.0}) {}
+
+    size_t numInfoSets() const { return betting_.numDecisions() * NUM_CARDS; }
+    State initial() const { return {}; }
+
+    bool isChance(const State& s) const { return s.node < 0; }
+    bool isTerminal(const State& s) const { return s.node >= 0 && betting_.node(s.node).kind != LimitBetting::DECISION; }
+    int player(const State& s) const { return betting_.node(s.node).player; }
+    int numActions(const State& s) const { return betting_.node(s.node).numActions; }
+    size_t infoSet(const State& s) const {
+        const LimitBetting::Node& node = betting_.node(s.node);
+        return static_cast<size_t>(node.decision) * NUM_CARDS + s.cards[node.player];
+    }
+
+    State apply(const State& s, int action) const {
+        State out = s;
+        out.node = betting_.node(s.node).children[action];
+        return out;
+    }
+
+    double utility(const State& s) const {
+        return betting_.payoff(s.node, s.cards[0] > s.cards[1] ? 1 : -1);
+    }
+
+    // The deal: ordered pairs of distinct cards
+    int numChanceOutcomes(const State&) const { return NUM_CARDS * (NUM_CARDS - 1); }
+    double chanceProbability(const State&, int) const { return 1.0 / (NUM_CARDS * (NUM_CARDS - 1)); }
+    State applyChance(const State& s, int outcome) const {
+        State out = s;
+        out.cards[0] = static_cast<int8_t>(outcome / (NUM_CARDS - 1));
+        int second = outcome % (NUM_CARDS - 1);
+        out.cards[1] = static_cast<int8_t>(second >= out.cards[0] ? second + 1 : second);
+        out.node = 0;
+        return out;
+    }
+    State sampleChance(const State& s, std::mt19937& rng) const {
+        return applyChance(s, std::uniform_int_distribution<int>(0, numChanceOutcomes(s) - 1)(rng));
+    }
+
+private:
+    LimitBetting betting_;
+};
+
+} // namespace solver
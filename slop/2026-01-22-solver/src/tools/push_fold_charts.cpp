@@ -0,0 +1,124 @@
+#include "solver/push_fold.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+
+/**
+ * Push/fold chart generator: solves every stack depth of a sweep and
+ * writes its push and call ranges.
+ *
+ * The preflop equity table is loaded from --equity, or computed exactly
+ * and saved there on the first run.
+ */
+
+using namespace solver;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: push_fold_charts --equity FILE [options]\n"
+                 "  --stacks 1-25        a range or a list of depths in bb (default 1-25)\n"
+                 "  --ante A             per player, in bb\n"
+                 "  --players N          table size; above 2 the others' antes are dead\n"
+                 "  --threads N          depths solved at once, and threads building the table (default: all cores)\n"
+                 "  --out DIR            where the range files go (default push_fold)\n");
+}
+
+// "1-25" or "5,7.5,10"
+std::vector<double> parseStacks(const std::string& text) {
+    std::vector<double> stacks;
+    size_t dash = text.find('-');
+    if (dash != std::string::npos && text.find(',') == std::string::npos) {
+        int low = std::atoi(text.substr(0, dash).c_str());
+        int high = std::atoi(text.substr(dash + 1).c_str());
+        for (int s = std::max(1, low); s <= high; ++s) stacks.push_back(s);
+        return stacks;
+    }
+    std::stringstream stream(text);
+    for (std::string item; std::getline(stream, item, ',');) {
+        double stack = std::atof(item.c_str());
+        if (stack > 0) stacks.push_back(stack);
+    }
+    return stacks;
+}
+
+double combosShare(const std::array<float, PreflopEquityTable::NUM_CLASSES>& frequencies) {
+    double combos = 0;
+    for (int c = 0; c < PreflopEquityTable::NUM_CLASSES; ++c) {
+        combos += frequencies[c] * PreflopEquityTable::typeOf(c).getHands().size();
+    }
+    return combos / core::NUM_COMBOS;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string equityPath;
+    std::string outDir = "push_fold";
+    PushFoldConfig config;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--equity") {
+            equityPath = value;
+        } else if (arg == "--stacks") {
+            config.stacks = parseStacks(value);
+        } else if (arg == "--ante") {
+            config.ante = std::atof(value.c_str());
+        } else if (arg == "--players") {
+            config.players = std::max(2, std::atoi(value.c_str()));
+        } else if (arg == "--threads") {
+            config.numThreads = std::atoi(value.c_str());
+        } else if (arg == "--out") {
+            outDir = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (equityPath.empty() || argc % 2 == 0) {
+        usage();
+        return 1;
+    }
+
+    auto start = Clock::now();
+    auto table = PreflopEquityTable::load(equityPath);
+    if (!table) {
+        std::printf("Building preflop equity table (exact, all boards)...\n");
+        table = std::make_unique<PreflopEquityTable>(PreflopEquityTable::build(config.numThreads));
+        if (!table->save(equityPath)) {
+            std::fprintf(stderr, "cannot write %s\n", equityPath.c_str());
+            return 1;
+        }
+        std::printf("Saved %s (%.1fs)\n", equityPath.c_str(),
+                    std::chrono::duration<double>(Clock::now() - start).count());
+        start = Clock::now();
+    }
+
+    PushFoldSolver solver(*table, config);
+    auto charts = solver.solve();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%8s %7s %7s %9s %10s %6s\n", "stack", "push", "call", "SB value", "exploit", "iters");
+    for (const auto& chart : charts) {
+        std::printf("%6gbb %6.1f%% %6.1f%% %9.4f %10.6f %6d\n", chart.stack, 100 * combosShare(chart.push),
+                    100 * combosShare(chart.call), chart.value, chart.exploitability, chart.iterations);
+    }
+    std::printf("Solved %zu depths in %.2fs\n", charts.size(), elapsed);
+
+    if (!PushFoldSolver::saveRanges(charts, outDir)) {
+        std::fprintf(stderr, "cannot write ranges to %s\n", outDir.c_str());
+        return 1;
+    }
+    std::printf("Ranges written to %s\n", outDir.c_str());
+    return 0;
+}
@@ -0,0 +1,344 @@
+#include "solver/spot.hpp"
+#include "solver/solution_file.hpp"
+#include "solver/solution_library.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Headless solver: solves spot files (see solver::Spot) at full speed and
+ * writes their SolutionFiles, with no display and no GUI event loop.
+ *
+ *   turbofire solve SPOT [--output FILE]
+ *   turbofire batch JOBS [--jobs N]
+ *   turbofire precompute SPOT --library DIR [--flops all|I,J,...] [--jobs N]
+ *   turbofire lookup SPOT --library DIR
+ *
+ * A job list has one spot file per line, optionally followed by the
+ * solution path; relative paths are taken from the list's directory.
+ * Batch mode runs up to --jobs solves at once (default: all cores), each
+ * on its own thread.
+ *
+ * precompute fills a SolutionLibrary with the spot's ranges, bet tree and
+ * solver settings on canonical flops: the spot's own flop class unless
+ * --flops lists indices or says all. lookup finds the spot's flop in a
+ * library and prints the range-weighted strategy at its first decision.
+ */
+
+using namespace solver;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: turbofire solve SPOT [--output FILE]\n"
+                 "       turbofire batch JOBS [--jobs N]\n"
+                 "       turbofire precompute SPOT --library DIR [--flops all|I,J,...] [--jobs N]\n"
+                 "       turbofire lookup SPOT --library DIR\n"
+                 "  SPOT       spot file: board, ranges, bet tree, stopping rules\n"
+                 "  JOBS       one spot file per line, optionally followed by its output path\n"
+                 "  --jobs     solves run at once (default: all cores)\n"
+                 "  --library  solution library directory\n"
+                 "  --flops    canonical flop indices to solve (default: the spot's flop)\n");
+}
+
+struct Job {
+    std::string spotPath;
+    std::string outputPath;  // Empty: the spot's output, else the spot path as .tfs
+};
+
+// Print lines whole when several solves report at once
+std::mutex printMutex;
+
+// Runs a spot until one of its stopping rules ends the solve and writes
+// the solution; false if it cannot be written. Progress is printed at each
+// exploitability check, prefixed with `name` when it is not empty; a check
+// the measurement throttle skipped shows the last measurement and its iteration.
+bool solveSpot(const Spot& spot, const std::string& outputPath, const std::string& name, SolveResult& result) {
+    MCCFRConfig config = spot.solverConfig;
+    config.progressCallbackFrequency = config.exploitabilityCheckInterval;
+    MCCFRSolver solver(config);
+    solver.initialize(spot.initialState(), spot.oopRange, spot.ipRange);
+
+    std::string prefix = name.empty() ? "" : name + ": ";
+    auto start = Clock::now();
+    solver.setProgressCallback([&](const SolveProgress& progress) {
+        if (progress.complete) return;
+        std::lock_guard<std::mutex> lock(printMutex);
+        std::printf("%s%8d iterations %8.1fs  exploitability %.4f bb (%.3f%% pot)", prefix.c_str(),
+                    progress.currentIteration, std::chrono::duration<double>(Clock::now() - start).count(),
+                    progress.exploitability, progress.exploitabilityPctPot);
+        if (progress.measuredIteration != progress.currentIteration) {
+            std::printf(" at %d", progress.measuredIteration);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    });
+
+    result = solver.solve();
+    if (result.reason == StopReason::NO_DEAL) return false;
+    return SolutionFile::write(solver, outputPath, spot.bits);
+}
+
+std::string defaultOutput(const std::string& spotPath) {
+    return fs::path(spotPath).replace_extension(".tfs").string();
+}
+
+// Loads and solves one job; false if the spot is invalid, has no valid deal
+// or the solution was not written
+bool runJob(const Job& job, const std::string& name) {
+    Spot spot;
+    std::string error;
+    if (!Spot::load(job.spotPath, spot, error)) {
+        std::lock_guard<std::mutex> lock(printMutex);
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    std::string output = !job.outputPath.empty() ? job.outputPath
+                         : !spot.outputPath.empty() ? spot.outputPath
+                                                    : defaultOutput(job.spotPath);
+
+    SolveResult result;
+    bool written = solveSpot(spot, output, name, result);
+    std::lock_guard<std::mutex> lock(printMutex);
+    if (result.reason == StopReason::NO_DEAL) {
+        std::fprintf(stderr, "%s: no valid deal: a range is empty or every combo is blocked by the board\n",
+                     job.spotPath.c_str());
+        return false;
+    }
+    if (!written) {
+        std::fprintf(stderr, "%s: cannot write %s\n", job.spotPath.c_str(), output.c_str());
+        return false;
+    }
+    std::printf("%s: %d iterations in %.1fs (%s), exploitability %.4f bb (%.3f%% pot) -> %s\n",
+                job.spotPath.c_str(), result.iterations, result.seconds, stopReasonToString(result.reason),
+                result.exploitability.bb, result.exploitability.percentPot, output.c_str());
+    return true;
+}
+
+bool readJobs(const std::string& path, std::vector<Job>& jobs) {
+    std::ifstream in(path);
+    if (!in) return false;
+    fs::path base = fs::path(path).parent_path();
+    auto resolve = [&base](const std::string& file) {
+        return fs::path(file).is_absolute() ? file : (base / file).string();
+    };
+    for (std::string line; std::getline(in, line);) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream fields(line);
+        Job job;
+        if (!(fields >> job.spotPath)) continue;
+        job.spotPath = resolve(job.spotPath);
+        if (fields >> job.outputPath) job.outputPath = resolve(job.outputPath);
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+int runBatch(const std::vector<Job>& jobs, int numThreads) {
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    numThreads = std::min<int>(numThreads, static_cast<int>(jobs.size()));
+
+    // Jobs are handed out one at a time; each worker runs whole solves
+    std::atomic<size_t> next{0};
+    std::atomic<int> failed{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            if (!runJob(jobs[i], fs::path(jobs[i].spotPath).filename().string())) ++failed;
+        }
+    };
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::printf("Solved %d of %zu spots in %.1fs\n", static_cast<int>(jobs.size()) - failed.load(), jobs.size(),
+                std::chrono::duration<double>(Clock::now() - start).count());
+    return failed > 0 ? 1 : 0;
+}
+
+// Canonical flop indices from "all" or a comma-separated list; empty means all
+bool parseFlops(const std::string& text, std::vector<int>& flops) {
+    flops.clear();
+    if (text == "all") return true;
+    std::stringstream fields(text);
+    for (std::string field; std::getline(fields, field, ',');) {
+        char* end = nullptr;
+        long index = std::strtol(field.c_str(), &end, 10);
+        if (field.empty() || *end != '\0' || index < 0 || index >= CanonicalFlop::COUNT) return false;
+        flops.push_back(static_cast<int>(index));
+    }
+    return !flops.empty();
+}
+
+std::string flopString(const std::array<core::Card, 3>& flop) {
+    return flop[0].toString() + flop[1].toString() + flop[2].toString();
+}
+
+int runPrecompute(const std::string& spotPath, const std::string& directory, const std::string& flopList,
+                  int numThreads) {
+    Spot spot;
+    std::string error;
+    if (!Spot::load(spotPath, spot, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::vector<int> flops;
+    if (flopList.empty()) {
+        int index = spot.board.size() >= 3 ? CanonicalFlop::index(spot.board.data()) : -1;
+        if (index < 0) {
+            std::fprintf(stderr, "%s: the board has no flop\n", spotPath.c_str());
+            return 1;
+        }
+        flops.push_back(index);
+    } else if (!parseFlops(flopList, flops)) {
+        std::fprintf(stderr, "bad --flops '%s'\n", flopList.c_str());
+        return 1;
+    }
+    if (numThreads <= 0) numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    auto start = Clock::now();
+    SolutionLibrary library(directory);
+    size_t before = library.size();
+    library.precompute(flops, spot.oopRange, spot.ipRange, spot.betConfig, spot.solverConfig, numThreads,
+                       [&](int flopIndex, int done, int total) {
+                           std::lock_guard<std::mutex> lock(printMutex);
+                           std::printf("%4d/%d  flop %4d %s  %.1fs\n", done, total, flopIndex,
+                                       flopString(CanonicalFlop::flop(flopIndex)).c_str(),
+                                       std::chrono::duration<double>(Clock::now() - start).count());
+                           std::fflush(stdout);
+                       });
+    std::printf("Library %s: %zu solutions (%zu new)\n", directory.c_str(), library.size(),
+                library.size() - before);
+    return 0;
+}
+
+int runLookup(const std::string& spotPath, const std::string& directory) {
+    Spot spot;
+    std::string error;
+    if (!Spot::load(spotPath, spot, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    SolutionLibrary library(directory);
+    LibraryHit hit = library.lookup(spot.board, spot.oopRange, spot.ipRange, spot.betConfig);
+    if (!hit.solution) {
+        std::fprintf(stderr, "%s: not in library %s\n", spotPath.c_str(), directory.c_str());
+        return 1;
+    }
+    int flopIndex = CanonicalFlop::index(spot.board.data());
+    std::printf("%s: canonical flop %d %s, %s\n", spotPath.c_str(), flopIndex,
+                flopString(CanonicalFlop::flop(flopIndex)).c_str(),
+                library.solutionPath(flopIndex, hashRanges(spot.oopRange, spot.ipRange),
+                                     hashBetTree(spot.betConfig)).c_str());
+
+    // Library solves start at the flop, so its first decision is shown
+    // (the spot's turn and river, if any, come after flop actions), with
+    // combos in the spot's real suits
+    int runout = 0;
+    int nodeIndex = hit.findNode({}, {}, runout);
+    const SolutionFile& solution = *hit.solution;
+    const SolutionNode& node = solution.node(nodeIndex);
+    std::vector<float> strategy(static_cast<size_t>(core::NUM_COMBOS) * node.numActions);
+    if (!hit.strategy(nodeIndex, runout, strategy.data())) {
+        std::fprintf(stderr, "%s: the solution has no flop decision\n", spotPath.c_str());
+        return 1;
+    }
+
+    auto player = static_cast<Position>(node.player);
+    const core::Range& range = (player == Position::OOP) ? spot.oopRange : spot.ipRange;
+    std::vector<core::Card> flop(spot.board.begin(), spot.board.begin() + 3);
+    std::vector<double> frequency(node.numActions, 0.0);
+    double total = 0;
+    for (const auto& [hand, weight] : range.getAvailableHands(flop)) {
+        const float* probs = strategy.data() + static_cast<size_t>(hand.comboIndex()) * node.numActions;
+        for (int a = 0; a < node.numActions; ++a) {
+            frequency[a] += weight * probs[a];
+        }
+        total += weight;
+    }
+    std::printf("%s to act:", positionToString(player));
+    for (int a = 0; a < node.numActions; ++a) {
+        std::printf("  %s %.1f%%", solution.actionTo(node.firstChild + a).toString().c_str(),
+                    total > 0 ? 100.0 * frequency[a] / total : 0.0);
+    }
+    std::printf("\n");
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc % 2 == 0) {
+        usage();
+        return 1;
+    }
+    std::string command = argv[1];
+    std::string input = argv[2];
+    std::string output;
+    std::string library;
+    std::string flops;
+    int numThreads = 0;
+    bool usesLibrary = command == "precompute" || command == "lookup";
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--output" && command == "solve") {
+            output = value;
+        } else if (arg == "--jobs" && (command == "batch" || command == "precompute")) {
+            numThreads = std::atoi(value.c_str());
+        } else if (arg == "--library" && usesLibrary) {
+            library = value;
+        } else if (arg == "--flops" && command == "precompute") {
+            flops = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (command == "solve") {
+        return runJob(Job{input, output}, "") ? 0 : 1;
+    }
+    if (command == "batch") {
+        std::vector<Job> jobs;
+        if (!readJobs(input, jobs)) {
+            std::fprintf(stderr, "cannot read %s\n", input.c_str());
+            return 1;
+        }
+        if (jobs.empty()) {
+            std::fprintf(stderr, "%s lists no spots\n", input.c_str());
+            return 1;
+        }
+        return runBatch(jobs, numThreads);
+    }
+    if (usesLibrary && library.empty()) {
+        usage();
+        return 1;
+    }
+    if (command == "precompute") {
+        return runPrecompute(input, library, flops, numThreads);
+    }
+    if (command == "lookup") {
+        return runLookup(input, library);
+    }
+    usage();
+    return 1;
+}
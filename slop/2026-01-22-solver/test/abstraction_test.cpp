@@ -0,0 +1,115 @@
+#include "abstraction.hpp"
+#include "mccfr.hpp"
+#include <cmath>
+#include <cstdio>
+
+using namespace solver;
+
+static int check(const char* name, bool passed) {
+    printf(passed ? "%s test succeeded!\n" : "[!] %s test failed!\n", name);
+    return passed ? 0 : 1;
+}
+
+static std::vector<core::Card> cards(std::initializer_list<const char*> texts) {
+    std::vector<core::Card> out;
+    for (const char* text : texts) {
+        out.push_back(*core::Card::fromString(text));
+    }
+    return out;
+}
+
+// EMD of 1-D histograms is the L1 distance between their cumulative sums
+static int earthMovers() {
+    const float a[4] = {0.5f, 0.5f, 0.0f, 0.0f};
+    const float b[4] = {0.0f, 0.5f, 0.5f, 0.0f};
+    const float c[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    double same = AbstractionBuilder::emd(a, a, 4);
+    double ab = AbstractionBuilder::emd(a, b, 4);
+    double ba = AbstractionBuilder::emd(b, a, 4);
+    double ac = AbstractionBuilder::emd(a, c, 4);
+    printf("EMD: a-a %.3f, a-b %.3f, b-a %.3f, a-c %.3f\n", same, ab, ba, ac);
+
+    int failures = check("EMD identical", same == 0);
+    failures += check("EMD shift", std::abs(ab - 1.0) < 1e-6 && ab == ba);
+    failures += check("EMD distance", std::abs(ac - 2.5) < 1e-6);
+    return failures;
+}
+
+// The same seed clusters the same boards into the same buckets, whatever
+// the number of threads the assignment step is split across
+static int stableBuckets() {
+    std::vector<std::vector<core::Card>> boards = {
+        cards({"Ks", "7d", "2c", "9h"}),
+        cards({"Ah", "Th", "5d", "5s"}),
+        cards({"8c", "7c", "6d", "Jh"}),
+    };
+    AbstractionConfig config;
+    config.numBuckets = 8;
+    config.histogramBins = 10;
+    config.iterations = 10;
+    config.seedSample = 2000;
+    config.seed = 7;
+
+    config.numThreads = 1;
+    BucketMap first = AbstractionBuilder(config).build(boards);
+    BucketMap again = AbstractionBuilder(config).build(boards);
+    config.numThreads = 4;
+    BucketMap threaded = AbstractionBuilder(config).build(boards);
+    printf("Fingerprints: %016llx %016llx %016llx\n", static_cast<unsigned long long>(first.fingerprint()),
+           static_cast<unsigned long long>(again.fingerprint()),
+           static_cast<unsigned long long>(threaded.fingerprint()));
+
+    int failures = check("Bucket map coverage", first.size() == boards.size() && first.contains(boards[1]));
+    failures += check("Fixed-seed buckets", first.fingerprint() == again.fingerprint());
+    failures += check("Threaded buckets", first.fingerprint() == threaded.fingerprint());
+    return failures;
+}
+
+// A bucket map keys the root street only: river info sets below a bucketed
+// turn root are keyed by canonical hand name, as without the map
+static int rootStreetBuckets() {
+    std::vector<core::Card> board = cards({"Ks", "7d", "2c", "9h"});
+    GameState root;
+    root.setBoard(board);
+    auto oop = core::Range::fromString("77+, ATs+, KQs, AJo+");
+    auto ip = core::Range::fromString("66-TT, ATs-AQs, KQs, AQo");
+
+    // Two buckets: any ace or king against the rest
+    std::vector<uint16_t> buckets(core::NUM_COMBOS);
+    for (int combo = 0; combo < core::NUM_COMBOS; ++combo) {
+        core::Hand hand = core::Hand::fromComboIndex(combo);
+        buckets[combo] = std::max(hand.card1().rank(), hand.card2().rank()) >= core::Rank::KING ? 0 : 1;
+    }
+    auto map = std::make_shared<BucketMap>(4, 2);
+    map->set(board, buckets);
+
+    GameTree plain, bucketed;
+    plain.build(root, oop, ip);
+    bucketed.build(root, oop, ip, StorageMode::DOUBLE, {}, map.get());
+    bool rootBucketed = true, riverByName = true;
+    for (Position player : {Position::OOP, Position::IP}) {
+        rootBucketed = rootBucketed && bucketed.slots(player, 0).size() == 2;
+        riverByName = riverByName &&
+                      bucketed.slots(player, 1).comboToSlot == plain.slots(player, 1).comboToSlot;
+    }
+    int failures = check("Root street buckets", rootBucketed);
+    failures += check("Later street names", riverByName);
+
+    // A bucketed solve trains and evaluates across both levels
+    MCCFRConfig config;
+    MCCFRSolver solver(config);
+    solver.setBucketMap(map);
+    solver.initialize(root, oop, ip);
+    solver.runIterations(2000);
+    double exploitability = solver.computeExploitability().bb;
+    printf("Bucketed exploitability: %.4f\n", exploitability);
+    failures += check("Bucketed solve", solver.currentIteration() == 2000 && std::isfinite(exploitability));
+    return failures;
+}
+
+int main() {
+    int failures = earthMovers();
+    failures += stableBuckets();
+    failures += rootStreetBuckets();
+    return failures ? 1 : 0;
+}
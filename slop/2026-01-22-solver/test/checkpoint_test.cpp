@@ -0,0 +1,80 @@
+#include "mccfr.hpp"
+#include <cstdio>
+#include <filesystem>
+
+using namespace solver;
+
+// Both trees hold the same runouts with identical regrets and strategy sums
+static bool sameStorage(const GameTree& a, const GameTree& b) {
+    if (a.numRunouts() != b.numRunouts()) return false;
+    for (int runout = 0; runout < GameTree::MAX_RUNOUTS; ++runout) {
+        const RunoutStorage* x = a.runoutStorage(runout);
+        const RunoutStorage* y = b.runoutStorage(runout);
+        if (!x || !y) {
+            if (x || y) return false;
+            continue;
+        }
+        if (x->regrets != y->regrets || x->strategySum != y->strategySum ||
+            x->compactRegrets != y->compactRegrets || x->compactStrategySum != y->compactStrategySum ||
+            x->compactRegretShift != y->compactRegretShift || x->compactSumShift != y->compactSumShift) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int check(const char* name, bool passed) {
+    printf(passed ? "%s test succeeded!\n" : "[!] %s test failed!\n", name);
+    return passed ? 0 : 1;
+}
+
+// Solve a turn spot, checkpoint it, resume a fresh solver from the file and
+// train both on: the resumed solve must match the uninterrupted one exactly
+static int roundTrip(StorageMode mode, const char* label, const std::string& path) {
+    GameState root;
+    std::vector<core::Card> board;
+    for (const char* card : {"Ks", "7d", "2c", "9h"}) {
+        board.push_back(*core::Card::fromString(card));
+    }
+    root.setBoard(board);
+    auto oop = core::Range::fromString("77+, ATs+, KQs, AJo+");
+    auto ip = core::Range::fromString("66-TT, ATs-AQs, KQs, AQo");
+
+    MCCFRConfig config;
+    config.storageMode = mode;
+    MCCFRSolver original(config);
+    original.initialize(root, oop, ip);
+    original.runIterations(3000);
+
+    int failures = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "%s save", label);
+    failures += check(name, original.saveCheckpoint(path));
+
+    MCCFRSolver resumed;
+    snprintf(name, sizeof(name), "%s load", label);
+    failures += check(name, resumed.loadCheckpoint(path) &&
+                                resumed.currentIteration() == original.currentIteration());
+    snprintf(name, sizeof(name), "%s loaded state", label);
+    failures += check(name, sameStorage(original.gameTree(), resumed.gameTree()));
+
+    original.runIterations(2000);
+    resumed.runIterations(2000);
+    snprintf(name, sizeof(name), "%s resumed state", label);
+    failures += check(name, sameStorage(original.gameTree(), resumed.gameTree()));
+    return failures;
+}
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "checkpoint_test.ckpt").string();
+    int failures = roundTrip(StorageMode::DOUBLE, "Double", path);
+    failures += roundTrip(StorageMode::COMPACT, "Compact", path);
+
+    // A truncated file is rejected and leaves the solver as it was
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    MCCFRSolver solver;
+    failures += check("Truncated file", !solver.loadCheckpoint(path) && solver.gameTree().empty());
+    std::filesystem::remove(path);
+
+    return failures ? 1 : 0;
+}
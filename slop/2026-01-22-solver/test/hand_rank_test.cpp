@@ -0,0 +1,86 @@
+#include "hand_evaluator.hpp"
+#include <cstdio>
+#include <set>
+
+using namespace ompeval;
+
+// Distinct 5-card hand values per category
+static const int CATEGORY_COUNTS[9] = {1277, 2860, 858, 858, 10, 1277, 156, 156, 10};
+#define DISTINCT_TOTAL_COUNT 7462
+
+// Card from text such as "As"
+static int card(const char* text) {
+    static const char ranks[] = "23456789TJQKA";
+    static const char suits[] = "cdhs";
+    int rank = 0, suit = 0;
+    while (ranks[rank] != text[0]) rank++;
+    while (suits[suit] != text[1]) suit++;
+    return makeCard(rank, suit);
+}
+
+static EvalResult hand(const char* a, const char* b, const char* c, const char* d, const char* e) {
+    return HandEvaluator::instance().evaluate5(card(a), card(b), card(c), card(d), card(e));
+}
+
+// One ordering check: the first hand must beat the second
+static int beats(const char* name, EvalResult stronger, EvalResult weaker) {
+    if (stronger > weaker) {
+        printf("%s test succeeded!\n", name);
+        return 0;
+    }
+    printf("[!] %s test failed! (%d vs %d)\n", name, stronger.value, weaker.value);
+    return 1;
+}
+
+int main() {
+    const HandEvaluator& evaluator = HandEvaluator::instance();
+    int failures = 0;
+
+    // Collision test: every 5-card hand, distinct values per category.
+    // Overlapping hash ranges merge values and shrink the counts.
+    std::set<uint16_t> values[9];
+    for (int a = 0; a < NUM_CARDS; a++)
+        for (int b = a + 1; b < NUM_CARDS; b++)
+            for (int c = b + 1; c < NUM_CARDS; c++)
+                for (int d = c + 1; d < NUM_CARDS; d++)
+                    for (int e = d + 1; e < NUM_CARDS; e++) {
+                        EvalResult result = evaluator.evaluate5(a, b, c, d, e);
+                        values[static_cast<int>(result.rank)].insert(result.value);
+                    }
+
+    int total = 0;
+    for (int category = 0; category < 9; category++) {
+        int count = static_cast<int>(values[category].size());
+        total += count;
+        if (count != CATEGORY_COUNTS[category]) {
+            printf("[!] %s count test failed!\n", HandEvaluator::rankToString(static_cast<HandRank>(category)));
+            failures++;
+        }
+        printf("%s count: %d, expected: %d\n", HandEvaluator::rankToString(static_cast<HandRank>(category)),
+               count, CATEGORY_COUNTS[category]);
+    }
+    if (total != DISTINCT_TOTAL_COUNT) {
+        printf("[!] Distinct value test failed!\n");
+        failures++;
+    } else {
+        printf("Distinct value test succeeded!\n");
+    }
+    printf("Distinct values: %d, expected: %d\n", total, DISTINCT_TOTAL_COUNT);
+
+    // Paired categories rank the higher pair, trips or quads first
+    failures += beats("Pair order", hand("As", "Ah", "7c", "5d", "2s"), hand("Ks", "Kh", "7c", "5d", "2s"));
+    failures += beats("Pair kicker", hand("As", "Ah", "Kc", "5d", "2s"), hand("Ad", "Ac", "Qc", "5d", "2s"));
+    failures += beats("Two pair order", hand("As", "Ah", "3c", "3d", "2s"), hand("Ks", "Kh", "Qc", "Qd", "As"));
+    failures += beats("Trips order", hand("As", "Ah", "Ac", "3d", "2s"), hand("Ks", "Kh", "Kc", "Ad", "Qs"));
+    failures += beats("Full house order", hand("As", "Ah", "Ac", "2d", "2s"), hand("Ks", "Kh", "Kc", "Ad", "As"));
+    failures += beats("Quads order", hand("As", "Ah", "Ac", "Ad", "2s"), hand("Ks", "Kh", "Kc", "Kd", "As"));
+    failures += beats("Two pair over pair", hand("3s", "3h", "2c", "2d", "4s"), hand("As", "Ah", "Kc", "Qd", "Js"));
+
+    // The wheel is the lowest straight and the lowest straight flush
+    failures += beats("Wheel", hand("6s", "5h", "4c", "3d", "2s"), hand("As", "5h", "4c", "3d", "2s"));
+    failures += beats("Wheel over trips", hand("As", "5h", "4c", "3d", "2s"), hand("As", "Ah", "Ac", "Kd", "Qs"));
+    failures += beats("Steel wheel", hand("6s", "5s", "4s", "3s", "2s"), hand("As", "5s", "4s", "3s", "2s"));
+    failures += beats("Broadway", hand("As", "Kh", "Qc", "Jd", "Ts"), hand("Ks", "Qh", "Jc", "Td", "9s"));
+
+    return failures == 0 ? 0 : 1;
+}
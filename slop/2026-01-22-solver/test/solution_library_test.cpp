@@ -0,0 +1,120 @@
+#include "solution_library.hpp"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+
+using namespace solver;
+
+static int check(const char* name, bool passed) {
+    printf(passed ? "%s test succeeded!\n" : "[!] %s test failed!\n", name);
+    return passed ? 0 : 1;
+}
+
+static std::vector<core::Card> cards(std::initializer_list<const char*> texts) {
+    std::vector<core::Card> out;
+    for (const char* text : texts) {
+        out.push_back(*core::Card::fromString(text));
+    }
+    return out;
+}
+
+// Every flop falls in one of the 1,755 suit-isomorphism classes, and each
+// class's canonical flop is indexed as that class
+static int canonicalFlops() {
+    std::set<int> classes;
+    bool inRange = true;
+    for (int a = 0; a < core::NUM_CARDS; ++a) {
+        for (int b = a + 1; b < core::NUM_CARDS; ++b) {
+            for (int c = b + 1; c < core::NUM_CARDS; ++c) {
+                core::Card flop[3] = {core::Card(a), core::Card(b), core::Card(c)};
+                int index = CanonicalFlop::index(flop);
+                inRange = inRange && index >= 0 && index < CanonicalFlop::COUNT;
+                classes.insert(index);
+            }
+        }
+    }
+    bool selfIndexed = true;
+    for (int i = 0; i < CanonicalFlop::COUNT; ++i) {
+        selfIndexed = selfIndexed && CanonicalFlop::index(CanonicalFlop::flop(i).data()) == i;
+    }
+    printf("Flop classes: %zu, expected: %d\n", classes.size(), CanonicalFlop::COUNT);
+
+    int failures = check("Flop class count", inRange && static_cast<int>(classes.size()) == CanonicalFlop::COUNT);
+    failures += check("Canonical flop index", selfIndexed);
+    return failures;
+}
+
+// A library lookup on a suit-permuted flop must give each real combo the
+// strategy a direct solve of that flop gives it. VANILLA iterations on a
+// flop-only tree are deterministic and cheap, so both solves agree up to
+// quantization.
+static int libraryMapping(const std::string& directory) {
+    core::Range oop = core::Range::fromString("AA, KK, AKs, AQs");
+    core::Range ip = core::Range::fromString("QQ, JJ, AKs, KQs");
+    BetSizingConfig bets;
+    bets.oopFlopBets = bets.ipFlopBets = {50};
+    bets.oopTurnBets = bets.ipTurnBets = {75};
+    bets.oopRiverBets = bets.ipRiverBets = {100};
+    bets.initialPot = 10;
+    bets.stackSize = 30;
+    MCCFRConfig config;
+    config.sampling = SamplingScheme::VANILLA;
+    config.lastStreet = Street::FLOP;
+    config.numIterations = 200;
+    config.useDiscounting = false;
+
+    std::vector<core::Card> flop = cards({"Kh", "7s", "2h"});
+    int flopIndex = CanonicalFlop::index(flop.data());
+    SolutionLibrary library(directory);
+    library.precompute({flopIndex}, oop, ip, bets, config, 1);
+    LibraryHit hit = library.lookup(flop, oop, ip, bets);
+    int failures = check("Library lookup", hit.solution != nullptr);
+    if (!hit.solution) return failures;
+
+    // The reopened index still holds the solve
+    failures += check("Library index", SolutionLibrary(directory).size() == 1);
+
+    GameState root(bets);
+    root.setBoard(flop);
+    MCCFRSolver direct(config);
+    direct.initialize(root, oop, ip);
+    direct.solve();
+    std::string directPath = (std::filesystem::path(directory) / "direct.tfs").string();
+    auto solution = SolutionFile::write(direct, directPath) ? SolutionFile::open(directPath) : nullptr;
+    if (check("Direct solve", solution != nullptr)) return failures + 1;
+
+    // OOP's first decision and IP's after a check
+    double maxError = 0;
+    bool found = true;
+    for (const auto& line : {std::vector<Action>{}, std::vector<Action>{Action::check()}}) {
+        int runout = 0, directRunout = 0;
+        int node = hit.findNode(line, {}, runout);
+        int directNode = solution->findNode(line, {}, directRunout);
+        if (node < 0 || node != directNode) {
+            found = false;
+            continue;
+        }
+        int numActions = solution->node(node).numActions;
+        std::vector<float> mapped(core::NUM_COMBOS * numActions), expected(core::NUM_COMBOS * numActions);
+        found = found && hit.strategy(node, runout, mapped.data()) &&
+                solution->strategy(directNode, directRunout, expected.data());
+        for (size_t i = 0; i < mapped.size(); ++i) {
+            maxError = std::max(maxError, static_cast<double>(std::abs(mapped[i] - expected[i])));
+        }
+    }
+    printf("Largest difference from the direct solve: %.4f\n", maxError);
+    failures += check("Library strategy mapping", found && maxError < 0.02);
+    return failures;
+}
+
+int main() {
+    std::string directory = (std::filesystem::temp_directory_path() / "solution_library_test").string();
+    std::filesystem::remove_all(directory);
+
+    int failures = canonicalFlops();
+    failures += libraryMapping(directory);
+
+    std::filesystem::remove_all(directory);
+    return failures ? 1 : 0;
+}